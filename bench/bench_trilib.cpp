@@ -0,0 +1,332 @@
+// Microbenchmarks for trilib.hpp, veclib.hpp and the batch kernels.
+//
+//   bench_trilib [--n N] [--min-ms MS] [--filter TEXT]
+//
+// Every function is run over N triangles of each input shape (well-shaped,
+// needle and degenerate) in float and double. A pass over all N triangles is
+// repeated until at least MS milliseconds have been spent, and the fastest
+// pass is reported as ns/triangle and million triangles per second (per ray
+// or point for the "packet" rows, which run N rays or query points against
+// one triangle, and per value for the statistics rows, which reduce N
+// values). Only rows whose "function type shape" line contains TEXT are run.
+
+#include "../trilib.hpp"
+#include "../trimetrics.hpp"
+#include "../tribatch.hpp"
+#include "../trisimd.hpp"
+#include "../triclassify.hpp"
+#include "../tribary.hpp"
+#include "../tripredicates.hpp"
+#include "../trisample.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace JMath;
+
+namespace
+{
+size_t      num_triangles = 1 << 16;
+double      min_seconds   = 0.05;
+std::string filter;
+
+// Results of every pass are added here so that nothing is optimized away
+volatile double sink;
+
+template<class T>
+struct Inputs
+{
+    std::vector<std::array<T,3>> pa, pb, pc;
+    TriangleBatch<T>             batch;
+};
+
+template<class T>
+std::array<T,3> random_point( double lo, double hi )
+{
+    return { random_value<T>(lo, hi), random_value<T>(lo, hi), random_value<T>(lo, hi) };
+}
+
+// shape 0: every angle at least 30 degrees
+// shape 1: needle, one edge about 1e-3 of the others
+// shape 2: degenerate, collinear or with a repeated vertex
+template<class T>
+Inputs<T> make_inputs( int shape, size_t n )
+{
+    JMath::seed_random(1234 + shape);
+    Inputs<T> in;
+    while( in.pa.size() < n ) {
+        auto a = random_point<T>(-100, 100);
+        auto b = random_point<T>(-100, 100);
+        auto c = random_point<T>(-100, 100);
+        if( shape == 0 ) {
+            if( minangle(a, b, c).first < 30.0 ) continue;
+        } else if( shape == 1 ) {
+            auto d = random_point<T>(-0.1, 0.1);
+            for( int j = 0; j < 3; j++) c[j] = b[j] + d[j];
+        } else if( in.pa.size() % 2 ) {
+            c = a;
+        } else {
+            T t = random_value<T>(0, 2);
+            for( int j = 0; j < 3; j++) c[j] = a[j] + t*(b[j] - a[j]);
+        }
+        in.pa.push_back(a);
+        in.pb.push_back(b);
+        in.pc.push_back(c);
+        in.batch.push_back(a, b, c);
+    }
+    return in;
+}
+
+// pass() processes all n triangles and returns a value to sink
+template<class Pass>
+void bench( const char *name, const char *type, const char *shape, size_t n, Pass pass )
+{
+    char label[128];
+    snprintf( label, sizeof(label), "%s %s %s", name, type, shape );
+    if( !filter.empty() && std::string(label).find(filter) == std::string::npos ) return;
+
+    typedef std::chrono::steady_clock clock;
+    sink = sink + pass();   // warm-up
+
+    double best = 1e30, total = 0;
+    int    reps = 0;
+    while( total < min_seconds || reps < 3 ) {
+        auto   t0 = clock::now();
+        double r  = pass();
+        double dt = std::chrono::duration<double>( clock::now() - t0 ).count();
+        sink  = sink + r;
+        best  = std::min( best, dt );
+        total += dt;
+        reps++;
+    }
+
+    double ns = 1e9*best/n;
+    printf( "%-26s %-7s %-11s %10.2f %12.2f\n", name, type, shape, ns, 1e3/ns );
+}
+
+// Wraps a per-triangle function f(i) into a pass over all n triangles
+template<class F>
+auto each( size_t n, F f )
+{
+    return [n, f]() {
+        double s = 0;
+        for( size_t i = 0; i < n; i++) s += f(i);
+        return s;
+    };
+}
+
+// Sums all three angles, so that none of them is optimized away
+template<class T>
+double sum3( const std::array<T,3> &a )
+{
+    return (double)a[0] + a[1] + a[2];
+}
+
+template<class T>
+void run_scalar( const Inputs<T> &in, const char *type, const char *shape )
+{
+    const size_t n = in.pa.size();
+    const auto &A = in.pa, &B = in.pb, &C = in.pc;
+
+    bench( "minlength",    type, shape, n, each(n, [&](size_t i) { return (double)minlength(A[i], B[i], C[i]); }));
+    bench( "maxlength",    type, shape, n, each(n, [&](size_t i) { return (double)maxlength(A[i], B[i], C[i]); }));
+    bench( "angles",       type, shape, n, each(n, [&](size_t i) { return sum3(angles(A[i], B[i], C[i])); }));
+    bench( "angleAt",      type, shape, n, each(n, [&](size_t i) { return (double)angleAt(A[i], B[i], C[i]); }));
+    bench( "maxangle",     type, shape, n, each(n, [&](size_t i) { return (double)maxangle(A[i], B[i], C[i]).first; }));
+    bench( "minangle",     type, shape, n, each(n, [&](size_t i) { return (double)minangle(A[i], B[i], C[i]).first; }));
+    bench( "angles native",   type, shape, n, each(n, [&](size_t i) { return sum3(angles(A[i], B[i], C[i], Degrees(), NativePrecision())); }));
+    bench( "angles mixed",    type, shape, n, each(n, [&](size_t i) { return sum3(angles(A[i], B[i], C[i], Degrees(), MixedPrecision())); }));
+    bench( "minangle native", type, shape, n, each(n, [&](size_t i) { return (double)minangle(A[i], B[i], C[i], Degrees(), NativePrecision()).first; }));
+    bench( "minangle mixed",  type, shape, n, each(n, [&](size_t i) { return (double)minangle(A[i], B[i], C[i], Degrees(), MixedPrecision()).first; }));
+    bench( "minangle cosine", type, shape, n, each(n, [&](size_t i) { return (double)minangle(A[i], B[i], C[i], Cosine()).first; }));
+    bench( "angles fine",     type, shape, n, each(n, [&](size_t i) { return sum3(angles(A[i], B[i], C[i], AngleDegrees<TrigFine>())); }));
+    bench( "angles coarse",   type, shape, n, each(n, [&](size_t i) { return sum3(angles(A[i], B[i], C[i], AngleDegrees<TrigCoarse>())); }));
+    bench( "isObtuse",     type, shape, n, each(n, [&](size_t i) { return (double)isObtuse(A[i], B[i], C[i]); }));
+    bench( "isAcute",      type, shape, n, each(n, [&](size_t i) { return (double)isAcute(A[i], B[i], C[i]); }));
+    bench( "isDegenerate", type, shape, n, each(n, [&](size_t i) { return (double)isDegenerate(A[i], B[i], C[i]); }));
+    bench( "isCollinear",  type, shape, n, each(n, [&](size_t i) { return (double)isCollinear(A[i], B[i], C[i]); }));
+    bench( "orient2d",     type, shape, n, each(n, [&](size_t i) { return orient2d(A[i], B[i], C[i]); }));
+    bench( "orient3d",     type, shape, n, each(n, [&](size_t i) { return orient3d(A[i], B[i], C[i], A[(i + 1) % n]); }));
+    bench( "incircle",     type, shape, n, each(n, [&](size_t i) { return incircle(A[i], B[i], C[i], A[(i + 1) % n]); }));
+    bench( "normal",       type, shape, n, each(n, [&](size_t i) { return (double)normal(A[i], B[i], C[i])[2]; }));
+    bench( "area",         type, shape, n, each(n, [&](size_t i) { return (double)area(A[i], B[i], C[i]); }));
+    bench( "centroid",     type, shape, n, each(n, [&](size_t i) { return (double)centroid(A[i], B[i], C[i])[0]; }));
+    bench( "circumcenter", type, shape, n, each(n, [&](size_t i) { return (double)circumcenter(A[i], B[i], C[i])[0]; }));
+    bench( "circumradius", type, shape, n, each(n, [&](size_t i) { return (double)circumradius(A[i], B[i], C[i]); }));
+    bench( "incenter",     type, shape, n, each(n, [&](size_t i) { return (double)incenter(A[i], B[i], C[i])[0]; }));
+    bench( "inradius",     type, shape, n, each(n, [&](size_t i) { return (double)inradius(A[i], B[i], C[i]); }));
+    bench( "barycoordinates", type, shape, n, each(n, [&](size_t i) {
+        return (double)barycoordinates(A[i], B[i], C[i], A[(i + 1) % n])[0];
+    }));
+    BaryFrameBatch<T> frames( in.batch );
+    bench( "BaryFrame query", type, shape, n, each(n, [&](size_t i) { return (double)frames(i, A[(i + 1) % n])[0]; }));
+    bench( "classify",     type, shape, n, each(n, [&](size_t i) { return (double)classify(A[i], B[i], C[i]); }));
+
+    TriangleMetrics<T> m;
+    bench( "TriangleMetrics(ALL)", type, shape, n, each(n, [&](size_t i) {
+        m.compute(A[i], B[i], C[i]);
+        return (double)m.inradius;
+    }));
+
+    // veclib, on the edge vectors of each triangle
+    bench( "length",        type, shape, n, each(n, [&](size_t i) { return (double)length(A[i], B[i]); }));
+    bench( "length2",       type, shape, n, each(n, [&](size_t i) { return (double)length2(A[i], B[i]); }));
+    bench( "length native", type, shape, n, each(n, [&](size_t i) { return (double)length(A[i], B[i], NativePrecision()); }));
+    bench( "length mixed",  type, shape, n, each(n, [&](size_t i) { return (double)length(A[i], B[i], MixedPrecision()); }));
+    bench( "magnitude",     type, shape, n, each(n, [&](size_t i) { return (double)magnitude(A[i]); }));
+    bench( "dot_product",   type, shape, n, each(n, [&](size_t i) { return (double)dot_product(A[i], B[i]); }));
+    bench( "cross_product", type, shape, n, each(n, [&](size_t i) { return (double)cross_product(A[i], B[i])[0]; }));
+    bench( "make_vector",   type, shape, n, each(n, [&](size_t i) { return (double)make_vector(A[i], B[i])[0]; }));
+    bench( "unit_vector",   type, shape, n, each(n, [&](size_t i) { return (double)unit_vector(A[i])[0]; }));
+    bench( "angle",         type, shape, n, each(n, [&](size_t i) { return (double)angle(A[i], B[i]); }));
+    bench( "min_value",     type, shape, n, each(n, [&](size_t i) { return (double)min_value(A[i][0], B[i][0], C[i][0]); }));
+    bench( "max_value",     type, shape, n, each(n, [&](size_t i) { return (double)max_value(A[i][0], B[i][0], C[i][0]); }));
+
+    // veclib statistics, over the x coordinates of the first corners
+    std::vector<T> xs(n);
+    for( size_t i = 0; i < n; i++) xs[i] = A[i][0];
+    bench( "mean_value",         type, shape, n, [&] { return (double)mean_value(xs); });
+    bench( "average_value",      type, shape, n, [&] { return (double)average_value(xs); });
+    bench( "standard_deviation", type, shape, n, [&] { return (double)standard_deviation(xs); });
+}
+
+template<class T>
+void run_batch( const Inputs<T> &in, const char *type, const char *shape )
+{
+    const auto  &batch = in.batch;
+    const size_t n     = batch.size();
+    std::vector<T> o0(n), o1(n), o2(n);
+    std::vector<uint8_t> mask(n);
+
+    bench( "batch area",         type, shape, n, [&] { area(batch, o0.data()); return (double)o0[0]; });
+    bench( "batch normal",       type, shape, n, [&] { normal(batch, o0.data(), o1.data(), o2.data()); return (double)o2[0]; });
+    bench( "batch centroid",     type, shape, n, [&] { centroid(batch, o0.data(), o1.data(), o2.data()); return (double)o0[0]; });
+    bench( "batch angles",       type, shape, n, [&] { angles(batch, o0.data(), o1.data(), o2.data()); return (double)o0[0]; });
+    bench( "batch angles fine",  type, shape, n, [&] { angles(batch, o0.data(), o1.data(), o2.data(), ANGLE_IN_DEGREES, TRIG_FINE); return (double)o0[0]; });
+    bench( "batch angles coarse", type, shape, n, [&] { angles(batch, o0.data(), o1.data(), o2.data(), ANGLE_IN_DEGREES, TRIG_COARSE); return (double)o0[0]; });
+    bench( "batch circumradius", type, shape, n, [&] { circumradius(batch, o0.data()); return (double)o0[0]; });
+    bench( "batch inradius",     type, shape, n, [&] { inradius(batch, o0.data()); return (double)o0[0]; });
+    bench( "batch classify",     type, shape, n, [&] { classify(batch, mask.data()); return (double)mask[0]; });
+
+    // Random generation: per triangle, nine uniforms or one point inside it
+    JMath::RandomStream rng( 1234 );
+    TriangleBatch<T> rand_batch;
+    bench( "random_value x9",     type, shape, n, each(n, [&](size_t) { return sum3(random_point<T>(-1, 1)) + sum3(random_point<T>(-1, 1)) + sum3(random_point<T>(-1, 1)); }));
+    bench( "random_triangles",    type, shape, n, [&] { random_triangles(rng, n, rand_batch, (T)-1, (T)1); return (double)rand_batch.x(0)[0]; });
+    bench( "sample_triangles",    type, shape, n, [&] { sample_triangles(rng, batch, o0.data(), o1.data(), o2.data()); return (double)o0[0]; });
+
+    // Surface sampling, n points over the whole batch: faces picked by binary
+    // search in the area CDF, then from the alias table (both built once)
+    std::vector<double> cdf(n);
+    std::vector<int>    faces(n);
+    std::vector<T>      l0(n), l1(n), l2(n);
+    double              total = 0;
+    for( size_t f = 0; f < n; f++) cdf[f] = total += area(batch.vertex(f, 0), batch.vertex(f, 1), batch.vertex(f, 2));
+    SurfaceSampler<T> surface;
+    bench( "surface alias build", type, shape, n, [&] { surface.build(batch); return surface.total_area(); });
+    bench( "surface cdf",         type, shape, n, [&] {
+        for( size_t i = 0; i < n; i++) {
+            size_t f = std::upper_bound(cdf.begin(), cdf.end(), rng.uniform()*total) - cdf.begin();
+            faces[i] = (int)std::min(f, n - 1);
+            l1[i] = rng.uniform<T>(0, 1);
+            l2[i] = rng.uniform<T>(0, 1);
+            fold_to_triangle( l1[i], l2[i] );
+        }
+        SurfaceSampler<T>::points(batch, n, faces.data(), l1.data(), l2.data(), o0.data(), o1.data(), o2.data());
+        return (double)o0[0];
+    });
+    bench( "surface alias",       type, shape, n, [&] {
+        surface.sample(rng, batch, n, o0.data(), o1.data(), o2.data(), faces.data(), l0.data(), l1.data(), l2.data());
+        return (double)o0[0];
+    });
+
+    bench( "simd area",   type, shape, n, [&] { TriSIMD::area(batch, o0.data()); return (double)o0[0]; });
+    bench( "simd normal", type, shape, n, [&] { TriSIMD::normal(batch, o0.data(), o1.data(), o2.data()); return (double)o2[0]; });
+    bench( "simd angles", type, shape, n, [&] { TriSIMD::angles(batch, o0.data(), o1.data(), o2.data()); return (double)o0[0]; });
+    bench( "simd angles fine",   type, shape, n, [&] { TriSIMD::angles(batch, o0.data(), o1.data(), o2.data(), ANGLE_IN_DEGREES, TRIG_FINE); return (double)o0[0]; });
+    bench( "simd angles coarse", type, shape, n, [&] { TriSIMD::angles(batch, o0.data(), o1.data(), o2.data(), ANGLE_IN_DEGREES, TRIG_COARSE); return (double)o0[0]; });
+
+    // Ray tests: one ray through the middle of the input cube against every
+    // triangle, then n rays (one per triangle, aimed at its first corner)
+    // against triangle 0
+    Ray<T> ray;
+    ray.origin = { -150, 3, -7 };
+    ray.dir    = { 1, 0.01, 0.02 };
+    RayBatch<T> rays;
+    for( size_t i = 0; i < n; i++) {
+        Ray<T> r;
+        r.origin = { 0, 0, -300 };
+        for( int j = 0; j < 3; j++) r.dir[j] = in.pa[i][j] - r.origin[j];
+        rays.push_back( r );
+    }
+    const auto &A = in.pa[0], &B = in.pb[0], &C = in.pc[0];
+
+    bench( "intersect", type, shape, n, each(n, [&](size_t i) {
+        T t, u, v;
+        return intersect(ray, in.pa[i], in.pb[i], in.pc[i], t, u, v) ? (double)t : 0.0;
+    }));
+    bench( "batch intersect",  type, shape, n, [&] { intersect(ray, batch, o0.data(), o1.data(), o2.data()); return (double)o1[0]; });
+    bench( "simd intersect",   type, shape, n, [&] { TriSIMD::intersect(ray, batch, o0.data(), o1.data(), o2.data()); return (double)o1[0]; });
+    bench( "batch ray packet", type, shape, n, [&] { intersect(rays, A, B, C, o0.data(), o1.data(), o2.data()); return (double)o1[0]; });
+    bench( "simd ray packet",  type, shape, n, [&] { TriSIMD::intersect(rays, A, B, C, o0.data(), o1.data(), o2.data()); return (double)o1[0]; });
+
+    // Closest points: the first corner of the next triangle as the query for
+    // each triangle, which spreads queries over all seven regions
+    std::vector<T> qx(n), qy(n), qz(n), d(n);
+    for( size_t i = 0; i < n; i++) {
+        qx[i] = in.pa[(i + 1) % n][0];
+        qy[i] = in.pa[(i + 1) % n][1];
+        qz[i] = in.pa[(i + 1) % n][2];
+    }
+    const T *q[3] = { qx.data(), qy.data(), qz.data() };
+
+    bench( "closest_point", type, shape, n, each(n, [&](size_t i) {
+        return (double)closest_point(in.pa[i], in.pb[i], in.pc[i], in.pa[(i + 1) % n]).dist2;
+    }));
+    bench( "batch closest_point",  type, shape, n, [&] { closest_point(batch, q[0], q[1], q[2], d.data(), o0.data(), o1.data(), o2.data(), mask.data()); return (double)d[0]; });
+    bench( "simd closest_point",   type, shape, n, [&] { TriSIMD::closest_point(batch, q[0], q[1], q[2], d.data(), o0.data(), o1.data(), o2.data(), mask.data()); return (double)d[0]; });
+    bench( "batch closest packet", type, shape, n, [&] { closest_point(A, B, C, n, q[0], q[1], q[2], d.data(), o0.data(), o1.data(), o2.data(), mask.data()); return (double)d[0]; });
+    bench( "simd closest packet",  type, shape, n, [&] { TriSIMD::closest_point(A, B, C, n, q[0], q[1], q[2], d.data(), o0.data(), o1.data(), o2.data(), mask.data()); return (double)d[0]; });
+}
+
+template<class T>
+void run_all( const char *type )
+{
+    const char *shapes[3] = { "well-shaped", "needle", "degenerate" };
+    for( int s = 0; s < 3; s++) {
+        Inputs<T> in = make_inputs<T>( s, num_triangles );
+        run_scalar( in, type, shapes[s] );
+        run_batch( in, type, shapes[s] );
+    }
+}
+}
+
+int main( int argc, char **argv )
+{
+    for( int i = 1; i < argc; i++) {
+        if( !strcmp(argv[i], "--n") && i + 1 < argc )
+            num_triangles = std::max( 1L, atol(argv[++i]) );
+        else if( !strcmp(argv[i], "--min-ms") && i + 1 < argc )
+            min_seconds = atof(argv[++i])*1e-3;
+        else if( !strcmp(argv[i], "--filter") && i + 1 < argc )
+            filter = argv[++i];
+        else {
+            fprintf( stderr, "usage: %s [--n N] [--min-ms MS] [--filter TEXT]\n", argv[0] );
+            return 1;
+        }
+    }
+
+#ifndef __OPTIMIZE__
+    fprintf( stderr, "warning: built without optimization, configure with -DCMAKE_BUILD_TYPE=Release\n" );
+#endif
+    printf( "%zu triangles per pass, SIMD path %s\n\n", num_triangles,
+            TriSIMD::isa_name( TriSIMD::active_isa() ));
+    printf( "%-26s %-7s %-11s %10s %12s\n", "function", "type", "shape", "ns/tri", "Mtri/s" );
+
+    run_all<float>( "float" );
+    run_all<double>( "double" );
+    return 0;
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <math.h>
+#include <algorithm>
+#include <cmath>
+
+///////////////////////////////////////////////////////////////////////////////
+// acos and atan2 in three accuracy tiers.
+//
+// TrigExact calls the C library. TrigFine and TrigCoarse evaluate
+// polynomials fitted for least maximum absolute error on [0, 1] (Lawson's
+// iteration), after a reduction by symmetry that needs only comparisons and
+// selects. They are branch-free, so loops over them can vectorize (the sqrt
+// needs -fno-math-errno for that) and the SIMD kernels evaluate them lane by
+// lane with the same operations:
+//
+//   acos(x)     = sqrt(1 - |x|) P(|x|), or pi minus that for x < 0
+//   atan2(y, x) = z Q(z^2) with z = min(|x|,|y|)/max(|x|,|y|), reflected
+//                 about pi/4, pi/2 and 0 by the signs and sizes of x and y
+//
+// Largest absolute error in radians over the whole domain, evaluated in
+// double (the test suite checks these bounds):
+//
+//                acos      atan2
+//   TrigFine     1.3e-8    5.8e-9     (the "1e-7" tier)
+//   TrigCoarse   3.8e-5    1.2e-5     (the "1e-4" tier)
+//
+// Evaluated in float, rounding adds a few ulps of the result (up to 4e-7
+// near pi); acosf and atan2f themselves are off by up to 2.5e-7.
+//
+// acos expects |x| <= 1 (callers clamp their cosines). atan2 expects finite
+// arguments and returns 0 for (0, 0); otherwise, signed zeros aside, it
+// follows the quadrant rules of std::atan2.
+///////////////////////////////////////////////////////////////////////////////
+
+namespace JMath
+{
+enum TrigAccuracy { TRIG_EXACT = 0, TRIG_FINE = 1, TRIG_COARSE = 2 };
+
+template<class T, int N>
+inline T horner( const double (&c)[N], T x )
+{
+    T p = (T)c[N-1];
+    for( int k = N-2; k >= 0; k--) p = p*x + (T)c[k];
+    return p;
+}
+
+template<class T, int N>
+inline T poly_acos( const double (&c)[N], T x )
+{
+    const T ax = std::fabs(x);
+    const T r  = std::sqrt(1 - ax)*horner( c, ax );
+    return x < 0 ? (T)M_PI - r : r;
+}
+
+template<class T, int N>
+inline T poly_atan2( const double (&c)[N], T y, T x )
+{
+    const T ax = std::fabs(x), ay = std::fabs(y);
+    const T mx = std::max(ax, ay), mn = std::min(ax, ay);
+    const T z  = mn/(mx > 0 ? mx : 1);
+
+    T r = z*horner( c, z*z );
+    r = ay > ax ? (T)(M_PI/2) - r : r;
+    r = x < 0   ? (T)M_PI - r     : r;
+    return y < 0 ? -r : r;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+struct TrigExact
+{
+    static constexpr TrigAccuracy accuracy = TRIG_EXACT;
+
+    template<class T> static T acos( T x )       { return std::acos(x); }
+    template<class T> static T atan2( T y, T x ) { return std::atan2(y, x); }
+};
+
+struct TrigFine
+{
+    static constexpr TrigAccuracy accuracy = TRIG_FINE;
+
+    static constexpr double ACOS[8] = {  1.5707963143187689, -0.21459989244076344,
+                                         0.088999264884807751, -0.050312784706422436,
+                                         0.031335471343101118, -0.017808986029544305,
+                                         0.0072454495735663383, -0.0014414803734284352 };
+    static constexpr double ATAN[9] = {  0.99999988638587186, -0.33332597041767707,
+                                         0.19985906955822367, -0.14161230377753807,
+                                         0.10498950000568805, -0.0723486474703133,
+                                         0.039781302647436293, -0.014401402906140526,
+                                         0.0024567351282766809 };
+
+    template<class T> static T acos( T x )       { return poly_acos( ACOS, x ); }
+    template<class T> static T atan2( T y, T x ) { return poly_atan2( ATAN, y, x ); }
+};
+
+struct TrigCoarse
+{
+    static constexpr TrigAccuracy accuracy = TRIG_COARSE;
+
+    static constexpr double ACOS[4] = {  1.5707583404302385, -0.21287518279862397,
+                                         0.076897382640810179, -0.020892033238803634 };
+    static constexpr double ATAN[5] = {  0.99986632952221868, -0.33030478576856549,
+                                         0.18015929473665723, -0.08515635028409427,
+                                         0.020845113726157029 };
+
+    template<class T> static T acos( T x )       { return poly_acos( ACOS, x ); }
+    template<class T> static T atan2( T y, T x ) { return poly_atan2( ATAN, y, x ); }
+};
+
+// Calls f(Trig()) with the tier type named by a runtime accuracy, so that
+// the choice is made once outside a loop rather than per element
+template<class F>
+inline auto with_trig( TrigAccuracy accuracy, F f )
+{
+    switch( accuracy ) {
+    case TRIG_FINE:   return f( TrigFine() );
+    case TRIG_COARSE: return f( TrigCoarse() );
+    default:          return f( TrigExact() );
+    }
+}
+}
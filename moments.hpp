@@ -0,0 +1,217 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include "threadpool.hpp"
+
+namespace JMath
+{
+///////////////////////////////////////////////////////////////////////////////
+// Count, mean, variance, min and max of a sequence in one pass.
+//
+// The input is cut into blocks of MOMENT_BLOCK values. Each block is summed
+// in eight independent lanes (so the loop vectorizes), and its squared
+// deviations are taken from its own mean while it is still in cache; block
+// results are then combined with Chan et al.'s pairwise update. This is as
+// stable as Welford's method without its division per element, and unlike
+// a naive sum of squares it does not cancel when the mean is large.
+//
+// Blocks are grouped into chunks of MOMENT_CHUNK values and the chunk
+// results merged in order, both serially and when the chunks are spread
+// over a ThreadPool, so the answer is bit-identical for any thread count.
+///////////////////////////////////////////////////////////////////////////////
+
+const size_t MOMENT_BLOCK = 1024;
+const size_t MOMENT_CHUNK = 64*MOMENT_BLOCK;
+
+struct Moments
+{
+    uint64_t n    = 0;
+    double   mean = 0.0;
+    double   m2   = 0.0;    // sum of squared deviations from the mean
+    double   lo   =  std::numeric_limits<double>::infinity();
+    double   hi   = -std::numeric_limits<double>::infinity();
+
+    void add( double x )
+    {
+        n++;
+        double d = x - mean;
+        mean += d/(double)n;
+        m2   += d*(x - mean);
+        lo    = std::min(lo, x);
+        hi    = std::max(hi, x);
+    }
+
+    void merge( const Moments &o )
+    {
+        if( o.n == 0 ) return;
+        if( n == 0 ) { *this = o; return; }
+
+        double na = (double)n, nb = (double)o.n, nt = na + nb;
+        double d  = o.mean - mean;
+        mean += d*(nb/nt);
+        m2   += o.m2 + d*d*(na*nb/nt);
+        n    += o.n;
+        lo    = std::min(lo, o.lo);
+        hi    = std::max(hi, o.hi);
+    }
+
+    double sum() const { return mean*(double)n; }
+
+    // Sample variance (n - 1 in the denominator), as standard_deviation()
+    double variance() const            { return n > 1 ? m2/(double)(n - 1) : 0.0; }
+    double population_variance() const { return n > 0 ? m2/(double)n : 0.0; }
+    double stddev() const              { return std::sqrt( variance() ); }
+};
+
+// Sequence of count scalars stride bytes apart, e.g. one field of an array
+// of structs or one column of a row-major table.
+template<class T>
+class StridedValues
+{
+public:
+    StridedValues( const void *base, size_t count, size_t stride = sizeof(T))
+        : base(static_cast<const unsigned char*>(base)), count(count), stride(stride) {}
+
+    size_t size() const { return count; }
+
+    T operator[]( size_t i ) const
+    {
+        T v;
+        memcpy( &v, base + i*stride, sizeof(T) );
+        return v;
+    }
+
+private:
+    const unsigned char *base;
+    size_t               count;
+    size_t               stride;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+// get(i) returns element i; [first, first + count) is at most one block
+template<class Get>
+inline Moments block_moments( const Get &get, size_t first, size_t count )
+{
+    const int L = 8;
+    double s[L] = {}, lo[L], hi[L];
+    for( int j = 0; j < L; j++) {
+        lo[j] =  std::numeric_limits<double>::infinity();
+        hi[j] = -std::numeric_limits<double>::infinity();
+    }
+
+    size_t nfull = count - count % L;
+    for( size_t i = 0; i < nfull; i += L)
+        for( int j = 0; j < L; j++) {
+            double x = (double)get(first + i + j);
+            s[j] += x;
+            lo[j] = std::min(lo[j], x);
+            hi[j] = std::max(hi[j], x);
+        }
+    for( size_t i = nfull; i < count; i++) {
+        double x = (double)get(first + i);
+        s[i - nfull] += x;
+        lo[0] = std::min(lo[0], x);
+        hi[0] = std::max(hi[0], x);
+    }
+
+    Moments m;
+    m.n    = count;
+    m.mean = (((s[0] + s[1]) + (s[2] + s[3])) + ((s[4] + s[5]) + (s[6] + s[7])))/(double)count;
+
+    double q[L] = {};
+    for( size_t i = 0; i < nfull; i += L)
+        for( int j = 0; j < L; j++) {
+            double d = (double)get(first + i + j) - m.mean;
+            q[j] += d*d;
+        }
+    for( size_t i = nfull; i < count; i++) {
+        double d = (double)get(first + i) - m.mean;
+        q[i - nfull] += d*d;
+    }
+    m.m2 = ((q[0] + q[1]) + (q[2] + q[3])) + ((q[4] + q[5]) + (q[6] + q[7]));
+
+    for( int j = 0; j < L; j++) {
+        m.lo = std::min(m.lo, lo[j]);
+        m.hi = std::max(m.hi, hi[j]);
+    }
+    return m;
+}
+
+template<class Get>
+inline Moments chunk_moments( const Get &get, size_t first, size_t last )
+{
+    Moments m;
+    for( size_t b = first; b < last; b += MOMENT_BLOCK)
+        m.merge( block_moments( get, b, std::min(MOMENT_BLOCK, last - b) ));
+    return m;
+}
+
+template<class Get>
+inline Moments indexed_moments( const Get &get, size_t n )
+{
+    Moments m;
+    for( size_t c = 0; c < n; c += MOMENT_CHUNK)
+        m.merge( chunk_moments( get, c, std::min(c + MOMENT_CHUNK, n) ));
+    return m;
+}
+
+template<class Get>
+inline Moments indexed_moments( ThreadPool &pool, const Get &get, size_t n )
+{
+    size_t nchunks = (n + MOMENT_CHUNK - 1)/MOMENT_CHUNK;
+    std::vector<Moments> part(nchunks);
+    pool.parallel_for( nchunks, [&]( size_t c, size_t ) {
+        part[c] = chunk_moments( get, c*MOMENT_CHUNK, std::min((c + 1)*MOMENT_CHUNK, n) );
+    });
+
+    Moments m;
+    for( auto &p : part ) m.merge( p );
+    return m;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// moments(v) for anything with size() and operator[] (std::vector,
+// StridedValues, ...), moments(first, last) for iterator ranges; with a
+// ThreadPool as first argument the chunks are processed in parallel.
+// Ranges that are not random access are read once with Welford's update.
+
+template<class Seq>
+inline Moments moments( const Seq &v )
+{
+    return indexed_moments( [&]( size_t i ) { return v[i]; }, v.size() );
+}
+
+template<class Seq>
+inline Moments moments( ThreadPool &pool, const Seq &v )
+{
+    return indexed_moments( pool, [&]( size_t i ) { return v[i]; }, v.size() );
+}
+
+template<class Iter>
+inline Moments moments( Iter first, Iter last )
+{
+    typedef typename std::iterator_traits<Iter>::iterator_category category;
+    if constexpr( std::is_base_of<std::random_access_iterator_tag, category>::value ) {
+        return indexed_moments( [&]( size_t i ) { return first[i]; }, (size_t)(last - first) );
+    } else {
+        Moments m;
+        for( ; first != last; ++first) m.add( (double)*first );
+        return m;
+    }
+}
+
+template<class Iter>
+inline Moments moments( ThreadPool &pool, Iter first, Iter last )
+{
+    return indexed_moments( pool, [&]( size_t i ) { return first[i]; }, (size_t)(last - first) );
+}
+}
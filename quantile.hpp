@@ -0,0 +1,192 @@
+#pragma once
+
+#include <assert.h>
+#include <stdint.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace JMath
+{
+///////////////////////////////////////////////////////////////////////////////
+// Streaming quantile sketch (Karnin, Lang and Liberty, "Optimal Quantile
+// Approximation in Streams", 2016).
+//
+// Values go into a stack of compactors. Level h holds items that each stand
+// for 2^h inputs; when a level exceeds its capacity it is sorted and every
+// other item (even or odd positions, by a coin flip) is promoted to the
+// level above. Capacities shrink by a factor 2/3 per level below the top,
+// so memory is O(k log(n/k)) (about 3k values) and the rank error of a
+// query stays within about 2/k of n (1% for the default k = 200).
+//
+// Sketches fed from different threads combine with merge(); the result has
+// the same guarantee as a sketch fed with all the values. min() and max()
+// are exact. The coin comes from a small seeded generator, so results are
+// reproducible for a given input order and seed.
+///////////////////////////////////////////////////////////////////////////////
+
+template<class T>
+class QuantileSketch
+{
+public:
+    explicit QuantileSketch( int k = 200, uint64_t seed = 0x9E3779B97F4A7C15ULL ) : k(std::max(k, 8)), state(seed)
+    {
+        grow();
+    }
+
+    void add( T x )
+    {
+        if( std::isnan((double)x) ) return;
+        lo = std::min(lo, x);
+        hi = std::max(hi, x);
+        n++;
+        levels[0].push_back(x);
+        if( ++stored >= maxstored ) compress();
+    }
+
+    template<class Iter>
+    void add( Iter first, Iter last )
+    {
+        for( ; first != last; ++first) add( *first );
+    }
+
+    void merge( const QuantileSketch &other )
+    {
+        while( levels.size() < other.levels.size() ) grow();
+        for( size_t h = 0; h < other.levels.size(); h++)
+            levels[h].insert( levels[h].end(), other.levels[h].begin(), other.levels[h].end() );
+        n  += other.n;
+        lo  = std::min(lo, other.lo);
+        hi  = std::max(hi, other.hi);
+        stored = count_stored();
+        while( stored >= maxstored ) compress();
+    }
+
+    uint64_t count() const { return n; }
+    bool     empty() const { return n == 0; }
+    T        min()   const { assert( n ); return lo; }
+    T        max()   const { assert( n ); return hi; }
+
+    // Number of values retained, a measure of the sketch's memory
+    size_t   retained() const { return stored; }
+
+    // Approximate q-quantile, q in [0, 1]: a retained value whose estimated
+    // rank is the first to reach q*n. q = 0 and q = 1 give min() and max().
+    T quantile( double q ) const
+    {
+        assert( n );
+        if( q <= 0 ) return lo;
+        if( q >= 1 ) return hi;
+
+        auto items  = weighted();
+        double goal = q*(double)n;
+        uint64_t cum = 0;
+        for( auto &it : items ) {
+            cum += it.second;
+            if( (double)cum >= goal ) return it.first;
+        }
+        return hi;
+    }
+
+    std::vector<T> quantiles( const std::vector<double> &qs ) const
+    {
+        std::vector<T> out;
+        out.reserve( qs.size() );
+        for( double q : qs ) out.push_back( quantile(q) );
+        return out;
+    }
+
+    // Approximate fraction of the values that are <= x
+    double cdf( T x ) const
+    {
+        if( n == 0 ) return 0.0;
+        uint64_t below = 0;
+        for( size_t h = 0; h < levels.size(); h++)
+            for( const T &v : levels[h] )
+                if( v <= x ) below += (uint64_t)1 << h;
+        return (double)below/(double)n;
+    }
+
+    void clear()
+    {
+        levels.clear();
+        n = stored = 0;
+        lo = std::numeric_limits<T>::max();
+        hi = std::numeric_limits<T>::lowest();
+        grow();
+    }
+
+private:
+    int      k;
+    uint64_t state;
+    uint64_t n = 0;
+    size_t   stored = 0, maxstored = 0;
+    T        lo = std::numeric_limits<T>::max();
+    T        hi = std::numeric_limits<T>::lowest();
+    std::vector<std::vector<T>> levels;
+
+    size_t capacity( size_t h ) const
+    {
+        size_t depth = levels.size() - h - 1;
+        return (size_t)std::ceil( k*std::pow(2.0/3.0, (double)depth) ) + 1;
+    }
+
+    void grow()
+    {
+        levels.emplace_back();
+        maxstored = 0;
+        for( size_t h = 0; h < levels.size(); h++) maxstored += capacity(h);
+    }
+
+    size_t count_stored() const
+    {
+        size_t s = 0;
+        for( auto &l : levels ) s += l.size();
+        return s;
+    }
+
+    bool coin()
+    {
+        // splitmix64
+        uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30))*0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27))*0x94D049BB133111EBULL;
+        return (z ^ (z >> 31)) & 1;
+    }
+
+    // Compacts the lowest full level, and further ones while over budget
+    void compress()
+    {
+        for( size_t h = 0; h < levels.size(); h++) {
+            if( levels[h].size() < capacity(h) ) continue;
+            if( h + 1 == levels.size() ) grow();
+
+            std::vector<T> &cur = levels[h];
+            std::sort( cur.begin(), cur.end() );
+
+            // An odd item out stays behind at the bottom of the level
+            size_t keep  = cur.size() & 1;
+            size_t start = keep + (coin() ? 1 : 0);
+            std::vector<T> &up = levels[h+1];
+            for( size_t i = start; i < cur.size(); i += 2) up.push_back( cur[i] );
+            cur.resize( keep );
+
+            stored = count_stored();
+            if( stored < maxstored ) break;
+        }
+    }
+
+    std::vector<std::pair<T, uint64_t>> weighted() const
+    {
+        std::vector<std::pair<T, uint64_t>> items;
+        items.reserve( stored );
+        for( size_t h = 0; h < levels.size(); h++)
+            for( const T &v : levels[h] ) items.emplace_back( v, (uint64_t)1 << h );
+        std::sort( items.begin(), items.end(),
+                   []( const std::pair<T, uint64_t> &a, const std::pair<T, uint64_t> &b ) { return a.first < b.first; } );
+        return items;
+    }
+};
+}
@@ -0,0 +1,191 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+
+namespace JMath
+{
+///////////////////////////////////////////////////////////////////////////////
+// Counter-based random numbers (Salmon et al., "Parallel Random Numbers: As
+// Easy as 1, 2, 3", SC 2011).
+//
+// Philox4x32-10 maps a 128-bit counter and a 64-bit key to four 32-bit
+// words with no state in between. RandomStream(seed, stream) reads word k
+// of its sequence from counter (k/4, stream): the seed is the key and the
+// 64-bit stream number occupies the upper half of the counter, so streams
+// never overlap and any position can be reached in O(1) with skip().
+//
+// Give each task of a parallel loop its own stream (the task index rather
+// than the thread index keeps results independent of the thread count).
+// fill() produces exactly the words that repeated next_u32() calls would,
+// a block of four at a time; floats use one word, doubles two.
+// TriSIMD::fill() and TriSIMD::fill_uniform() (trisimd.hpp) produce the same
+// words again with the rounds in vector registers.
+//
+// random_value() in veclib.hpp draws from thread_random(), one stream per
+// thread; seed_random() restarts the calling thread's stream.
+///////////////////////////////////////////////////////////////////////////////
+
+inline void philox4x32( uint32_t c[4], uint32_t k0, uint32_t k1 )
+{
+    for( int r = 0; r < 10; r++) {
+        uint64_t p0 = (uint64_t)0xD2511F53u*c[0];
+        uint64_t p1 = (uint64_t)0xCD9E8D57u*c[2];
+        uint32_t n0 = (uint32_t)(p1 >> 32) ^ c[1] ^ k0;
+        uint32_t n2 = (uint32_t)(p0 >> 32) ^ c[3] ^ k1;
+        c[0] = n0;
+        c[1] = (uint32_t)p1;
+        c[2] = n2;
+        c[3] = (uint32_t)p0;
+        k0 += 0x9E3779B9u;
+        k1 += 0xBB67AE85u;
+    }
+}
+
+// [0, 1) from the top 24 / 53 bits
+inline float  uniform_float( uint32_t w )              { return (float)(w >> 8)*(1.0f/16777216.0f); }
+inline double uniform_double( uint32_t lo, uint32_t hi )
+{
+    return (double)((((uint64_t)hi << 32) | lo) >> 11)*(1.0/9007199254740992.0);
+}
+
+// Words per uniform value of type T, and the value in [0, 1) they make
+template<class T> constexpr size_t uniform_words() { return sizeof(T) <= 4 ? 1 : 2; }
+
+template<class T>
+inline auto uniform_unit( const uint32_t *w )
+{
+    if constexpr( uniform_words<T>() == 1 ) return uniform_float( w[0] );
+    else                                    return uniform_double( w[0], w[1] );
+}
+
+// n values uniform in [lo, hi) from the words that fill(w, m) produces,
+// converted a buffer at a time
+template<class T, class Fill>
+inline void uniform_fill( T *out, size_t n, T lo, T hi, Fill fill )
+{
+    const size_t per = uniform_words<T>(), B = 256;
+    uint32_t w[B*2];
+    for( size_t i = 0; i < n; i += B) {
+        size_t m = std::min(B, n - i);
+        fill( w, m*per );
+        for( size_t j = 0; j < m; j++)
+            out[i + j] = lo + (T)(uniform_unit<T>( w + per*j )*(hi - lo));
+    }
+}
+
+class RandomStream
+{
+public:
+    explicit RandomStream( uint64_t seed = 0, uint64_t stream = 0 ) { reset( seed, stream ); }
+
+    void reset( uint64_t seed, uint64_t stream = 0 )
+    {
+        key    = seed;
+        id     = stream;
+        block  = 0;
+        used   = 4;
+    }
+
+    uint64_t seed()     const { return key; }
+    uint64_t stream()   const { return id; }
+    // Number of 32-bit words drawn so far
+    uint64_t position() const { return 4*block - (4 - used); }
+
+    // Jumps over n words
+    void skip( uint64_t n )
+    {
+        uint64_t pos = position() + n;
+        block = pos/4;
+        used  = 4;
+        if( pos % 4 ) {
+            refill();
+            used = pos % 4;
+        }
+    }
+
+    uint32_t next_u32()
+    {
+        if( used == 4 ) refill();
+        return buf[used++];
+    }
+
+    uint64_t next_u64()
+    {
+        uint32_t lo = next_u32();
+        return ((uint64_t)next_u32() << 32) | lo;
+    }
+
+    double uniform()                { uint32_t lo = next_u32(); return uniform_double( lo, next_u32() ); }
+    float  uniformf()               { return uniform_float( next_u32() ); }
+
+    // Uniform in [lo, hi): one word for float, two for anything else
+    template<class T>
+    T uniform( T lo, T hi )
+    {
+        return lo + (T)(next_unit<T>()*(hi - lo));
+    }
+
+    void fill( uint32_t *out, size_t n )
+    {
+        size_t i = 0;
+        while( i < n && used < 4 ) out[i++] = buf[used++];
+
+        // Whole blocks straight into the output
+        const uint32_t k0 = (uint32_t)key, k1 = (uint32_t)(key >> 32);
+        const uint32_t s0 = (uint32_t)id,  s1 = (uint32_t)(id >> 32);
+        for( ; n - i >= 4; i += 4, block++) {
+            uint32_t c[4] = { (uint32_t)block, (uint32_t)(block >> 32), s0, s1 };
+            philox4x32( c, k0, k1 );
+            memcpy( out + i, c, sizeof(c) );
+        }
+
+        while( i < n ) out[i++] = next_u32();
+    }
+
+    // n values uniform in [lo, hi)
+    template<class T>
+    void fill_uniform( T *out, size_t n, T lo, T hi )
+    {
+        uniform_fill( out, n, lo, hi, [this]( uint32_t *w, size_t m ) { fill( w, m ); } );
+    }
+
+private:
+    uint64_t key, id, block;
+    uint32_t buf[4];
+    unsigned used;
+
+    void refill()
+    {
+        uint32_t c[4] = { (uint32_t)block, (uint32_t)(block >> 32), (uint32_t)id, (uint32_t)(id >> 32) };
+        philox4x32( c, (uint32_t)key, (uint32_t)(key >> 32) );
+        memcpy( buf, c, sizeof(c) );
+        block++;
+        used = 0;
+    }
+
+    template<class T>
+    auto next_unit()
+    {
+        uint32_t w[2];
+        for( size_t j = 0; j < uniform_words<T>(); j++) w[j] = next_u32();
+        return uniform_unit<T>( w );
+    }
+};
+
+// The calling thread's stream. Threads start on distinct streams of seed 0
+// (the first thread to ask gets stream 0).
+inline RandomStream &thread_random()
+{
+    static std::atomic<uint64_t> next_stream(0);
+    thread_local RandomStream rng( 0, next_stream++ );
+    return rng;
+}
+
+inline void seed_random( uint64_t seed, uint64_t stream = 0 )
+{
+    thread_random().reset( seed, stream );
+}
+}
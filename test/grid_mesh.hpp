@@ -0,0 +1,41 @@
+#pragma once
+
+#include "../trimesh.hpp"
+#include <vector>
+
+// Grid mesh shared by the tests: n x n unit squares over [0, n]^2, each split
+// into two triangles along the diagonal from (i, j) to (i + 1, j + 1).
+// Interior vertices move by up to 'jitter' in x and y (kept below 0.5 so faces
+// stay valid) and every vertex takes a height in [-height, height]. Border
+// vertices keep their x and y, so the grid always covers the square exactly.
+template<class T = double>
+struct GridMesh {
+    int n;
+    std::vector<T>   xyz;
+    std::vector<int> ids;
+
+    explicit GridMesh(int n, double jitter = 0, double height = 0, uint64_t seed = 1) : n(n) {
+        JMath::seed_random(seed);
+        for (int j = 0; j <= n; j++)
+            for (int i = 0; i <= n; i++) {
+                bool border = i == 0 || j == 0 || i == n || j == n;
+                bool moved  = jitter > 0 && !border;
+                double dx = moved ? JMath::random_value<double>(-jitter, jitter) : 0;
+                double dy = moved ? JMath::random_value<double>(-jitter, jitter) : 0;
+                double z  = height > 0 ? JMath::random_value<double>(-height, height) : 0;
+                xyz.insert(xyz.end(), {(T)(i + dx), (T)(j + dy), (T)z});
+            }
+        for (int j = 0; j < n; j++)
+            for (int i = 0; i < n; i++) {
+                int v = j*(n + 1) + i;
+                ids.insert(ids.end(), {v, v + 1, v + n + 2, v, v + n + 2, v + n + 1});
+            }
+    }
+
+    size_t nvertices() const { return xyz.size()/3; }
+    size_t nfaces() const    { return ids.size()/3; }
+
+    IndexedMeshView<T> view() const {
+        return IndexedMeshView<T>(xyz.data(), nvertices(), ids.data(), nfaces());
+    }
+};
@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+#include "../trilib.hpp"
+#include <cmath>
+
+const double EPSILON = 1e-6;
+
+// Largest |Trig::acos(x) - acos(x)| over [-1, 1]: a uniform sweep plus a
+// finer one next to +-1, where the sqrt factor changes fastest
+template<class Trig, class T>
+long double MaxAcosError() {
+    long double worst = 0;
+    auto check = [&](T x) {
+        long double e = std::fabs((long double)Trig::acos(x) - std::acos((long double)x));
+        worst = std::max(worst, e);
+    };
+    const int n = 1 << 20;
+    for (int i = 0; i <= n; i++) check((T)(-1 + 2.0L*i/n));
+    for (int i = 0; i <= n; i++) {
+        check((T)(1 - 1e-3L*i/n));
+        check((T)(-1 + 1e-3L*i/n));
+    }
+    check((T)0.0);
+    return worst;
+}
+
+// Largest atan2 error around circles of several radii, covering all four
+// quadrants and both octants of each
+template<class Trig, class T>
+long double MaxAtan2Error() {
+    long double worst = 0;
+    const int n = 1 << 19;
+    for (long double r : {1e-30L, 1e-3L, 1.0L, 7.5e5L, 1e30L})
+        for (int i = 0; i < n; i++) {
+            long double t = -M_PI + 2*M_PI*(i + 0.5L)/n;
+            T y = (T)(r*std::sin(t)), x = (T)(r*std::cos(t));
+            long double e = std::fabs((long double)Trig::atan2(y, x) -
+                                      std::atan2((long double)y, (long double)x));
+            worst = std::max(worst, e);
+        }
+    return worst;
+}
+
+// ============================================================================
+// Error Bound Tests
+// ============================================================================
+
+TEST(FastMathAcos, FineTierBound) {
+    EXPECT_LT((MaxAcosError<TrigFine, double>()), 1.3e-8);
+    EXPECT_LT((MaxAcosError<TrigFine, float>()), 4e-7);
+}
+
+TEST(FastMathAcos, CoarseTierBound) {
+    EXPECT_LT((MaxAcosError<TrigCoarse, double>()), 3.9e-5);
+    EXPECT_LT((MaxAcosError<TrigCoarse, float>()), 3.9e-5);
+}
+
+TEST(FastMathAcos, ExactTierIsTheLibrary) {
+    for (double x : {-1.0, -0.3, 0.0, 0.7, 1.0}) EXPECT_EQ(TrigExact::acos(x), std::acos(x));
+}
+
+TEST(FastMathAcos, Endpoints) {
+    EXPECT_EQ(TrigFine::acos(1.0), 0.0);
+    EXPECT_EQ(TrigCoarse::acos(1.0), 0.0);
+    EXPECT_EQ(TrigFine::acos(-1.0), M_PI);
+    EXPECT_EQ(TrigCoarse::acos(-1.0f), (float)M_PI);
+}
+
+TEST(FastMathAtan2, FineTierBound) {
+    EXPECT_LT((MaxAtan2Error<TrigFine, double>()), 5.8e-9);
+    EXPECT_LT((MaxAtan2Error<TrigFine, float>()), 4e-7);
+}
+
+TEST(FastMathAtan2, CoarseTierBound) {
+    EXPECT_LT((MaxAtan2Error<TrigCoarse, double>()), 1.2e-5);
+    EXPECT_LT((MaxAtan2Error<TrigCoarse, float>()), 1.2e-5);
+}
+
+TEST(FastMathAtan2, Axes) {
+    const double bound = 1.2e-5;
+    EXPECT_EQ(TrigCoarse::atan2(0.0, 0.0), 0.0);
+    EXPECT_EQ(TrigCoarse::atan2(0.0, 2.0), 0.0);
+    EXPECT_NEAR(TrigCoarse::atan2(0.0, -2.0), M_PI, bound);
+    EXPECT_NEAR(TrigCoarse::atan2(3.0, 0.0), M_PI/2, bound);
+    EXPECT_NEAR(TrigCoarse::atan2(-3.0, 0.0), -M_PI/2, bound);
+    EXPECT_NEAR(TrigCoarse::atan2(-1.0, -1.0), -3*M_PI/4, bound);
+}
+
+// ============================================================================
+// Tier Selection Tests
+// ============================================================================
+
+TEST(FastMathTiers, WithTrigPicksTheType) {
+    EXPECT_EQ(with_trig(TRIG_EXACT, [](auto t) { return decltype(t)::accuracy; }), TRIG_EXACT);
+    EXPECT_EQ(with_trig(TRIG_FINE, [](auto t) { return decltype(t)::accuracy; }), TRIG_FINE);
+    EXPECT_EQ(with_trig(TRIG_COARSE, [](auto t) { return decltype(t)::accuracy; }), TRIG_COARSE);
+}
+
+TEST(FastMathTiers, TriangleAngles) {
+    JMath::seed_random(19);
+    for (int t = 0; t < 1000; t++) {
+        std::array<double, 3> p[3];
+        for (int k = 0; k < 3; k++)
+            for (int j = 0; j < 3; j++) p[k][j] = JMath::random_value<double>(-1, 1);
+
+        auto exact  = angles(p[0], p[1], p[2], Radians());
+        auto fine   = angles(p[0], p[1], p[2], AngleRadians<TrigFine>());
+        auto coarse = angles(p[0], p[1], p[2], AngleRadians<TrigCoarse>());
+        auto deg    = angles(p[0], p[1], p[2], AngleDegrees<TrigCoarse>());
+        for (int i = 0; i < 3; i++) {
+            EXPECT_NEAR(fine[i], exact[i], 1.3e-8);
+            EXPECT_NEAR(coarse[i], exact[i], 3.9e-5);
+            EXPECT_NEAR(deg[i], 180/M_PI*exact[i], 180/M_PI*3.9e-5);
+        }
+        EXPECT_NEAR(maxangle(p[0], p[1], p[2], AngleDegrees<TrigFine>()).first,
+                    maxangle(p[0], p[1], p[2]).first, 180/M_PI*1.3e-8);
+
+        // veclib's angle between vectors and planar angle
+        EXPECT_NEAR(angle(p[0], p[1], TrigCoarse()), angle(p[0], p[1]), 3.9e-5);
+        EXPECT_NEAR(angle(p[0][0], p[0][1], p[1][0], p[1][1], TrigFine()),
+                    angle(p[0][0], p[0][1], p[1][0], p[1][1]), 2*5.8e-9);
+    }
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,155 @@
+#include <gtest/gtest.h>
+#include "../veclib.hpp"
+#include <cmath>
+#include <list>
+
+const double EPSILON = 1e-6;
+
+using JMath::Moments;
+
+std::vector<double> RandomValues(size_t n, double offset, unsigned seed) {
+    JMath::seed_random(seed);
+    std::vector<double> v(n);
+    for (auto &x : v) x = offset + JMath::random_value<double>(-1, 1);
+    return v;
+}
+
+// Two-pass reference in long double
+void Reference(const std::vector<double> &v, long double &mean, long double &var) {
+    long double s = 0;
+    for (double x : v) s += x;
+    mean = s/v.size();
+    long double q = 0;
+    for (double x : v) q += (x - mean)*(x - mean);
+    var = q/(v.size() - 1);
+}
+
+void ExpectSameBits(const Moments &a, const Moments &b) {
+    EXPECT_EQ(a.n, b.n);
+    EXPECT_EQ(a.mean, b.mean);
+    EXPECT_EQ(a.m2, b.m2);
+    EXPECT_EQ(a.lo, b.lo);
+    EXPECT_EQ(a.hi, b.hi);
+}
+
+// ============================================================================
+// Accuracy Tests
+// ============================================================================
+
+TEST(Moments, SmallSequence) {
+    std::vector<double> v = {2, 4, 4, 4, 5, 5, 7, 9};
+    Moments m = JMath::moments(v);
+    EXPECT_EQ(m.n, 8u);
+    EXPECT_NEAR(m.mean, 5.0, EPSILON);
+    EXPECT_NEAR(m.sum(), 40.0, EPSILON);
+    EXPECT_NEAR(m.population_variance(), 4.0, EPSILON);
+    EXPECT_NEAR(m.variance(), 32.0/7.0, EPSILON);
+    EXPECT_EQ(m.lo, 2.0);
+    EXPECT_EQ(m.hi, 9.0);
+
+    Moments empty = JMath::moments(std::vector<double>());
+    EXPECT_EQ(empty.n, 0u);
+    EXPECT_EQ(empty.variance(), 0.0);
+}
+
+TEST(Moments, LargeOffsetDoesNotCancel) {
+    // Variance 1/3 on top of a mean of 1e9: a sum of squares would lose
+    // every digit
+    auto v = RandomValues(1000003, 1e9, 21);
+    long double mean, var;
+    Reference(v, mean, var);
+
+    Moments m = JMath::moments(v);
+    EXPECT_NEAR(m.mean, (double)mean, 1e-15*1e9);
+    EXPECT_NEAR(m.variance(), (double)var, 1e-6*(double)var);
+}
+
+TEST(Moments, MatchesLongDoubleReference) {
+    auto v = RandomValues(3000001, 0.25, 22);
+    long double mean, var;
+    Reference(v, mean, var);
+
+    Moments m = JMath::moments(v);
+    EXPECT_NEAR(m.mean, (double)mean, 1e-14);
+    EXPECT_NEAR(m.variance(), (double)var, 1e-14);
+}
+
+// ============================================================================
+// Parallel and Merge Tests
+// ============================================================================
+
+TEST(Moments, IndependentOfThreadCount) {
+    for (size_t n : {(size_t)1, (size_t)1000, JMath::MOMENT_CHUNK, 5*JMath::MOMENT_CHUNK + 777}) {
+        auto v = RandomValues(n, 3.0, 23);
+        Moments serial = JMath::moments(v);
+        for (size_t threads : {1, 2, 5}) {
+            JMath::ThreadPool pool(threads);
+            ExpectSameBits(JMath::moments(pool, v), serial);
+            ExpectSameBits(JMath::moments(pool, v.begin(), v.end()), serial);
+        }
+    }
+}
+
+TEST(Moments, MergeCombinesParts) {
+    auto a = RandomValues(12345, 1.0, 24), b = RandomValues(54321, -7.0, 25);
+    Moments m = JMath::moments(a);
+    m.merge(JMath::moments(b));
+
+    std::vector<double> all(a);
+    all.insert(all.end(), b.begin(), b.end());
+    Moments whole = JMath::moments(all);
+    EXPECT_EQ(m.n, whole.n);
+    EXPECT_NEAR(m.mean, whole.mean, 1e-12);
+    EXPECT_NEAR(m.variance(), whole.variance(), 1e-10);
+    EXPECT_EQ(m.lo, whole.lo);
+    EXPECT_EQ(m.hi, whole.hi);
+
+    Moments empty;
+    empty.merge(m);
+    ExpectSameBits(empty, m);
+}
+
+// ============================================================================
+// Input Form Tests
+// ============================================================================
+
+TEST(Moments, RangesAndStridedViews) {
+    auto v = RandomValues(10007, 2.0, 26);
+    Moments ref = JMath::moments(v);
+
+    ExpectSameBits(JMath::moments(v.data(), v.data() + v.size()), ref);
+
+    // A std::list is read once with Welford's update
+    std::list<double> list(v.begin(), v.end());
+    Moments welford = JMath::moments(list.begin(), list.end());
+    EXPECT_EQ(welford.n, ref.n);
+    EXPECT_NEAR(welford.mean, ref.mean, 1e-12);
+    EXPECT_NEAR(welford.variance(), ref.variance(), 1e-12);
+
+    // One field of an array of structs
+    struct Face { int id; float quality; double angle; };
+    std::vector<Face> faces(v.size());
+    for (size_t i = 0; i < v.size(); i++) faces[i] = {(int)i, (float)v[i], v[i]};
+    JMath::StridedValues<double> angles(&faces[0].angle, faces.size(), sizeof(Face));
+    ExpectSameBits(JMath::moments(angles), ref);
+
+    JMath::StridedValues<float> quality(&faces[0].quality, faces.size(), sizeof(Face));
+    EXPECT_NEAR(JMath::average_value(quality), ref.mean, 1e-6);
+}
+
+TEST(Moments, VecLibWrappers) {
+    auto v = RandomValues(5000, -1.0, 27);
+    Moments ref = JMath::moments(v);
+    EXPECT_EQ(JMath::average_value(v), ref.mean);
+    EXPECT_EQ(JMath::standard_deviation(v), ref.stddev());
+    EXPECT_EQ(JMath::average_value(v.begin(), v.end()), ref.mean);
+    EXPECT_EQ(JMath::standard_deviation(v.begin(), v.end()), ref.stddev());
+
+    std::vector<float> f(v.begin(), v.end());
+    EXPECT_NEAR(JMath::average_value(f), ref.mean, 1e-6);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
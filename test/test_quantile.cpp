@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+#include "../quantile.hpp"
+#include "../threadpool.hpp"
+#include "../veclib.hpp"
+#include <cmath>
+
+const double EPSILON = 1e-6;
+
+using JMath::QuantileSketch;
+
+// Largest |true rank of sketch.quantile(q) - q| over a grid of q, as a
+// fraction of n; sorted holds the exact data
+template<class T>
+double MaxRankError(const QuantileSketch<T> &sketch, const std::vector<T> &sorted) {
+    double worst = 0;
+    for (int i = 0; i <= 100; i++) {
+        double q = i/100.0;
+        T x = sketch.quantile(q);
+        double lo = (double)(std::lower_bound(sorted.begin(), sorted.end(), x) - sorted.begin());
+        double hi = (double)(std::upper_bound(sorted.begin(), sorted.end(), x) - sorted.begin());
+        double goal = q*sorted.size();
+        double err = goal < lo ? lo - goal : goal > hi ? goal - hi : 0.0;
+        worst = std::max(worst, err/sorted.size());
+    }
+    return worst;
+}
+
+std::vector<double> RandomValues(size_t n, unsigned seed) {
+    JMath::seed_random(seed);
+    std::vector<double> v(n);
+    // Skewed, as per-face angles and aspect ratios are
+    for (auto &x : v) x = std::pow(JMath::random_value<double>(0, 1), 4.0)*180.0;
+    return v;
+}
+
+// ============================================================================
+// Sketch Tests
+// ============================================================================
+
+TEST(QuantileSketch, SmallInputIsExact) {
+    QuantileSketch<int> sketch;
+    EXPECT_TRUE(sketch.empty());
+    for (int i = 100; i >= 1; i--) sketch.add(i);
+
+    EXPECT_EQ(sketch.count(), 100u);
+    EXPECT_EQ(sketch.retained(), 100u);
+    EXPECT_EQ(sketch.min(), 1);
+    EXPECT_EQ(sketch.max(), 100);
+    EXPECT_EQ(sketch.quantile(0.5), 50);
+    EXPECT_EQ(sketch.quantile(0.0), 1);
+    EXPECT_EQ(sketch.quantile(1.0), 100);
+    EXPECT_NEAR(sketch.cdf(25), 0.25, EPSILON);
+}
+
+TEST(QuantileSketch, RankErrorAndMemory) {
+    const size_t n = 1000000;
+    auto values = RandomValues(n, 21);
+    QuantileSketch<double> sketch;
+    sketch.add(values.begin(), values.end());
+
+    std::sort(values.begin(), values.end());
+    EXPECT_EQ(sketch.count(), n);
+    EXPECT_EQ(sketch.min(), values.front());
+    EXPECT_EQ(sketch.max(), values.back());
+    EXPECT_LT(MaxRankError(sketch, values), 0.015);
+    EXPECT_LT(sketch.retained(), 1000u);
+
+    // cdf() is the inverse of quantile() up to the same error
+    for (double q : {0.1, 0.5, 0.9}) EXPECT_NEAR(sketch.cdf(sketch.quantile(q)), q, 0.015);
+
+    // A larger k buys accuracy with memory
+    QuantileSketch<double> fine(1000);
+    fine.add(values.begin(), values.end());
+    EXPECT_LT(MaxRankError(fine, values), 0.004);
+}
+
+TEST(QuantileSketch, MergedWorkersMatchTheWhole) {
+    const size_t n = 1 << 20, nchunks = 64, chunk = n/nchunks;
+    auto values = RandomValues(n, 22);
+
+    JMath::ThreadPool pool(4);
+    std::vector<QuantileSketch<double>> partial;
+    for (size_t t = 0; t < pool.size(); t++) partial.emplace_back(200, 1000 + t);
+    pool.parallel_for(nchunks, [&](size_t c, size_t thread) {
+        partial[thread].add(values.begin() + c*chunk, values.begin() + (c + 1)*chunk);
+    });
+
+    QuantileSketch<double> sketch;
+    for (auto &p : partial) sketch.merge(p);
+
+    std::sort(values.begin(), values.end());
+    EXPECT_EQ(sketch.count(), n);
+    EXPECT_EQ(sketch.min(), values.front());
+    EXPECT_EQ(sketch.max(), values.back());
+    EXPECT_LT(MaxRankError(sketch, values), 0.015);
+    EXPECT_LT(sketch.retained(), 1000u);
+}
+
+TEST(QuantileSketch, ReproducibleAndClearable) {
+    auto values = RandomValues(100000, 23);
+    QuantileSketch<float> a, b;
+    for (double v : values) {
+        a.add((float)v);
+        b.add((float)v);
+    }
+    for (double q : {0.01, 0.5, 0.99}) EXPECT_EQ(a.quantile(q), b.quantile(q));
+
+    a.add(std::nanf(""));
+    EXPECT_EQ(a.count(), b.count());
+
+    a.clear();
+    EXPECT_TRUE(a.empty());
+    a.add(2.5f);
+    EXPECT_EQ(a.quantile(0.3), 2.5f);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
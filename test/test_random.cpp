@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+#include "../veclib.hpp"
+#include <cmath>
+#include <thread>
+
+const double EPSILON = 1e-6;
+
+using JMath::RandomStream;
+
+// ============================================================================
+// Philox Tests
+// ============================================================================
+
+TEST(RandomPhilox, KnownAnswers) {
+    // Philox4x32-10 test vectors of the Random123 distribution
+    uint32_t a[4] = {0, 0, 0, 0};
+    JMath::philox4x32(a, 0, 0);
+    EXPECT_EQ(a[0], 0x6627e8d5u);
+    EXPECT_EQ(a[1], 0xe169c58du);
+    EXPECT_EQ(a[2], 0xbc57ac4cu);
+    EXPECT_EQ(a[3], 0x9b00dbd8u);
+
+    uint32_t b[4] = {0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu};
+    JMath::philox4x32(b, 0xffffffffu, 0xffffffffu);
+    EXPECT_EQ(b[0], 0x408f276du);
+    EXPECT_EQ(b[1], 0x41c83b0eu);
+    EXPECT_EQ(b[2], 0xa20bc7c6u);
+    EXPECT_EQ(b[3], 0x6d5451fdu);
+
+    uint32_t c[4] = {0x243f6a88u, 0x85a308d3u, 0x13198a2eu, 0x03707344u};
+    JMath::philox4x32(c, 0xa4093822u, 0x299f31d0u);
+    EXPECT_EQ(c[0], 0xd16cfe09u);
+    EXPECT_EQ(c[1], 0x94fdccebu);
+    EXPECT_EQ(c[2], 0x5001e420u);
+    EXPECT_EQ(c[3], 0x24126ea1u);
+}
+
+// ============================================================================
+// Stream Tests
+// ============================================================================
+
+TEST(RandomStream, FillMatchesSingleDraws) {
+    for (size_t start : {0, 1, 3, 4, 7}) {
+        RandomStream one(42, 7), bulk(42, 7);
+        for (size_t i = 0; i < start; i++) {
+            one.next_u32();
+            bulk.next_u32();
+        }
+        std::vector<uint32_t> w(1001);
+        bulk.fill(w.data(), w.size());
+        for (size_t i = 0; i < w.size(); i++) ASSERT_EQ(w[i], one.next_u32()) << start << " " << i;
+        EXPECT_EQ(one.position(), bulk.position());
+        EXPECT_EQ(one.next_u32(), bulk.next_u32());
+    }
+
+    RandomStream one(5), bulk(5);
+    std::vector<float> f(777);
+    std::vector<double> d(333);
+    bulk.fill_uniform(f.data(), f.size(), -2.0f, 3.0f);
+    bulk.fill_uniform(d.data(), d.size(), 10.0, 20.0);
+    for (float x : f) ASSERT_EQ(x, one.uniform(-2.0f, 3.0f));
+    for (double x : d) ASSERT_EQ(x, one.uniform(10.0, 20.0));
+}
+
+TEST(RandomStream, SkipAndReset) {
+    RandomStream a(9, 1), b(9, 1);
+    for (int i = 0; i < 13; i++) a.next_u32();
+    b.skip(13);
+    EXPECT_EQ(b.position(), 13u);
+    for (int i = 0; i < 10; i++) EXPECT_EQ(a.next_u32(), b.next_u32());
+
+    // Skipping from a fresh stream lands on the same words
+    uint64_t w = a.next_u64();
+    a.reset(9, 1);
+    a.skip(23);
+    EXPECT_EQ(a.next_u64(), w);
+    EXPECT_EQ(a.seed(), 9u);
+    EXPECT_EQ(a.stream(), 1u);
+}
+
+TEST(RandomStream, StreamsAndSeedsDiffer) {
+    RandomStream a(1, 0), b(1, 1), c(2, 0);
+    int same_ab = 0, same_ac = 0;
+    for (int i = 0; i < 1000; i++) {
+        uint32_t x = a.next_u32();
+        same_ab += x == b.next_u32();
+        same_ac += x == c.next_u32();
+    }
+    EXPECT_LT(same_ab, 3);
+    EXPECT_LT(same_ac, 3);
+}
+
+TEST(RandomStream, Uniformity) {
+    RandomStream rng(2024);
+    const size_t n = 1 << 20, nbins = 64;
+    std::vector<double> d(n);
+    rng.fill_uniform(d.data(), n, 0.0, 1.0);
+
+    JMath::Moments m = JMath::moments(d);
+    EXPECT_NEAR(m.mean, 0.5, 5*std::sqrt(1.0/12/n));
+    EXPECT_NEAR(m.population_variance(), 1.0/12, 1e-3);
+    EXPECT_GE(m.lo, 0.0);
+    EXPECT_LT(m.hi, 1.0);
+
+    // Chi-square over 64 bins, 63 degrees of freedom: far below 120
+    std::vector<float> f(n);
+    rng.fill_uniform(f.data(), n, 0.0f, 1.0f);
+    std::vector<double> count(nbins, 0.0);
+    for (float x : f) count[std::min<size_t>((size_t)(x*nbins), nbins - 1)]++;
+    double chi2 = 0, expected = (double)n/nbins;
+    for (double c : count) chi2 += (c - expected)*(c - expected)/expected;
+    EXPECT_LT(chi2, 120.0);
+}
+
+// ============================================================================
+// Thread Stream Tests
+// ============================================================================
+
+TEST(RandomThreads, SeededAndPerThread) {
+    JMath::seed_random(77);
+    double a = JMath::random_value<double>(-1, 1);
+    JMath::seed_random(77);
+    EXPECT_EQ(JMath::random_value<double>(-1, 1), a);
+    EXPECT_GE(a, -1.0);
+    EXPECT_LT(a, 1.0);
+
+    // Fresh threads start on distinct streams
+    uint64_t s1 = 0, s2 = 0;
+    std::thread t1([&] { s1 = JMath::thread_random().stream(); });
+    std::thread t2([&] { s2 = JMath::thread_random().stream(); });
+    t1.join();
+    t2.join();
+    EXPECT_NE(s1, s2);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
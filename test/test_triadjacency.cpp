@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+#include "../triadjacency.hpp"
+#include "grid_mesh.hpp"
+#include <cmath>
+
+const double EPSILON = 1e-6;
+
+// Unit cube, vertex x + 2y + 4z, faces oriented outwards
+struct Cube {
+    std::vector<double> xyz;
+    std::vector<int> ids = {0, 2, 3,  0, 3, 1,  4, 5, 7,  4, 7, 6,
+                            0, 1, 5,  0, 5, 4,  2, 6, 7,  2, 7, 3,
+                            0, 4, 6,  0, 6, 2,  1, 3, 7,  1, 7, 5};
+    Cube() {
+        for (int v = 0; v < 8; v++) xyz.insert(xyz.end(), {double(v & 1), double((v >> 1) & 1), double((v >> 2) & 1)});
+    }
+    IndexedMeshView<double> view() const { return IndexedMeshView<double>(xyz.data(), 8, ids.data(), 12); }
+};
+
+void ExpectConsistentTwins(const CornerTable &ct) {
+    for (int h = 0; h < (int)ct.nhalfedges(); h++) {
+        EXPECT_EQ(CornerTable::next(CornerTable::prev(h)), h);
+        EXPECT_EQ(CornerTable::face(CornerTable::next(h)), CornerTable::face(h));
+        int t = ct.twin(h);
+        if (t < 0) continue;
+        EXPECT_EQ(ct.twin(t), h);
+        EXPECT_EQ(ct.origin(t), ct.target(h));
+        EXPECT_EQ(ct.target(t), ct.origin(h));
+        EXPECT_NE(CornerTable::face(t), CornerTable::face(h));
+    }
+}
+
+// ============================================================================
+// Corner Table Tests
+// ============================================================================
+
+TEST(CornerTable, ClosedCube) {
+    Cube cube;
+    CornerTable ct(cube.view());
+    ASSERT_EQ(ct.nhalfedges(), 36u);
+    ASSERT_EQ(ct.nvertices(), 8u);
+    EXPECT_TRUE(ct.is_closed_manifold());
+    for (int h = 0; h < 36; h++) {
+        EXPECT_GE(ct.twin(h), 0);
+        EXPECT_EQ(ct.origin(h), cube.ids[h]);
+    }
+    ExpectConsistentTwins(ct);
+
+    // The diagonal 0-3 of the z = 0 side joins its two triangles
+    EXPECT_EQ(ct.adjacent_face(0, 2), 1);
+    EXPECT_EQ(ct.adjacent_face(1, 0), 0);
+}
+
+TEST(CornerTable, GridBoundary) {
+    GridMesh<> grid(10);
+    CornerTable ct(grid.view());
+    EXPECT_FALSE(ct.is_closed_manifold());
+    EXPECT_EQ(ct.boundary_halfedges(), 40u);
+    EXPECT_EQ(ct.nonmanifold_halfedges(), 0u);
+    ExpectConsistentTwins(ct);
+
+    // Half-edges on the boundary lie on the border of the square
+    for (int h = 0; h < (int)ct.nhalfedges(); h++) {
+        if (!ct.is_boundary(h)) continue;
+        auto a = grid.view().vertex(ct.origin(h)), b = grid.view().vertex(ct.target(h));
+        bool border = (a[0] == b[0] && (a[0] == 0 || a[0] == 10)) || (a[1] == b[1] && (a[1] == 0 || a[1] == 10));
+        EXPECT_TRUE(border) << h;
+    }
+}
+
+TEST(CornerTable, NonManifoldEdges) {
+    std::vector<double> xyz(3*8, 0.0);
+    std::vector<int> ids = {0, 1, 2,  1, 0, 3,  0, 1, 4,    // three faces on edge 0-1
+                            5, 6, 7,  5, 6, 2,             // 5-6 twice in the same direction
+                            2, 3, 3};                       // repeated vertex, left out
+    IndexedMeshView<double> mesh(xyz.data(), 8, ids.data(), 6);
+    CornerTable ct(mesh);
+
+    EXPECT_TRUE(ct.is_nonmanifold(0));
+    EXPECT_TRUE(ct.is_nonmanifold(3));
+    EXPECT_TRUE(ct.is_nonmanifold(6));
+    EXPECT_TRUE(ct.is_nonmanifold(9));
+    EXPECT_TRUE(ct.is_nonmanifold(12));
+    for (int h = 15; h < 18; h++) EXPECT_TRUE(ct.is_nonmanifold(h));
+    EXPECT_TRUE(ct.is_boundary(1));             // 1 -> 2
+    EXPECT_TRUE(ct.is_boundary(4));             // 0 -> 3
+    EXPECT_EQ(ct.adjacent_face(0, 0), -1);
+    EXPECT_EQ(ct.nonmanifold_halfedges(), 8u);
+    ExpectConsistentTwins(ct);
+}
+
+TEST(CornerTable, HighValenceFan) {
+    // Closed fan of n faces around pole 0; the pole has valence n
+    const int n = 200000;
+    std::vector<double> xyz(3*(n + 1), 0.0);
+    std::vector<int> ids;
+    for (int i = 0; i < n; i++) ids.insert(ids.end(), {0, 1 + i, 1 + (i + 1) % n});
+    IndexedMeshView<double> mesh(xyz.data(), n + 1, ids.data(), n);
+
+    JMath::ThreadPool pool(4);
+    CornerTable ct(pool, mesh);
+    EXPECT_EQ(ct.boundary_halfedges(), (size_t)n);
+    EXPECT_EQ(ct.nonmanifold_halfedges(), 0u);
+    for (int f = 0; f < n; f++) {
+        ASSERT_EQ(ct.adjacent_face(f, 0), (f + n - 1) % n);
+        ASSERT_EQ(ct.adjacent_face(f, 2), (f + 1) % n);
+    }
+    ExpectConsistentTwins(ct);
+}
+
+TEST(CornerTable, ParallelBuildMatchesSerial) {
+    GridMesh<> grid(150);
+    JMath::ThreadPool pool(4);
+    CornerTable a(grid.view()), b(pool, grid.view());
+    ASSERT_EQ(a.nhalfedges(), b.nhalfedges());
+    for (int h = 0; h < (int)a.nhalfedges(); h++) ASSERT_EQ(a.twin(h), b.twin(h));
+    EXPECT_EQ(a.boundary_halfedges(), b.boundary_halfedges());
+    EXPECT_EQ(a.vertex_corners().corners(), b.vertex_corners().corners());
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,186 @@
+#include <gtest/gtest.h>
+#include "../tribary.hpp"
+#include <cmath>
+
+const double EPSILON = 1e-6;
+
+std::array<double, 3> Combine(const std::array<double, 3> &w, const std::array<double, 3> &a,
+                              const std::array<double, 3> &b, const std::array<double, 3> &c) {
+    std::array<double, 3> p;
+    for (int j = 0; j < 3; j++) p[j] = w[0]*a[j] + w[1]*b[j] + w[2]*c[j];
+    return p;
+}
+
+// ============================================================================
+// Single Frame Tests
+// ============================================================================
+
+TEST(TriBaryFrame, MatchesAreaBasedInside) {
+    JMath::seed_random(11);
+    for (int t = 0; t < 200; t++) {
+        std::array<double, 3> a, b, c;
+        for (int j = 0; j < 3; j++) {
+            a[j] = JMath::random_value<double>(-5, 5);
+            b[j] = JMath::random_value<double>(-5, 5);
+            c[j] = JMath::random_value<double>(-5, 5);
+        }
+        if (minangle(a, b, c).first < 5.0) continue;
+
+        double w1 = JMath::random_value<double>(0, 1);
+        double w2 = JMath::random_value<double>(0, 1 - w1);
+        auto q = Combine({1 - w1 - w2, w1, w2}, a, b, c);
+
+        BaryFrame<double> frame(a, b, c);
+        auto signed_w = frame(q);
+        auto area_w = barycoordinates(a, b, c, q);
+        for (int k = 0; k < 3; k++) EXPECT_NEAR(signed_w[k], area_w[k], 1e-5);
+        EXPECT_NEAR(signed_w[1], w1, EPSILON);
+        EXPECT_NEAR(signed_w[2], w2, EPSILON);
+    }
+}
+
+TEST(TriBaryFrame, SignedOutside) {
+    std::array<double, 3> a = {0.0, 0.0, 0.0};
+    std::array<double, 3> b = {1.0, 0.0, 0.0};
+    std::array<double, 3> c = {0.0, 1.0, 0.0};
+    BaryFrame<double> frame(a, b, c);
+
+    auto w = frame(std::array<double, 3>{2.0, 0.5, 0.0});
+    EXPECT_NEAR(w[0], -1.5, EPSILON);
+    EXPECT_NEAR(w[1], 2.0, EPSILON);
+    EXPECT_NEAR(w[2], 0.5, EPSILON);
+
+    auto v = frame(std::array<double, 3>{-1.0, -1.0, 0.0});
+    EXPECT_NEAR(v[0], 3.0, EPSILON);
+    EXPECT_NEAR(v[1], -1.0, EPSILON);
+    EXPECT_NEAR(v[2], -1.0, EPSILON);
+}
+
+TEST(TriBaryFrame, ProjectsOntoPlane) {
+    std::array<double, 3> a = {0.0, 0.0, 0.0};
+    std::array<double, 3> b = {4.0, 0.0, 0.0};
+    std::array<double, 3> c = {0.0, 2.0, 0.0};
+    BaryFrame<double> frame(a, b, c);
+
+    auto w = frame(std::array<double, 3>{1.0, 0.5, 7.0});
+    EXPECT_NEAR(w[0], 0.5, EPSILON);
+    EXPECT_NEAR(w[1], 0.25, EPSILON);
+    EXPECT_NEAR(w[2], 0.25, EPSILON);
+}
+
+TEST(TriBaryFrame, FloatAndDegenerate) {
+    std::array<float, 3> a = {1.0f, 1.0f, 1.0f};
+    std::array<float, 3> b = {3.0f, 1.0f, 1.0f};
+    std::array<float, 3> c = {1.0f, 3.0f, 1.0f};
+    BaryFrame<float> frame(a, b, c);
+    EXPECT_TRUE(frame.valid());
+    auto w = frame(std::array<float, 3>{2.0f, 2.0f, 1.0f});
+    EXPECT_NEAR(w[0], 0.0f, 1e-6f);
+    EXPECT_NEAR(w[1], 0.5f, 1e-6f);
+
+    std::array<float, 3> d = {5.0f, 1.0f, 1.0f};
+    EXPECT_FALSE(BaryFrame<float>(a, b, d).valid());
+}
+
+TEST(TriBaryFrame, SliverAndNearlyCollinear) {
+    // Thin but proper sliver: the Gram determinant is 1e-12 against d00*d11 = 1
+    std::array<double, 3> a = {0.0, 0.0, 0.0};
+    std::array<double, 3> b = {1.0, 0.0, 0.0};
+    std::array<double, 3> c = {1.0, 1e-6, 0.0};
+    BaryFrame<double> frame(a, b, c);
+    EXPECT_TRUE(frame.valid());
+    auto w = frame(Combine({0.25, 0.5, 0.25}, a, b, c));
+    EXPECT_NEAR(w[0], 0.25, 1e-8);
+    EXPECT_NEAR(w[1], 0.5, 1e-8);
+    EXPECT_NEAR(w[2], 0.25, 1e-8);
+
+    // Collinear up to rounding of the coordinates
+    std::array<double, 3> d = {0.1, 0.2, 0.3};
+    std::array<double, 3> e = {0.3, 0.6, 0.9};
+    EXPECT_FALSE(BaryFrame<double>(a, d, e).valid());
+}
+
+// ============================================================================
+// Batched Tests
+// ============================================================================
+
+TEST(TriBaryBatch, ManyPointsOneTriangle) {
+    std::array<double, 3> a = {0.0, 0.0, 1.0};
+    std::array<double, 3> b = {2.0, 0.5, 1.0};
+    std::array<double, 3> c = {0.5, 3.0, 2.0};
+    BaryFrame<double> frame(a, b, c);
+
+    const size_t n = 257;
+    std::vector<double> qx(n), qy(n), qz(n), l0(n), l1(n), l2(n);
+    JMath::seed_random(5);
+    for (size_t i = 0; i < n; i++) {
+        qx[i] = JMath::random_value<double>(-1, 3);
+        qy[i] = JMath::random_value<double>(-1, 3);
+        qz[i] = JMath::random_value<double>(0, 2);
+    }
+    barycoordinates(frame, n, qx.data(), qy.data(), qz.data(), l0.data(), l1.data(), l2.data());
+
+    for (size_t i = 0; i < n; i++) {
+        auto w = frame(std::array<double, 3>{qx[i], qy[i], qz[i]});
+        EXPECT_DOUBLE_EQ(l0[i], w[0]);
+        EXPECT_DOUBLE_EQ(l1[i], w[1]);
+        EXPECT_DOUBLE_EQ(l2[i], w[2]);
+        EXPECT_NEAR(l0[i] + l1[i] + l2[i], 1.0, EPSILON);
+    }
+}
+
+TEST(TriBaryBatch, PointsAgainstFaces) {
+    TriangleBatch<double> batch;
+    JMath::seed_random(6);
+    for (int t = 0; t < 50; t++) {
+        std::array<double, 3> p[3];
+        for (int k = 0; k < 3; k++)
+            for (int j = 0; j < 3; j++) p[k][j] = JMath::random_value<double>(-10, 10);
+        batch.push_back(p[0], p[1], p[2]);
+    }
+    BaryFrameBatch<double> frames(batch);
+    ASSERT_EQ(frames.size(), batch.size());
+
+    // For each query, rebuild the point from known weights and recover them
+    const size_t n = 400;
+    std::vector<int> faces(n);
+    std::vector<double> qx(n), qy(n), qz(n), w1(n), w2(n), l0(n), l1(n), l2(n);
+    for (size_t i = 0; i < n; i++) {
+        faces[i] = i % batch.size();
+        w1[i] = JMath::random_value<double>(-0.5, 1.5);
+        w2[i] = JMath::random_value<double>(-0.5, 1.5);
+        auto q = Combine({1 - w1[i] - w2[i], w1[i], w2[i]}, batch.vertex(faces[i], 0),
+                         batch.vertex(faces[i], 1), batch.vertex(faces[i], 2));
+        qx[i] = q[0]; qy[i] = q[1]; qz[i] = q[2];
+    }
+    barycoordinates(frames, n, faces.data(), qx.data(), qy.data(), qz.data(),
+                    l0.data(), l1.data(), l2.data());
+
+    for (size_t i = 0; i < n; i++) {
+        EXPECT_NEAR(l1[i], w1[i], 1e-6) << i;
+        EXPECT_NEAR(l2[i], w2[i], 1e-6) << i;
+        auto w = frames(faces[i], std::array<double, 3>{qx[i], qy[i], qz[i]});
+        EXPECT_DOUBLE_EQ(w[1], l1[i]);
+    }
+}
+
+TEST(TriBaryBatch, BuildsFromMeshView) {
+    std::vector<double> xyz = {0, 0, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0};
+    std::vector<int> ids = {0, 1, 2, 0, 2, 3};
+    IndexedMeshView<double> mesh(xyz.data(), 4, ids.data(), 2);
+
+    BaryFrameBatch<double> frames(mesh);
+    auto w = frames(1, std::array<double, 3>{0.25, 0.75, 0.0});
+    EXPECT_NEAR(w[0], 0.25, EPSILON);
+    EXPECT_NEAR(w[1], 0.25, EPSILON);
+    EXPECT_NEAR(w[2], 0.5, EPSILON);
+
+    auto fr = frames.frame(0);
+    EXPECT_TRUE(fr.valid());
+    EXPECT_EQ(fr.origin[0], 0.0);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,171 @@
+#include <gtest/gtest.h>
+#include "../tribatch.hpp"
+#include <cmath>
+
+const double EPSILON = 1e-6;
+
+// Fill a batch with reproducible random triangles
+template<class T>
+TriangleBatch<T> MakeRandomBatch(size_t n) {
+    JMath::seed_random(12345);
+    TriangleBatch<T> batch;
+    batch.reserve(n);
+    for (size_t i = 0; i < n; i++) {
+        std::array<T, 3> p[3];
+        for (int k = 0; k < 3; k++)
+            for (int j = 0; j < 3; j++)
+                p[k][j] = JMath::random_value<T>(-10, 10);
+        batch.push_back(p[0], p[1], p[2]);
+    }
+    return batch;
+}
+
+// ============================================================================
+// Container Tests
+// ============================================================================
+
+TEST(TriBatchContainer, PushBackAndVertex) {
+    std::array<double, 3> p1 = {0.0, 0.0, 0.0};
+    std::array<double, 3> p2 = {3.0, 0.0, 0.0};
+    std::array<double, 3> p3 = {0.0, 4.0, 1.0};
+
+    TriangleBatch<double> batch;
+    EXPECT_TRUE(batch.empty());
+    batch.push_back(p1, p2, p3);
+    batch.push_back(p3, p1, p2);
+
+    EXPECT_EQ(batch.size(), 2u);
+    EXPECT_EQ(batch.vertex(0, 2), p3);
+    EXPECT_EQ(batch.vertex(1, 0), p3);
+    EXPECT_EQ(batch.x(1)[0], 3.0);
+    EXPECT_EQ(batch.z(2)[0], 1.0);
+}
+
+TEST(TriBatchContainer, SetOverwritesTriangle) {
+    TriangleBatch<float> batch(3);
+    std::array<float, 3> p = {1.0f, 2.0f, 3.0f};
+    batch.set(1, p, p, p);
+
+    EXPECT_EQ(batch.vertex(1, 1), p);
+    EXPECT_EQ(batch.y(0)[0], 0.0f);
+}
+
+// ============================================================================
+// Batch Kernel Tests (must agree with the scalar trilib functions)
+// ============================================================================
+
+TEST(TriBatchKernels, AreaMatchesScalar) {
+    auto batch = MakeRandomBatch<double>(257);
+    std::vector<double> out(batch.size());
+    area(batch, out.data());
+
+    for (size_t i = 0; i < batch.size(); i++)
+        EXPECT_EQ(out[i], area(batch.vertex(i, 0), batch.vertex(i, 1), batch.vertex(i, 2)));
+}
+
+TEST(TriBatchKernels, NormalMatchesScalar) {
+    auto batch = MakeRandomBatch<double>(257);
+    std::vector<double> nx(batch.size()), ny(batch.size()), nz(batch.size());
+    normal(batch, nx.data(), ny.data(), nz.data());
+
+    for (size_t i = 0; i < batch.size(); i++) {
+        auto n = normal(batch.vertex(i, 0), batch.vertex(i, 1), batch.vertex(i, 2));
+        EXPECT_EQ(nx[i], n[0]);
+        EXPECT_EQ(ny[i], n[1]);
+        EXPECT_EQ(nz[i], n[2]);
+    }
+}
+
+TEST(TriBatchKernels, CentroidMatchesScalar) {
+    auto batch = MakeRandomBatch<double>(64);
+    std::vector<double> cx(batch.size()), cy(batch.size()), cz(batch.size());
+    centroid(batch, cx.data(), cy.data(), cz.data());
+
+    for (size_t i = 0; i < batch.size(); i++) {
+        auto c = centroid(batch.vertex(i, 0), batch.vertex(i, 1), batch.vertex(i, 2));
+        EXPECT_EQ(cx[i], c[0]);
+        EXPECT_EQ(cy[i], c[1]);
+        EXPECT_EQ(cz[i], c[2]);
+    }
+}
+
+TEST(TriBatchKernels, AnglesMatchScalar) {
+    auto batch = MakeRandomBatch<double>(257);
+    std::vector<double> a0(batch.size()), a1(batch.size()), a2(batch.size());
+
+    for (int measure : {ANGLE_IN_DEGREES, ANGLE_IN_RADIANS}) {
+        angles(batch, a0.data(), a1.data(), a2.data(), measure);
+        for (size_t i = 0; i < batch.size(); i++) {
+            auto a = angles(batch.vertex(i, 0), batch.vertex(i, 1), batch.vertex(i, 2), measure);
+            EXPECT_EQ(a0[i], a[0]);
+            EXPECT_EQ(a1[i], a[1]);
+            EXPECT_EQ(a2[i], a[2]);
+        }
+    }
+}
+
+TEST(TriBatchKernels, ApproximateAnglesMatchScalar) {
+    auto batch = MakeRandomBatch<double>(257);
+    std::vector<double> a0(batch.size()), a1(batch.size()), a2(batch.size());
+
+    angles(batch, a0.data(), a1.data(), a2.data(), ANGLE_IN_DEGREES, TRIG_COARSE);
+    for (size_t i = 0; i < batch.size(); i++) {
+        auto a = angles(batch.vertex(i, 0), batch.vertex(i, 1), batch.vertex(i, 2),
+                        AngleDegrees<TrigCoarse>());
+        EXPECT_EQ(a0[i], a[0]);
+        EXPECT_EQ(a1[i], a[1]);
+        EXPECT_EQ(a2[i], a[2]);
+    }
+
+    angles(batch, a0.data(), a1.data(), a2.data(), ANGLE_IN_RADIANS, TRIG_FINE);
+    for (size_t i = 0; i < batch.size(); i++) {
+        auto a = angles(batch.vertex(i, 0), batch.vertex(i, 1), batch.vertex(i, 2),
+                        AngleRadians<TrigFine>());
+        EXPECT_EQ(a0[i], a[0]);
+    }
+}
+
+TEST(TriBatchKernels, RadiiMatchScalar) {
+    auto batch = MakeRandomBatch<double>(257);
+    std::vector<double> rc(batch.size()), ri(batch.size());
+    circumradius(batch, rc.data());
+    inradius(batch, ri.data());
+
+    for (size_t i = 0; i < batch.size(); i++) {
+        auto pa = batch.vertex(i, 0), pb = batch.vertex(i, 1), pc = batch.vertex(i, 2);
+        EXPECT_EQ(rc[i], circumradius(pa, pb, pc));
+        EXPECT_EQ(ri[i], inradius(pa, pb, pc));
+    }
+}
+
+TEST(TriBatchKernels, FloatBatchMatchesScalar) {
+    auto batch = MakeRandomBatch<float>(100);
+    std::vector<float> ar(batch.size()), a0(batch.size()), a1(batch.size()), a2(batch.size());
+    area(batch, ar.data());
+    angles(batch, a0.data(), a1.data(), a2.data());
+
+    for (size_t i = 0; i < batch.size(); i++) {
+        auto pa = batch.vertex(i, 0), pb = batch.vertex(i, 1), pc = batch.vertex(i, 2);
+        EXPECT_EQ(ar[i], area(pa, pb, pc));
+        EXPECT_EQ(a1[i], angles(pa, pb, pc)[1]);
+    }
+}
+
+TEST(TriBatchKernels, KnownRightTriangle) {
+    TriangleBatch<double> batch;
+    batch.push_back({0.0, 0.0, 0.0}, {3.0, 0.0, 0.0}, {0.0, 4.0, 0.0});
+
+    double ar, rc, ri;
+    area(batch, &ar);
+    circumradius(batch, &rc);
+    inradius(batch, &ri);
+
+    EXPECT_NEAR(ar, 6.0, EPSILON);
+    EXPECT_NEAR(rc, 2.5, EPSILON);
+    EXPECT_NEAR(ri, 1.0, EPSILON);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
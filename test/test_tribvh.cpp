@@ -0,0 +1,289 @@
+#include <gtest/gtest.h>
+#include "../tribvh.hpp"
+#include <cmath>
+#include <set>
+
+const double EPSILON = 1e-6;
+
+typedef std::array<double, 3> Point;
+
+// Random triangles of size about 'size' scattered over a cube of side 10
+TriangleBatch<double> RandomTriangles(size_t n, double size, long seed) {
+    JMath::seed_random(seed);
+    TriangleBatch<double> batch;
+    for (size_t t = 0; t < n; t++) {
+        Point c, p[3];
+        for (int j = 0; j < 3; j++) c[j] = JMath::random_value<double>(0, 10);
+        for (int k = 0; k < 3; k++)
+            for (int j = 0; j < 3; j++) p[k][j] = c[j] + JMath::random_value<double>(-size, size);
+        batch.push_back(p[0], p[1], p[2]);
+    }
+    return batch;
+}
+
+Point RandomPoint(double lo, double hi) {
+    return {JMath::random_value<double>(lo, hi), JMath::random_value<double>(lo, hi),
+            JMath::random_value<double>(lo, hi)};
+}
+
+Point Combine(const std::array<double, 3> &w, const TriangleBatch<double> &batch, int f) {
+    Point p;
+    for (int j = 0; j < 3; j++)
+        p[j] = w[0]*batch.vertex(f, 0)[j] + w[1]*batch.vertex(f, 1)[j] + w[2]*batch.vertex(f, 2)[j];
+    return p;
+}
+
+// ============================================================================
+// Primitive Tests
+// ============================================================================
+
+TEST(TriBVHPrimitives, RayTriangle) {
+    Point a = {0.0, 0.0, 0.0}, b = {1.0, 0.0, 0.0}, c = {0.0, 1.0, 0.0};
+    Ray<double> ray;
+    ray.origin = {0.25, 0.5, 2.0};
+    ray.dir = {0.0, 0.0, -1.0};
+
+    double t, u, v;
+    ASSERT_TRUE(intersect(ray, a, b, c, t, u, v));
+    EXPECT_NEAR(t, 2.0, EPSILON);
+    EXPECT_NEAR(u, 0.25, EPSILON);
+    EXPECT_NEAR(v, 0.5, EPSILON);
+
+    ray.tmax = 1.5;
+    EXPECT_FALSE(intersect(ray, a, b, c, t, u, v));
+
+    ray.tmax = 10.0;
+    ray.origin = {0.75, 0.5, 2.0};
+    EXPECT_FALSE(intersect(ray, a, b, c, t, u, v));
+
+    ray.origin = {0.25, 0.5, 2.0};
+    ray.dir = {1.0, 0.0, 0.0};
+    EXPECT_FALSE(intersect(ray, a, b, c, t, u, v));
+}
+
+TEST(TriBVHPrimitives, ClosestPointRegions) {
+    Point a = {0.0, 0.0, 0.0}, b = {2.0, 0.0, 0.0}, c = {0.0, 2.0, 0.0};
+
+    auto in = closest_point(a, b, c, Point{0.5, 0.5, 3.0});
+    EXPECT_NEAR(in.point[0], 0.5, EPSILON);
+    EXPECT_NEAR(in.point[1], 0.5, EPSILON);
+    EXPECT_NEAR(in.dist2, 9.0, EPSILON);
+    EXPECT_NEAR(in.bary[1], 0.25, EPSILON);
+    EXPECT_NEAR(in.bary[2], 0.25, EPSILON);
+
+    auto va = closest_point(a, b, c, Point{-1.0, -1.0, 0.0});
+    EXPECT_NEAR(va.bary[0], 1.0, EPSILON);
+    EXPECT_NEAR(va.dist2, 2.0, EPSILON);
+
+    auto vb = closest_point(a, b, c, Point{3.0, -1.0, 0.0});
+    EXPECT_NEAR(vb.bary[1], 1.0, EPSILON);
+
+    auto ab = closest_point(a, b, c, Point{1.0, -2.0, 0.0});
+    EXPECT_NEAR(ab.point[0], 1.0, EPSILON);
+    EXPECT_NEAR(ab.point[1], 0.0, EPSILON);
+    EXPECT_NEAR(ab.dist2, 4.0, EPSILON);
+
+    auto bc = closest_point(a, b, c, Point{2.0, 2.0, 0.0});
+    EXPECT_NEAR(bc.point[0], 1.0, EPSILON);
+    EXPECT_NEAR(bc.point[1], 1.0, EPSILON);
+    EXPECT_NEAR(bc.bary[1], 0.5, EPSILON);
+    EXPECT_NEAR(bc.bary[2], 0.5, EPSILON);
+}
+
+TEST(TriBVHPrimitives, TriangleBoxOverlap) {
+    Point a = {0.0, 0.0, 0.0}, b = {4.0, 0.0, 0.0}, c = {0.0, 4.0, 0.0};
+    EXPECT_TRUE(triangle_box_overlap(a, b, c, Point{1, 1, -1}, Point{2, 2, 1}));
+    EXPECT_FALSE(triangle_box_overlap(a, b, c, Point{1, 1, 0.5}, Point{2, 2, 1}));
+    // Inside the triangle's bounding box but beyond the hypotenuse
+    EXPECT_FALSE(triangle_box_overlap(a, b, c, Point{3, 3, -1}, Point{4, 4, 1}));
+    // Box containing the whole triangle
+    EXPECT_TRUE(triangle_box_overlap(a, b, c, Point{-1, -1, -1}, Point{5, 5, 1}));
+}
+
+// ============================================================================
+// Tree Tests
+// ============================================================================
+
+TEST(TriBVHBuild, StructureCoversAllFaces) {
+    auto batch = RandomTriangles(5000, 0.2, 1);
+    TriangleBVH<double> bvh(batch, 2);
+    ASSERT_EQ(bvh.nfaces(), batch.size());
+
+    std::vector<int> seen(batch.size(), 0);
+    const auto &nodes = bvh.nodes();
+    for (size_t i = 0; i < nodes.size(); i++) {
+        const auto &n = nodes[i];
+        if (n.leaf()) {
+            EXPECT_LE(n.count, 4u);
+            for (uint32_t k = n.index; k < n.index + n.count; k++) {
+                seen[bvh.face(k)]++;
+                for (int v = 0; v < 3; v++)
+                    for (int j = 0; j < 3; j++) {
+                        EXPECT_GE(bvh.triangles().vertex(k, v)[j], n.lo[j]);
+                        EXPECT_LE(bvh.triangles().vertex(k, v)[j], n.hi[j]);
+                    }
+            }
+        } else {
+            ASSERT_LT(n.index, nodes.size());
+            for (uint32_t c : {uint32_t(i + 1), n.index})
+                for (int j = 0; j < 3; j++) {
+                    EXPECT_GE(nodes[c].lo[j], n.lo[j]);
+                    EXPECT_LE(nodes[c].hi[j], n.hi[j]);
+                }
+        }
+    }
+    for (int s : seen) EXPECT_EQ(s, 1);
+}
+
+TEST(TriBVHBuild, IndependentOfThreadCount) {
+    // Large enough for the top levels to be split chunk by chunk
+    auto batch = RandomTriangles(100000, 0.05, 2);
+    TriangleBVH<double> one(batch, 1), many(batch, 4);
+    ASSERT_EQ(one.nodes().size(), many.nodes().size());
+    for (size_t i = 0; i < one.nodes().size(); i++) {
+        EXPECT_EQ(one.nodes()[i].index, many.nodes()[i].index);
+        EXPECT_EQ(one.nodes()[i].count, many.nodes()[i].count);
+    }
+    for (size_t i = 0; i < one.nfaces(); i++) EXPECT_EQ(one.face(i), many.face(i));
+}
+
+TEST(TriBVHBuild, EmptyAndCoincident) {
+    TriangleBatch<double> none;
+    TriangleBVH<double> empty(none);
+    EXPECT_TRUE(empty.empty());
+    EXPECT_EQ(empty.intersect(Ray<double>()).face, -1);
+    EXPECT_EQ(empty.closest_point(Point{0, 0, 0}).face, -1);
+
+    // Many copies of one triangle: no SAH split exists
+    TriangleBatch<double> same;
+    for (int i = 0; i < 100; i++) same.push_back(Point{0, 0, 0}, Point{1, 0, 0}, Point{0, 1, 0});
+    TriangleBVH<double> bvh(same, 1);
+    for (const auto &n : bvh.nodes()) {
+        if (n.leaf()) {
+            EXPECT_LE(n.count, 4u);
+        }
+    }
+    EXPECT_EQ(bvh.overlap(Point{0.1, 0.1, -1}, Point{0.2, 0.2, 1}).size(), 100u);
+}
+
+// Claims 2^32 faces without storing any
+struct HugeMesh {
+    size_t nfaces() const { return size_t(1) << 32; }
+    Point corner(size_t, int) const { return Point{0, 0, 0}; }
+};
+
+TEST(TriBVHBuild, RejectsTooManyFaces) {
+    EXPECT_THROW(TriangleBVH<double>(HugeMesh(), 1), std::length_error);
+}
+
+// ============================================================================
+// Query Tests
+// ============================================================================
+
+TEST(TriBVHQuery, RaysMatchBruteForce) {
+    auto batch = RandomTriangles(3000, 0.3, 3);
+    TriangleBVH<double> bvh(batch, 2);
+
+    JMath::seed_random(30);
+    int nhits = 0;
+    for (int r = 0; r < 500; r++) {
+        Ray<double> ray;
+        ray.origin = RandomPoint(-2, 12);
+        Point target = RandomPoint(0, 10);
+        for (int j = 0; j < 3; j++) ray.dir[j] = target[j] - ray.origin[j];
+
+        double best = std::numeric_limits<double>::infinity();
+        int best_face = -1;
+        for (size_t f = 0; f < batch.size(); f++) {
+            double t, u, v;
+            if (intersect(ray, batch.vertex(f, 0), batch.vertex(f, 1), batch.vertex(f, 2), t, u, v) &&
+                t < best) {
+                best = t;
+                best_face = f;
+            }
+        }
+
+        RayHit<double> hit;
+        bool found = bvh.intersect(ray, hit);
+        ASSERT_EQ(found, best_face >= 0) << r;
+        if (!found) continue;
+        nhits++;
+        EXPECT_NEAR(hit.t, best, 1e-9) << r;
+
+        // The barycentrics rebuild the hit point on the reported face
+        auto p = Combine(hit.bary(), batch, hit.face);
+        for (int j = 0; j < 3; j++) EXPECT_NEAR(p[j], ray.origin[j] + hit.t*ray.dir[j], 1e-9);
+    }
+    EXPECT_GT(nhits, 100);
+}
+
+TEST(TriBVHQuery, ClosestPointsMatchBruteForce) {
+    auto batch = RandomTriangles(3000, 0.3, 4);
+    TriangleBVH<double> bvh(batch, 2);
+
+    JMath::seed_random(40);
+    for (int r = 0; r < 300; r++) {
+        Point q = RandomPoint(-3, 13);
+        double best = std::numeric_limits<double>::infinity();
+        for (size_t f = 0; f < batch.size(); f++)
+            best = std::min(best, closest_point(batch.vertex(f, 0), batch.vertex(f, 1),
+                                                batch.vertex(f, 2), q).dist2);
+
+        auto c = bvh.closest_point(q);
+        ASSERT_GE(c.face, 0);
+        EXPECT_NEAR(c.dist2, best, 1e-12) << r;
+        auto p = Combine(c.bary, batch, c.face);
+        for (int j = 0; j < 3; j++) EXPECT_NEAR(p[j], c.point[j], 1e-9);
+    }
+
+    // Nothing within the search radius
+    EXPECT_EQ(bvh.closest_point(Point{100, 100, 100}, 1.0).face, -1);
+}
+
+TEST(TriBVHQuery, OverlapMatchesBruteForce) {
+    auto batch = RandomTriangles(3000, 0.3, 5);
+    TriangleBVH<double> bvh(batch, 2);
+
+    JMath::seed_random(50);
+    for (int r = 0; r < 100; r++) {
+        Point lo = RandomPoint(0, 9), hi;
+        for (int j = 0; j < 3; j++) hi[j] = lo[j] + JMath::random_value<double>(0.1, 1.5);
+
+        std::set<int> expected;
+        for (size_t f = 0; f < batch.size(); f++)
+            if (triangle_box_overlap(batch.vertex(f, 0), batch.vertex(f, 1), batch.vertex(f, 2), lo, hi))
+                expected.insert(f);
+
+        auto found = bvh.overlap(lo, hi);
+        EXPECT_EQ(std::set<int>(found.begin(), found.end()), expected) << r;
+        EXPECT_EQ(found.size(), expected.size());
+    }
+}
+
+TEST(TriBVHQuery, IndexedMeshFloat) {
+    // Unit square split into two triangles at z = 1
+    std::vector<float> xyz = {0, 0, 1, 1, 0, 1, 1, 1, 1, 0, 1, 1};
+    std::vector<int> ids = {0, 1, 2, 0, 2, 3};
+    IndexedMeshView<float> mesh(xyz.data(), 4, ids.data(), 2);
+    TriangleBVH<float> bvh(mesh, 1);
+
+    Ray<float> ray;
+    ray.origin = {0.2f, 0.7f, 5.0f};
+    ray.dir = {0.0f, 0.0f, -1.0f};
+    auto hit = bvh.intersect(ray);
+    EXPECT_EQ(hit.face, 1);
+    EXPECT_NEAR(hit.t, 4.0f, 1e-6f);
+    auto w = hit.bary();
+    EXPECT_NEAR(w[0], 0.3f, 1e-6f);
+    EXPECT_NEAR(w[1], 0.2f, 1e-6f);
+    EXPECT_NEAR(w[2], 0.5f, 1e-6f);
+
+    auto c = bvh.closest_point(std::array<float, 3>{0.9f, 0.2f, 0.0f});
+    EXPECT_EQ(c.face, 0);
+    EXPECT_NEAR(c.dist2, 1.0f, 1e-6f);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
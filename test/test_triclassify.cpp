@@ -0,0 +1,165 @@
+#include <gtest/gtest.h>
+#include "../triclassify.hpp"
+#include <cmath>
+
+const double EPSILON = 1e-6;
+
+// Random triangles with a mix of thin, wide and degenerate shapes
+TriangleBatch<double> MakeBatch(size_t n) {
+    JMath::seed_random(2024);
+    TriangleBatch<double> batch;
+    for (size_t i = 0; i < n; i++) {
+        std::array<double, 3> p[3];
+        for (int k = 0; k < 3; k++)
+            for (int j = 0; j < 3; j++)
+                p[k][j] = JMath::random_value<double>(-10, 10);
+        if (i % 5 == 1)      // needle: third vertex close to the second
+            for (int j = 0; j < 3; j++) p[2][j] = p[1][j] + 0.05*(p[2][j] - p[1][j]);
+        if (i % 7 == 2)      // cap: third vertex close to the midpoint of the first edge
+            for (int j = 0; j < 3; j++) p[2][j] = 0.5*(p[0][j] + p[1][j]) + 0.02*(p[2][j] - p[0][j]);
+        if (i % 11 == 3) p[2] = p[0];
+        if (i % 13 == 4) for (int j = 0; j < 3; j++) p[2][j] = 2*p[1][j] - p[0][j];
+        batch.push_back(p[0], p[1], p[2]);
+    }
+    return batch;
+}
+
+// Classification computed the slow way, from angles in degrees
+uint8_t ReferenceMask(const std::array<double, 3> &pa, const std::array<double, 3> &pb,
+                      const std::array<double, 3> &pc) {
+    auto a = angles(pa, pb, pc);
+    if (std::isnan(a[0] + a[1] + a[2])) return TRI_DEGENERATE;
+    double lo = std::min({a[0], a[1], a[2]});
+    double hi = std::max({a[0], a[1], a[2]});
+    if (hi > 179.999) return TRI_DEGENERATE;
+
+    uint8_t mask = std::fabs(hi - 90.0) < 1e-4 ? TRI_RIGHT : (hi < 90.0 ? TRI_ACUTE : TRI_OBTUSE);
+    if (lo < 10.0) mask |= TRI_SLIVER;
+    if (hi > 160.0) mask |= TRI_CAP;
+    if (lo < 10.0 && hi <= 160.0) mask |= TRI_NEEDLE;
+    return mask;
+}
+
+// Faces within a hair of a threshold may legitimately land on either side
+bool NearThreshold(const std::array<double, 3> &pa, const std::array<double, 3> &pb,
+                   const std::array<double, 3> &pc) {
+    auto a = angles(pa, pb, pc);
+    for (double t : {10.0, 90.0, 160.0, 179.999})
+        for (int k = 0; k < 3; k++)
+            if (std::fabs(a[k] - t) < 1e-3) return true;
+    return false;
+}
+
+// ============================================================================
+// Predicate Tests
+// ============================================================================
+
+TEST(TriClassifyPredicates, MatchAngleDefinitions) {
+    auto batch = MakeBatch(2000);
+    for (size_t i = 0; i < batch.size(); i++) {
+        auto pa = batch.vertex(i, 0), pb = batch.vertex(i, 1), pc = batch.vertex(i, 2);
+        if (NearThreshold(pa, pb, pc)) continue;
+        double hi = maxangle(pa, pb, pc).first;
+        if (std::isnan(hi)) {
+            EXPECT_TRUE(isDegenerate(pa, pb, pc)) << i;
+            continue;
+        }
+        EXPECT_EQ(isObtuse(pa, pb, pc), hi > 90.0) << i;
+        EXPECT_EQ(isAcute(pa, pb, pc), hi <= 90.0) << i;
+        EXPECT_EQ(isDegenerate(pa, pb, pc), hi > 179.999) << i;
+    }
+}
+
+TEST(TriClassifyPredicates, CoincidentVerticesAreDegenerate) {
+    std::array<double, 3> p1 = {1.0, 2.0, 3.0};
+    std::array<double, 3> p2 = {4.0, 5.0, 6.0};
+    EXPECT_TRUE(isDegenerate(p1, p1, p2));
+    EXPECT_TRUE(isDegenerate(p1, p1, p1));
+}
+
+TEST(TriClassifyPredicates, IntegerCoordinates) {
+    std::array<int, 3> p1 = {0, 0, 0};
+    std::array<int, 3> p2 = {3, 0, 0};
+    std::array<int, 3> p3 = {0, 4, 0};
+    std::array<int, 3> p4 = {6, 0, 0};
+    EXPECT_TRUE(isAcute(p1, p2, p3));
+    EXPECT_FALSE(isObtuse(p1, p2, p3));
+    EXPECT_TRUE(isDegenerate(p1, p2, p4));
+}
+
+// ============================================================================
+// Bitmask Tests
+// ============================================================================
+
+TEST(TriClassifyMask, KnownShapes) {
+    std::array<double, 3> o = {0.0, 0.0, 0.0};
+    std::array<double, 3> x = {3.0, 0.0, 0.0};
+    std::array<double, 3> y = {0.0, 4.0, 0.0};
+    EXPECT_EQ(classify(o, x, y), TRI_RIGHT);
+
+    std::array<double, 3> e = {1.5, 1.5*std::sqrt(3.0), 0.0};
+    EXPECT_EQ(classify(o, x, e), TRI_ACUTE);
+
+    std::array<double, 3> n1 = {3.0, -0.1, 0.0};
+    std::array<double, 3> n2 = {3.0, 0.1, 0.0};
+    EXPECT_EQ(classify(o, n1, n2), TRI_ACUTE | TRI_SLIVER | TRI_NEEDLE);
+
+    std::array<double, 3> cap = {1.5, 0.1, 0.0};
+    EXPECT_EQ(classify(o, x, cap), TRI_OBTUSE | TRI_SLIVER | TRI_CAP);
+
+    std::array<double, 3> line = {6.0, 0.0, 0.0};
+    EXPECT_EQ(classify(o, x, line), TRI_DEGENERATE);
+    EXPECT_EQ(classify(o, o, x), TRI_DEGENERATE);
+}
+
+TEST(TriClassifyMask, CustomThresholds) {
+    std::array<double, 3> o = {0.0, 0.0, 0.0};
+    std::array<double, 3> x = {3.0, 0.0, 0.0};
+    std::array<double, 3> c = {1.5, 0.5, 0.0};   // angles 18.4, 18.4, 143.1
+
+    EXPECT_EQ(classify(o, x, c), TRI_OBTUSE);
+    EXPECT_EQ(classify(o, x, c, TriangleClassifier(20.0, 140.0)),
+              TRI_OBTUSE | TRI_SLIVER | TRI_CAP);
+}
+
+TEST(TriClassifyMask, BatchMatchesReferenceAndPredicates) {
+    auto batch = MakeBatch(2000);
+    std::vector<uint8_t> mask(batch.size());
+    classify(batch, mask.data());
+
+    size_t counts[7] = {0};
+    for (size_t i = 0; i < batch.size(); i++) {
+        auto pa = batch.vertex(i, 0), pb = batch.vertex(i, 1), pc = batch.vertex(i, 2);
+        EXPECT_EQ(mask[i], classify(pa, pb, pc)) << i;
+        EXPECT_EQ((mask[i] & TRI_DEGENERATE) != 0, isDegenerate(pa, pb, pc)) << i;
+        if (!NearThreshold(pa, pb, pc)) {
+            EXPECT_EQ(mask[i], ReferenceMask(pa, pb, pc)) << i;
+        }
+        for (int b = 0; b < 7; b++) counts[b] += (mask[i] >> b) & 1;
+    }
+    // Every class except exact right angles shows up in the random batch
+    for (int b : {0, 2, 3, 4, 5, 6}) EXPECT_GT(counts[b], 0u) << b;
+}
+
+TEST(TriClassifyMask, MeshViewMatchesBatch) {
+    auto batch = MakeBatch(300);
+    std::vector<double> xyz;
+    std::vector<int> ids;
+    for (size_t i = 0; i < batch.size(); i++)
+        for (int k = 0; k < 3; k++) {
+            auto p = batch.vertex(i, k);
+            xyz.insert(xyz.end(), p.begin(), p.end());
+            ids.push_back(int(3*i + k));
+        }
+    IndexedMeshView<double> mesh(xyz.data(), xyz.size()/3, ids.data(), batch.size());
+
+    std::vector<uint8_t> expected(batch.size()), out(batch.size());
+    classify(batch, expected.data());
+    classify(mesh, out.data());
+    EXPECT_EQ(out, expected);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,179 @@
+#include <gtest/gtest.h>
+#include "../triclosest.hpp"
+#include <cmath>
+
+const double EPSILON = 1e-6;
+
+typedef std::array<double, 3> Point;
+
+// Squared distance from q to segment [a, b]
+double SegmentDist2(const Point &a, const Point &b, const Point &q) {
+    Point ab = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+    double len2 = ab[0]*ab[0] + ab[1]*ab[1] + ab[2]*ab[2];
+    double t = 0;
+    if (len2 > 0)
+        t = std::min(1.0, std::max(0.0, ((q[0] - a[0])*ab[0] + (q[1] - a[1])*ab[1] +
+                                         (q[2] - a[2])*ab[2])/len2));
+    double d = 0;
+    for (int j = 0; j < 3; j++) d += (a[j] + t*ab[j] - q[j])*(a[j] + t*ab[j] - q[j]);
+    return d;
+}
+
+// Reference distance: the foot of the perpendicular if it lies inside the
+// triangle, otherwise the nearest edge
+double ReferenceDist2(const Point &a, const Point &b, const Point &c, const Point &q) {
+    double best = std::min({SegmentDist2(a, b, q), SegmentDist2(b, c, q), SegmentDist2(c, a, q)});
+    auto n = normal(a, b, c);
+    double len = std::sqrt(n[0]*n[0] + n[1]*n[1] + n[2]*n[2]);
+    if (len == 0) return best;
+    double h = ((q[0] - a[0])*n[0] + (q[1] - a[1])*n[1] + (q[2] - a[2])*n[2])/len;
+    Point foot = {q[0] - h*n[0]/len, q[1] - h*n[1]/len, q[2] - h*n[2]/len};
+    auto w = barycoordinates(a, b, c, foot);
+    if (w[0] >= 0 && w[1] >= 0 && w[2] >= 0 && std::fabs(w[0] + w[1] + w[2] - 1) < 1e-9)
+        best = std::min(best, h*h);
+    return best;
+}
+
+// ============================================================================
+// Region Tests
+// ============================================================================
+
+TEST(TriClosestRegions, EveryFeature) {
+    Point a = {0, 0, 0}, b = {2, 0, 0}, c = {0, 2, 0};
+    struct Case { Point q; uint8_t feature; Point point; };
+    const Case cases[] = {
+        {{-1, -1, 0},  FEATURE_VERTEX_A, {0, 0, 0}},
+        {{3, -1, 1},   FEATURE_VERTEX_B, {2, 0, 0}},
+        {{-1, 3, -1},  FEATURE_VERTEX_C, {0, 2, 0}},
+        {{1, -2, 0},   FEATURE_EDGE_AB,  {1, 0, 0}},
+        {{-2, 1, 0},   FEATURE_EDGE_AC,  {0, 1, 0}},
+        {{2, 2, 0},    FEATURE_EDGE_BC,  {1, 1, 0}},
+        {{0.5, 0.5, 3}, FEATURE_FACE,    {0.5, 0.5, 0}},
+    };
+    for (const Case &k : cases) {
+        auto r = closest_point(a, b, c, k.q);
+        EXPECT_EQ(r.feature, k.feature);
+        EXPECT_EQ(r.face, -1);
+        for (int j = 0; j < 3; j++) EXPECT_NEAR(r.point[j], k.point[j], EPSILON);
+        EXPECT_NEAR(r.dist2, ReferenceDist2(a, b, c, k.q), EPSILON);
+        EXPECT_NEAR(r.bary[0] + r.bary[1] + r.bary[2], 1.0, EPSILON);
+    }
+
+    // Vertices come back exactly
+    EXPECT_EQ(closest_point(a, b, c, Point{3, -1, 1}).point, b);
+    EXPECT_EQ(closest_point(a, b, c, Point{-1, 3, -1}).bary, (Point{0, 0, 1}));
+}
+
+TEST(TriClosestRegions, RandomQueriesMatchReference) {
+    JMath::seed_random(15);
+    int seen[7] = {0};
+    for (int t = 0; t < 20000; t++) {
+        Point a, b, c, q;
+        for (int j = 0; j < 3; j++) {
+            a[j] = JMath::random_value<double>(-1, 1);
+            b[j] = JMath::random_value<double>(-1, 1);
+            c[j] = JMath::random_value<double>(-1, 1);
+            q[j] = JMath::random_value<double>(-2, 2);
+        }
+        auto r = closest_point(a, b, c, q);
+        ASSERT_LT(r.feature, 7);
+        seen[r.feature]++;
+        EXPECT_NEAR(r.dist2, ReferenceDist2(a, b, c, q), EPSILON);
+
+        // The weights agree with the feature
+        switch (r.feature) {
+        case FEATURE_VERTEX_A: EXPECT_EQ(r.point, a); break;
+        case FEATURE_VERTEX_B: EXPECT_EQ(r.point, b); break;
+        case FEATURE_VERTEX_C: EXPECT_EQ(r.point, c); break;
+        case FEATURE_EDGE_AB:  EXPECT_EQ(r.bary[2], 0.0); break;
+        case FEATURE_EDGE_AC:  EXPECT_EQ(r.bary[1], 0.0); break;
+        case FEATURE_EDGE_BC:  EXPECT_NEAR(r.bary[0], 0.0, EPSILON); break;
+        default:
+            for (int k = 0; k < 3; k++) EXPECT_GE(r.bary[k], -EPSILON);
+        }
+    }
+    for (int f = 0; f < 7; f++) EXPECT_GT(seen[f], 0) << f;
+}
+
+TEST(TriClosestRegions, DegenerateTriangles) {
+    // Collinear corners and a repeated corner still give the nearest point
+    Point a = {0, 0, 0}, b = {1, 0, 0}, c = {2, 0, 0};
+    for (Point q : {Point{1.5, 1, 0}, Point{-1, 0, 1}, Point{3, 2, 0}, Point{0.5, 0, 0}}) {
+        auto r = closest_point(a, b, c, q);
+        EXPECT_NEAR(r.dist2, ReferenceDist2(a, b, c, q), EPSILON);
+        auto s = closest_point(a, b, b, q);
+        EXPECT_NEAR(s.dist2, ReferenceDist2(a, b, b, q), EPSILON);
+    }
+}
+
+TEST(TriClosestRegions, TiesFollowEricsonOrder) {
+    // c is the midpoint of ab, so q is in both the AB and the C region;
+    // Ericson tests AB first
+    Point a = {0, 0, 0}, b = {2, 0, 0}, c = {1, 0, 0}, q = {1, 1, 0};
+    auto r = closest_point(a, b, c, q);
+    EXPECT_EQ(r.feature, FEATURE_EDGE_AB);
+    EXPECT_NEAR(r.dist2, 1, EPSILON);
+}
+
+// ============================================================================
+// Batched Tests
+// ============================================================================
+
+template<class T>
+void CheckBatch(size_t n) {
+    JMath::seed_random(16);
+    TriangleBatch<T> batch;
+    std::vector<T> qx(n), qy(n), qz(n);
+    for (size_t i = 0; i < n; i++) {
+        std::array<T, 3> p[3];
+        for (int k = 0; k < 3; k++)
+            for (int j = 0; j < 3; j++) p[k][j] = JMath::random_value<T>(-10, 10);
+        batch.push_back(p[0], p[1], p[2]);
+        qx[i] = JMath::random_value<T>(-20, 20);
+        qy[i] = JMath::random_value<T>(-20, 20);
+        qz[i] = JMath::random_value<T>(-20, 20);
+    }
+
+    std::vector<T> d(n), x(n), y(n), z(n), d1(n), x1(n);
+    std::vector<uint8_t> f(n), f1(n);
+    closest_point(batch, qx.data(), qy.data(), qz.data(), d.data(), x.data(), y.data(),
+                  z.data(), f.data());
+
+    // Same triangle for all points; only some outputs requested
+    auto a = batch.vertex(0, 0), b = batch.vertex(0, 1), c = batch.vertex(0, 2);
+    closest_point(a, b, c, n, qx.data(), qy.data(), qz.data(), d1.data(), x1.data(),
+                  nullptr, nullptr, f1.data());
+
+    for (size_t i = 0; i < n; i++) {
+        std::array<T, 3> q = {qx[i], qy[i], qz[i]};
+        auto r = closest_point(batch.vertex(i, 0), batch.vertex(i, 1), batch.vertex(i, 2), q);
+        EXPECT_EQ(d[i], r.dist2);
+        EXPECT_EQ(x[i], r.point[0]);
+        EXPECT_EQ(y[i], r.point[1]);
+        EXPECT_EQ(z[i], r.point[2]);
+        EXPECT_EQ(f[i], r.feature);
+
+        auto s = closest_point(a, b, c, q);
+        EXPECT_EQ(d1[i], s.dist2);
+        EXPECT_EQ(x1[i], s.point[0]);
+        EXPECT_EQ(f1[i], s.feature);
+    }
+}
+
+TEST(TriClosestBatch, MatchesScalarDouble) { CheckBatch<double>(1000); }
+TEST(TriClosestBatch, MatchesScalarFloat)  { CheckBatch<float>(1000); }
+
+TEST(TriClosestBatch, DistanceOnly) {
+    TriangleBatch<double> batch;
+    batch.push_back(Point{0, 0, 0}, Point{1, 0, 0}, Point{0, 1, 0});
+    batch.push_back(Point{0, 0, 1}, Point{1, 0, 1}, Point{0, 1, 1});
+    double qx[2] = {0.25, 2}, qy[2] = {0.25, 0}, qz[2] = {-2, 1}, d[2];
+    closest_point(batch, qx, qy, qz, d, nullptr, nullptr, nullptr, nullptr);
+    EXPECT_NEAR(d[0], 4.0, EPSILON);
+    EXPECT_NEAR(d[1], 1.0, EPSILON);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
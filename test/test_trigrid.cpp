@@ -0,0 +1,191 @@
+#include <gtest/gtest.h>
+#include "../trigrid.hpp"
+#include "grid_mesh.hpp"
+#include <cmath>
+
+const double EPSILON = 1e-6;
+
+// Weights of q in face f, computed with trilib's area-based barycoordinates
+std::array<double, 3> AreaWeights(const IndexedMeshView<double> &mesh, int f, double x, double y) {
+    auto a = JMath::to_array(mesh.corner(f, 0));
+    auto b = JMath::to_array(mesh.corner(f, 1));
+    auto c = JMath::to_array(mesh.corner(f, 2));
+    return barycoordinates(a, b, c, std::array<double, 3>{x, y, 0.0});
+}
+
+// ============================================================================
+// Location Tests
+// ============================================================================
+
+TEST(TriGridLocate, FindsContainingFace) {
+    GridMesh<> pm(20, 0.3, 0, 1);
+    auto mesh = pm.view();
+    TriangleGrid<double> grid(mesh);
+    EXPECT_GT(grid.nx()*grid.ny(), 0);
+    EXPECT_EQ(grid.cell_offsets().back(), grid.cell_faces().size());
+
+    JMath::seed_random(10);
+    for (int t = 0; t < 2000; t++) {
+        double x = JMath::random_value<double>(0, 20), y = JMath::random_value<double>(0, 20);
+        auto loc = grid.locate(x, y);
+        ASSERT_GE(loc.face, 0) << x << " " << y;
+
+        auto w = AreaWeights(mesh, loc.face, x, y);
+        for (int k = 0; k < 3; k++) EXPECT_NEAR(loc.bary[k], w[k], EPSILON);
+        EXPECT_NEAR(loc.bary[0] + loc.bary[1] + loc.bary[2], 1.0, EPSILON);
+    }
+}
+
+TEST(TriGridLocate, AccurateFarFromOrigin) {
+    // Float mesh with 0.01 spacing, shifted away from the origin
+    GridMesh<> pm(20, 0.3, 0, 3);
+    for (double offset : {0.0, 100.0, 1000.0}) {
+        SCOPED_TRACE(offset);
+        std::vector<float> xyz(pm.xyz.size());
+        for (size_t i = 0; i < xyz.size(); i++) xyz[i] = (float)(offset + 0.01*pm.xyz[i]);
+        IndexedMeshView<float> mesh(xyz.data(), xyz.size()/3, pm.ids.data(), pm.ids.size()/3);
+        TriangleGrid<float> grid(mesh);
+
+        JMath::seed_random(11);
+        double maxerr = 0;
+        for (int t = 0; t < 2000; t++) {
+            float x = (float)(offset + JMath::random_value<double>(0.001, 0.199));
+            float y = (float)(offset + JMath::random_value<double>(0.001, 0.199));
+            auto loc = grid.locate(x, y);
+            ASSERT_GE(loc.face, 0);
+
+            // Exact weights of the float query in the float face
+            double px[3], py[3];
+            for (int k = 0; k < 3; k++) {
+                px[k] = mesh.corner(loc.face, k)[0];
+                py[k] = mesh.corner(loc.face, k)[1];
+            }
+            double det = (px[1] - px[0])*(py[2] - py[0]) - (px[2] - px[0])*(py[1] - py[0]);
+            double l1  = ((x - px[0])*(py[2] - py[0]) - (px[2] - px[0])*(y - py[0]))/det;
+            double l2  = ((px[1] - px[0])*(y - py[0]) - (x - px[0])*(py[1] - py[0]))/det;
+            maxerr = std::max({maxerr, std::fabs(loc.bary[1] - l1), std::fabs(loc.bary[2] - l2)});
+        }
+        EXPECT_LT(maxerr, 1e-5);
+    }
+}
+
+TEST(TriGridLocate, OutsidePointsAndSharedEdges) {
+    GridMesh<> pm(4, 0.0, 0, 2);
+    auto mesh = pm.view();
+    TriangleGrid<double> grid(mesh);
+
+    EXPECT_EQ(grid.locate(-0.5, 1.0).face, -1);
+    EXPECT_EQ(grid.locate(4.5, 4.5).face, -1);
+    EXPECT_EQ(grid.locate(2.0, 9.0).face, -1);
+
+    // On the diagonal shared by faces 0 and 1: the lower id wins
+    auto loc = grid.locate(0.5, 0.5);
+    EXPECT_EQ(loc.face, 0);
+    EXPECT_NEAR(loc.bary[1], 0.0, EPSILON);
+
+    // Grid vertex shared by six faces, and the outer corner
+    EXPECT_GE(grid.locate(2.0, 2.0).face, 0);
+    EXPECT_EQ(grid.locate(4.0, 4.0).face, 2*(3*4 + 3));
+}
+
+TEST(TriGridLocate, ProjectionAxisAndPointOverload) {
+    // One triangle in the xz plane, located through 3D points
+    std::vector<float> xyz = {0, 5, 0, 2, 5, 0, 0, 5, 2};
+    std::vector<int> ids = {0, 1, 2};
+    IndexedMeshView<float> mesh(xyz.data(), 3, ids.data(), 1);
+    TriangleGrid<float> grid(mesh, 1);
+
+    // Kept coordinates for axis 1 are (z, x)
+    auto loc = grid.locate(std::array<float, 3>{0.5f, -100.0f, 1.0f});
+    ASSERT_EQ(loc.face, 0);
+    EXPECT_NEAR(loc.bary[1], 0.25f, 1e-6f);
+    EXPECT_NEAR(loc.bary[2], 0.5f, 1e-6f);
+    EXPECT_EQ(grid.locate(std::array<float, 3>{1.5f, 0.0f, 1.5f}).face, -1);
+}
+
+TEST(TriGridLocate, DegenerateFacesSkipped) {
+    TriangleBatch<double> batch;
+    batch.push_back(std::array<double, 3>{0, 0, 0}, std::array<double, 3>{1, 0, 0},
+                    std::array<double, 3>{2, 0, 0});
+    batch.push_back(std::array<double, 3>{0, 0, 0}, std::array<double, 3>{2, 0, 0},
+                    std::array<double, 3>{0, 2, 0});
+    TriangleGrid<double> grid(batch);
+    EXPECT_EQ(grid.locate(1.0, 0.0).face, 1);
+    EXPECT_EQ(grid.locate(0.5, 0.5).face, 1);
+
+    TriangleBatch<double> none;
+    TriangleGrid<double> empty(none);
+    EXPECT_EQ(empty.locate(0.0, 0.0).face, -1);
+}
+
+// ============================================================================
+// Batched and Update Tests
+// ============================================================================
+
+TEST(TriGridBatch, ParallelMatchesScalar) {
+    GridMesh<> pm(50, 0.3, 0, 3);
+    TriangleGrid<double> grid(pm.view());
+
+    const size_t n = 20000;
+    std::vector<double> qx(n), qy(n), l0(n), l1(n), l2(n), p0(n), p1(n), p2(n);
+    std::vector<int> face(n), pface(n);
+    JMath::seed_random(30);
+    for (size_t i = 0; i < n; i++) {
+        qx[i] = JMath::random_value<double>(-1, 51);
+        qy[i] = JMath::random_value<double>(-1, 51);
+    }
+    grid.locate(n, qx.data(), qy.data(), face.data(), l0.data(), l1.data(), l2.data());
+
+    JMath::ThreadPool pool(4);
+    grid.locate(pool, n, qx.data(), qy.data(), pface.data(), p0.data(), p1.data(), p2.data());
+
+    int outside = 0;
+    for (size_t i = 0; i < n; i++) {
+        auto loc = grid.locate(qx[i], qy[i]);
+        EXPECT_EQ(face[i], loc.face);
+        EXPECT_EQ(pface[i], loc.face);
+        EXPECT_EQ(l1[i], loc.bary[1]);
+        EXPECT_EQ(p2[i], loc.bary[2]);
+        bool inside = qx[i] >= 0 && qx[i] <= 50 && qy[i] >= 0 && qy[i] <= 50;
+        EXPECT_EQ(loc.face >= 0, inside);
+        outside += loc.face < 0;
+    }
+    EXPECT_GT(outside, 0);
+}
+
+TEST(TriGridUpdate, SmallMovesKeepFaceLists) {
+    GridMesh<> pm(30, 0.2, 0, 4);
+    auto mesh = pm.view();
+    TriangleGrid<double> grid(mesh);
+    auto members = grid.cell_faces();
+
+    // Nudge interior vertices by far less than a cell
+    for (size_t v = 0; v < pm.xyz.size()/3; v++) {
+        double x = pm.xyz[3*v], y = pm.xyz[3*v + 1];
+        if (x > 0 && x < 30 && y > 0 && y < 30) {
+            pm.xyz[3*v] += 1e-9;
+            pm.xyz[3*v + 1] -= 1e-9;
+        }
+    }
+    EXPECT_FALSE(grid.update(mesh));
+    EXPECT_EQ(grid.cell_faces(), members);
+
+    // Large moves rebuild the lists and locate against the new positions
+    for (size_t v = 0; v < pm.xyz.size()/3; v++) pm.xyz[3*v] *= 1.5;
+    EXPECT_TRUE(grid.update(mesh));
+
+    JMath::seed_random(40);
+    for (int t = 0; t < 1000; t++) {
+        double x = JMath::random_value<double>(0, 45), y = JMath::random_value<double>(0, 30);
+        auto loc = grid.locate(x, y);
+        ASSERT_GE(loc.face, 0);
+        auto w = AreaWeights(mesh, loc.face, x, y);
+        for (int k = 0; k < 3; k++) EXPECT_NEAR(loc.bary[k], w[k], EPSILON);
+    }
+    EXPECT_EQ(grid.locate(44.0, 45.0).face, -1);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
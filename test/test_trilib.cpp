@@ -123,6 +123,110 @@ TEST(TriLibAngles, MinAngle) {
     EXPECT_GT(angle, 0.0);
 }
 
+TEST(TriLibAngles, UnitTagsMatchRuntimeMeasure) {
+    std::array<double, 3> p1 = {0.3, -1.0, 2.0};
+    std::array<double, 3> p2 = {2.5, 0.5, 1.0};
+    std::array<double, 3> p3 = {-0.5, 1.5, 0.0};
+
+    EXPECT_EQ(angles(p1, p2, p3, Degrees()), angles(p1, p2, p3, ANGLE_IN_DEGREES));
+    EXPECT_EQ(angles(p1, p2, p3, Radians()), angles(p1, p2, p3, ANGLE_IN_RADIANS));
+    EXPECT_EQ(angles(p1, p2, p3), angles(p1, p2, p3, ANGLE_IN_DEGREES));
+    EXPECT_EQ(angleAt(p1, p2, p3, Radians()), angleAt(p1, p2, p3, ANGLE_IN_RADIANS));
+    EXPECT_EQ(maxangle(p1, p2, p3, Degrees()), maxangle(p1, p2, p3, ANGLE_IN_DEGREES));
+    EXPECT_EQ(minangle(p1, p2, p3, Radians()), minangle(p1, p2, p3, ANGLE_IN_RADIANS));
+}
+
+TEST(TriLibAngles, CosineUnit) {
+    std::array<double, 3> p1 = {0.0, 0.0, 0.0};
+    std::array<double, 3> p2 = {3.0, 0.0, 0.0};
+    std::array<double, 3> p3 = {0.0, 4.0, 0.0};
+
+    auto c = angles(p1, p2, p3, Cosine());
+    auto r = angles(p1, p2, p3, Radians());
+    for (int i = 0; i < 3; i++) EXPECT_NEAR(c[i], std::cos(r[i]), EPSILON);
+    EXPECT_NEAR(c[0], 0.0, EPSILON);
+    EXPECT_NEAR(angleAt(p2, p3, p1, Cosine()), 0.6, EPSILON);
+
+    // Same corners as the angle forms; the largest angle has the smallest cosine
+    auto [cmax, imax] = maxangle(p1, p2, p3, Cosine());
+    auto [cmin, imin] = minangle(p1, p2, p3, Cosine());
+    EXPECT_EQ(imax, maxangle(p1, p2, p3).second);
+    EXPECT_EQ(imin, minangle(p1, p2, p3).second);
+    EXPECT_LT(cmax, cmin);
+    EXPECT_NEAR(cmin, 0.8, EPSILON);
+}
+
+TEST(TriLibAngles, PrecisionPolicies) {
+    JMath::seed_random(18);
+    int redone = 0;
+    for (int t = 0; t < 2000; t++) {
+        // Every fourth triangle is a needle, with p3 close to p1
+        const bool needle = t % 4 == 0;
+        std::array<float, 3> p1, p2, p3;
+        for (int j = 0; j < 3; j++) {
+            p1[j] = JMath::random_value<float>(-1, 1);
+            p2[j] = JMath::random_value<float>(-1, 1);
+            p3[j] = p1[j] + (needle ? 1e-3f : 1.0f)*JMath::random_value<float>(-1, 1);
+        }
+        auto ref    = angles(p1, p2, p3, Radians());
+        auto native = angles(p1, p2, p3, Radians(), NativePrecision());
+        auto mixed  = angles(p1, p2, p3, Radians(), MixedPrecision());
+        for (int i = 0; i < 3; i++) EXPECT_NEAR(mixed[i], ref[i], MIXED_ANGLE_TOLERANCE);
+        if (mixed != native) {
+            EXPECT_EQ(mixed, ref);
+            redone++;
+        }
+
+        auto lo = minangle(p1, p2, p3, Radians(), MixedPrecision());
+        EXPECT_EQ(lo.second, minangle(p1, p2, p3, Radians()).second);
+        EXPECT_NEAR(lo.first, minangle(p1, p2, p3, Radians()).first, MIXED_ANGLE_TOLERANCE);
+        EXPECT_NEAR(maxangle(p1, p2, p3, Degrees(), MixedPrecision()).first,
+                    maxangle(p1, p2, p3).first, 180/M_PI*MIXED_ANGLE_TOLERANCE);
+        if (!needle) {
+            EXPECT_NEAR(angleAt(p2, p3, p1, Cosine(), NativePrecision()), angleAt(p2, p3, p1, Cosine()), 1e-4);
+        }
+    }
+    // Only the needles go back to double
+    EXPECT_GT(redone, 0);
+    EXPECT_LT(redone, 1000);
+
+    // Double points give the same result under every policy
+    std::array<double, 3> d1 = {0.3, -1.0, 2.0}, d2 = {2.5, 0.5, 1.0}, d3 = {-0.5, 1.5, 0.0};
+    EXPECT_EQ(angles(d1, d2, d3, Degrees(), MixedPrecision()), angles(d1, d2, d3));
+    EXPECT_EQ(minangle(d1, d2, d3, Degrees(), NativePrecision()), minangle(d1, d2, d3));
+}
+
+// Angle at corner a from the exact float coordinates, in long double
+long double ReferenceAngle(const std::array<float, 3> &a, const std::array<float, 3> &b,
+                           const std::array<float, 3> &c) {
+    long double u[3], v[3];
+    for (int j = 0; j < 3; j++) {
+        u[j] = (long double)b[j] - a[j];
+        v[j] = (long double)c[j] - a[j];
+    }
+    long double cx = u[1]*v[2] - u[2]*v[1], cy = u[2]*v[0] - u[0]*v[2], cz = u[0]*v[1] - u[1]*v[0];
+    return atan2l(sqrtl(cx*cx + cy*cy + cz*cz), u[0]*v[0] + u[1]*v[1] + u[2]*v[2]);
+}
+
+TEST(TriLibAngles, FloatSliverKeepsDoublePrecision) {
+    JMath::seed_random(19);
+    for (int t = 0; t < 500; t++) {
+        // p3 lies within 1e-4 of the segment p1 p2, so its angle is close to pi
+        std::array<float, 3> p1, p2, p3;
+        float s = JMath::random_value<float>(0.2f, 0.8f);
+        for (int j = 0; j < 3; j++) {
+            p1[j] = JMath::random_value<float>(-1, 1);
+            p2[j] = JMath::random_value<float>(-1, 1);
+            p3[j] = p1[j] + s*(p2[j] - p1[j]) + JMath::random_value<float>(-1e-4f, 1e-4f);
+        }
+        const double ref = ReferenceAngle(p3, p1, p2);
+        EXPECT_NEAR(angleAt(p3, p1, p2, Radians(), DoublePrecision()), ref, 1e-6);
+        EXPECT_NEAR(angleAt(p3, p1, p2, Radians(), MixedPrecision()), ref, MIXED_ANGLE_TOLERANCE);
+        EXPECT_NEAR(maxangle(p1, p2, p3, Radians(), MixedPrecision()).first, ref, MIXED_ANGLE_TOLERANCE);
+        EXPECT_NEAR(angles(p1, p2, p3, Radians(), MixedPrecision())[2], ref, MIXED_ANGLE_TOLERANCE);
+    }
+}
+
 // ============================================================================
 // Triangle Classification Tests
 // ============================================================================
@@ -156,6 +260,19 @@ TEST(TriLibClassification, IsRightTriangle) {
     EXPECT_FALSE(isObtuse(p1, p2, p3));
 }
 
+TEST(TriLibClassification, CoincidentVerticesAreNotAcute) {
+    // The angles are undefined, so neither test holds
+    std::array<double, 3> p1 = {0.0, 0.0, 0.0};
+    std::array<double, 3> p2 = {1.0, 0.0, 0.0};
+
+    EXPECT_FALSE(isAcute(p1, p1, p2));
+    EXPECT_FALSE(isAcute(p1, p2, p2));
+    EXPECT_FALSE(isAcute(p2, p1, p2));
+    EXPECT_FALSE(isAcute(p1, p1, p1));
+    EXPECT_FALSE(isObtuse(p1, p1, p2));
+    EXPECT_FALSE(isObtuse(p1, p1, p1));
+}
+
 TEST(TriLibClassification, IsDegenerateTriangle) {
     // Collinear points - degenerate
     std::array<double, 3> p1 = {0.0, 0.0, 0.0};
@@ -392,6 +509,62 @@ TEST(TriLibTemplates, IntegerType) {
     EXPECT_EQ(minLen, 3);
 }
 
+TEST(TriLibTemplates, ExplicitCoordinateType) {
+    std::array<double, 3> p1 = {0.0, 0.0, 0.0};
+    std::array<double, 3> p2 = {3.0, 0.0, 0.0};
+    std::array<double, 3> p3 = {0.0, 4.0, 0.0};
+
+    EXPECT_NEAR(area<double>(p1, p2, p3), 6.0, EPSILON);
+    EXPECT_NEAR(maxlength<double>(p1, p2, p3), 5.0, EPSILON);
+    EXPECT_NEAR(maxangle<double>(p1, p2, p3).first, 90.0, EPSILON);
+    EXPECT_NEAR(angleAt<double>(p1, p2, p3, ANGLE_IN_RADIANS), M_PI/2, EPSILON);
+    EXPECT_EQ(angles<double>(p1, p2, p3), angles(p1, p2, p3));
+    EXPECT_NEAR(circumradius<double>(p1, p2, p3), 2.5, EPSILON);
+    EXPECT_NEAR(inradius<double>(p1, p2, p3), 1.0, EPSILON);
+    EXPECT_TRUE(isAcute<double>(p1, p2, p3) == isAcute(p1, p2, p3));
+    EXPECT_EQ(barycoordinates<double>(p1, p2, p3, p1), barycoordinates(p1, p2, p3, p1));
+}
+
+// ============================================================================
+// Point Adapter Tests (raw arrays and strided views instead of std::array)
+// ============================================================================
+
+TEST(TriLibPointAdapters, RawArrayTriangle) {
+    double p1[3] = {0.0, 0.0, 0.0};
+    double p2[3] = {3.0, 0.0, 0.0};
+    double p3[3] = {0.0, 4.0, 0.0};
+
+    EXPECT_NEAR(area(p1, p2, p3), 6.0, EPSILON);
+    EXPECT_NEAR(circumradius(p1, p2, p3), 2.5, EPSILON);
+    EXPECT_NEAR(maxangle(p1, p2, p3).first, 90.0, EPSILON);
+    EXPECT_TRUE(CompareArrays(centroid(p1, p2, p3), {1.0, 4.0/3.0, 0.0}));
+}
+
+TEST(TriLibPointAdapters, StridedVertexBuffer) {
+    // position + normal, 6 doubles per vertex
+    std::vector<double> buffer = {
+        0.0, 0.0, 0.0,  0.0, 0.0, 1.0,
+        4.0, 0.0, 0.0,  0.0, 0.0, 1.0,
+        0.0, 3.0, 0.0,  0.0, 0.0, 1.0
+    };
+    JMath::StridedView<double> v(buffer.data(), 3, 6 * sizeof(double));
+
+    std::array<double, 3> a1 = {0.0, 0.0, 0.0};
+    std::array<double, 3> a2 = {4.0, 0.0, 0.0};
+    std::array<double, 3> a3 = {0.0, 3.0, 0.0};
+
+    EXPECT_EQ(area(v[0], v[1], v[2]), area(a1, a2, a3));
+    EXPECT_EQ(angles(v[0], v[1], v[2]), angles(a1, a2, a3));
+    EXPECT_EQ(normal(v[0], v[1], v[2]), normal(a1, a2, a3));
+    EXPECT_EQ(incenter(v[0], v[1], v[2]), incenter(a1, a2, a3));
+    EXPECT_EQ(inradius(v[0], v[1], v[2]), inradius(a1, a2, a3));
+
+    // The query point may be a different point type than the corners
+    std::array<double, 3> q = {1.0, 1.0, 0.0};
+    auto bary = barycoordinates(v[0], v[1], v[2], q);
+    EXPECT_NEAR(bary[0] + bary[1] + bary[2], 1.0, EPSILON);
+}
+
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
@@ -0,0 +1,206 @@
+#include <gtest/gtest.h>
+#include "../trimesh.hpp"
+#include <cmath>
+#include <vector>
+#include <cstring>
+
+const double EPSILON = 1e-6;
+
+// Unit square split into two right triangles plus an apex above it
+struct SmallMesh {
+    std::vector<double> xyz = {
+        0.0, 0.0, 0.0,
+        1.0, 0.0, 0.0,
+        1.0, 1.0, 0.0,
+        0.0, 1.0, 0.0,
+        0.5, 0.5, 2.0
+    };
+    std::vector<int> faces = {
+        0, 1, 2,
+        0, 2, 3,
+        0, 1, 4,
+        1, 2, 4
+    };
+    IndexedMeshView<double> view() const {
+        return IndexedMeshView<double>(xyz.data(), xyz.size() / 3, faces.data(), faces.size() / 3);
+    }
+};
+
+static std::array<double, 3> Vertex(const SmallMesh& m, int i) {
+    return { m.xyz[3*i], m.xyz[3*i+1], m.xyz[3*i+2] };
+}
+
+// ============================================================================
+// View Tests
+// ============================================================================
+
+TEST(TriMeshView, SizesAndAccess) {
+    SmallMesh m;
+    auto mesh = m.view();
+
+    EXPECT_EQ(mesh.nvertices(), 5u);
+    EXPECT_EQ(mesh.nfaces(), 4u);
+    EXPECT_EQ(mesh.face(1), (std::array<int, 3>{0, 2, 3}));
+    EXPECT_EQ(JMath::to_array(mesh.vertex(4)), Vertex(m, 4));
+    EXPECT_EQ(JMath::to_array(mesh.corner(3, 2)), Vertex(m, 4));
+}
+
+TEST(TriMeshView, ReadsVerticesInPlace) {
+    SmallMesh m;
+    auto mesh = m.view();
+
+    // The view aliases the caller's buffer, so edits are visible immediately
+    m.xyz[7] = 2.0;
+    EXPECT_NEAR(area(mesh, 0), 1.0, EPSILON);
+}
+
+TEST(TriMeshView, StridedUnalignedBuffers) {
+    SmallMesh m;
+
+    // Interleaved float vertices (position, normal, uv = 32 bytes) and
+    // PLY-style face records (uchar count + int[3] = 13 bytes, unaligned)
+    std::vector<float> interleaved(8 * 5, -1.0f);
+    for (int i = 0; i < 5; i++)
+        for (int j = 0; j < 3; j++) interleaved[8*i + j] = (float)m.xyz[3*i + j];
+
+    std::vector<unsigned char> records(13 * 4);
+    for (int f = 0; f < 4; f++) {
+        records[13*f] = 3;
+        memcpy(&records[13*f + 1], &m.faces[3*f], 3 * sizeof(int));
+    }
+
+    IndexedMeshView<float> strided(interleaved.data(), 5, 8 * sizeof(float),
+                                   records.data() + 1, 4, 13);
+    auto mesh = m.view();
+
+    EXPECT_EQ(strided.face(3), mesh.face(3));
+    for (size_t f = 0; f < 4; f++) {
+        EXPECT_NEAR(area(strided, f), area(mesh, f), 1e-6);
+        EXPECT_NEAR(maxangle(strided, f).first, maxangle(mesh, f).first, 1e-4);
+    }
+}
+
+// ============================================================================
+// Per-Face Evaluator Tests
+// ============================================================================
+
+TEST(TriMeshFace, MatchesGatheredScalarCalls) {
+    SmallMesh m;
+    auto mesh = m.view();
+
+    for (size_t f = 0; f < mesh.nfaces(); f++) {
+        auto ids = mesh.face(f);
+        auto pa = Vertex(m, ids[0]), pb = Vertex(m, ids[1]), pc = Vertex(m, ids[2]);
+
+        EXPECT_EQ(area(mesh, f), area(pa, pb, pc));
+        EXPECT_EQ(minlength(mesh, f), minlength(pa, pb, pc));
+        EXPECT_EQ(maxlength(mesh, f), maxlength(pa, pb, pc));
+        EXPECT_EQ(circumradius(mesh, f), circumradius(pa, pb, pc));
+        EXPECT_EQ(inradius(mesh, f), inradius(pa, pb, pc));
+        EXPECT_EQ(angles(mesh, f), angles(pa, pb, pc));
+        EXPECT_EQ(maxangle(mesh, f), maxangle(pa, pb, pc));
+        EXPECT_EQ(minangle(mesh, f, ANGLE_IN_RADIANS), minangle(pa, pb, pc, ANGLE_IN_RADIANS));
+        EXPECT_EQ(minangle(mesh, f, Cosine()), minangle(pa, pb, pc, Cosine()));
+        EXPECT_EQ(normal(mesh, f), normal(pa, pb, pc));
+        EXPECT_EQ(centroid(mesh, f), centroid(pa, pb, pc));
+        EXPECT_EQ(circumcenter(mesh, f), circumcenter(pa, pb, pc));
+        EXPECT_EQ(incenter(mesh, f), incenter(pa, pb, pc));
+        EXPECT_EQ(isAcute(mesh, f), isAcute(pa, pb, pc));
+        EXPECT_EQ(isObtuse(mesh, f), isObtuse(pa, pb, pc));
+        EXPECT_EQ(isDegenerate(mesh, f), isDegenerate(pa, pb, pc));
+        EXPECT_EQ(angleAt(mesh, f, 1), angleAt(pb, pc, pa));
+    }
+}
+
+TEST(TriMeshFace, RightTriangleCorner) {
+    SmallMesh m;
+    auto mesh = m.view();
+
+    // Face 0 is (0,0)-(1,0)-(1,1): right angle at corner 1
+    EXPECT_NEAR(angleAt(mesh, 0, 1), 90.0, EPSILON);
+    EXPECT_EQ(maxangle(mesh, 0).second, 1);
+    EXPECT_NEAR(area(mesh, 1), 0.5, EPSILON);
+}
+
+TEST(TriMeshFace, BarycentricCoordinates) {
+    SmallMesh m;
+    auto mesh = m.view();
+
+    std::array<double, 3> q = {0.75, 0.25, 0.0};
+    auto bary = barycoordinates(mesh, 0, q);
+    EXPECT_NEAR(bary[0] + bary[1] + bary[2], 1.0, EPSILON);
+    EXPECT_NEAR(bary[0], 0.25, EPSILON);
+}
+
+// ============================================================================
+// Whole-Mesh Evaluator Tests
+// ============================================================================
+
+TEST(TriMeshWhole, ScalarOutputs) {
+    SmallMesh m;
+    auto mesh = m.view();
+    std::vector<double> ar(mesh.nfaces()), rc(mesh.nfaces()), ri(mesh.nfaces());
+    std::vector<double> lmin(mesh.nfaces()), lmax(mesh.nfaces());
+
+    area(mesh, ar.data());
+    circumradius(mesh, rc.data());
+    inradius(mesh, ri.data());
+    minlength(mesh, lmin.data());
+    maxlength(mesh, lmax.data());
+
+    for (size_t f = 0; f < mesh.nfaces(); f++) {
+        EXPECT_EQ(ar[f], area(mesh, f));
+        EXPECT_EQ(rc[f], circumradius(mesh, f));
+        EXPECT_EQ(ri[f], inradius(mesh, f));
+        EXPECT_EQ(lmin[f], minlength(mesh, f));
+        EXPECT_EQ(lmax[f], maxlength(mesh, f));
+    }
+    EXPECT_NEAR(total_area(mesh), ar[0] + ar[1] + ar[2] + ar[3], EPSILON);
+}
+
+TEST(TriMeshWhole, VectorAndAngleOutputs) {
+    SmallMesh m;
+    auto mesh = m.view();
+    size_t n = mesh.nfaces();
+    std::vector<std::array<double, 3>> nrm(n), cen(n), cc(n), ic(n), ang(n);
+    std::vector<std::pair<double, int>> amax(n), amin(n);
+
+    normal(mesh, nrm.data());
+    centroid(mesh, cen.data());
+    circumcenter(mesh, cc.data());
+    incenter(mesh, ic.data());
+    angles(mesh, ang.data(), ANGLE_IN_RADIANS);
+    maxangle(mesh, amax.data());
+    minangle(mesh, amin.data());
+
+    for (size_t f = 0; f < n; f++) {
+        EXPECT_EQ(nrm[f], normal(mesh, f));
+        EXPECT_EQ(cen[f], centroid(mesh, f));
+        EXPECT_EQ(cc[f], circumcenter(mesh, f));
+        EXPECT_EQ(ic[f], incenter(mesh, f));
+        EXPECT_EQ(ang[f], angles(mesh, f, ANGLE_IN_RADIANS));
+        EXPECT_EQ(amax[f], maxangle(mesh, f));
+        EXPECT_EQ(amin[f], minangle(mesh, f));
+    }
+}
+
+TEST(TriMeshWhole, ClassificationOutputs) {
+    SmallMesh m;
+    auto mesh = m.view();
+    bool acute[4], obtuse[4], degenerate[4];
+
+    isAcute(mesh, acute);
+    isObtuse(mesh, obtuse);
+    isDegenerate(mesh, degenerate);
+
+    for (size_t f = 0; f < 4; f++) {
+        EXPECT_EQ(acute[f], isAcute(mesh, f));
+        EXPECT_EQ(obtuse[f], isObtuse(mesh, f));
+        EXPECT_FALSE(degenerate[f]);
+    }
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,230 @@
+#include <gtest/gtest.h>
+#include "../trimeshio.hpp"
+#include "../triquality.hpp"
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+const double EPSILON = 1e-6;
+
+std::string TempPath(const std::string &name) {
+    return ::testing::TempDir() + "trimeshio_" + name;
+}
+
+template<class T>
+void Put(std::string &buf, T value) {
+    buf.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void WriteFile(const std::string &path, const std::string &bytes) {
+    std::ofstream out(path, std::ios::binary);
+    out.write(bytes.data(), bytes.size());
+}
+
+// Square pyramid: 5 vertices, 4 side faces and 2 base faces
+const float PYRAMID_XYZ[5][3] = {{0, 0, 0}, {2, 0, 0}, {2, 2, 0}, {0, 2, 0}, {1, 1, 3}};
+const int   PYRAMID_IDS[6][3] = {{0, 1, 4}, {1, 2, 4}, {2, 3, 4}, {3, 0, 4}, {0, 2, 1}, {0, 3, 2}};
+
+std::string PyramidStl() {
+    std::string buf(80, ' ');
+    Put<uint32_t>(buf, 6);
+    for (auto &f : PYRAMID_IDS) {
+        for (int j = 0; j < 3; j++) Put<float>(buf, 0.0f);
+        for (int k = 0; k < 3; k++)
+            for (int j = 0; j < 3; j++) Put<float>(buf, PYRAMID_XYZ[f[k]][j]);
+        Put<uint16_t>(buf, 0);
+    }
+    return buf;
+}
+
+// Vertices carry a normal and a colour; faces carry a trailing flag byte
+template<class T>
+std::string PyramidPly(const char *type, int quad_face = -1) {
+    std::string buf = std::string("ply\nformat binary_little_endian 1.0\ncomment test\n") +
+        "element vertex 5\nproperty uchar id\nproperty " + type + " x\nproperty " + type +
+        " y\nproperty " + type + " z\nproperty float nx\nproperty uchar red\n"
+        "element face 6\nproperty list uchar int vertex_indices\nproperty uchar flags\n"
+        "element edge 1\nproperty int v1\nproperty int v2\nend_header\n";
+    for (int i = 0; i < 5; i++) {
+        Put<uint8_t>(buf, i);
+        for (int j = 0; j < 3; j++) Put<T>(buf, PYRAMID_XYZ[i][j]);
+        Put<float>(buf, 0.5f);
+        Put<uint8_t>(buf, 200);
+    }
+    for (int f = 0; f < 6; f++) {
+        Put<uint8_t>(buf, f == quad_face ? 4 : 3);
+        for (int k = 0; k < 3; k++) Put<int32_t>(buf, PYRAMID_IDS[f][k]);
+        Put<uint8_t>(buf, 1);
+    }
+    Put<int32_t>(buf, 0);
+    Put<int32_t>(buf, 1);
+    return buf;
+}
+
+double PyramidArea() {
+    return 4*area(std::array<double, 3>{0, 0, 0}, std::array<double, 3>{2, 0, 0},
+                  std::array<double, 3>{1, 1, 3}) + 4.0;
+}
+
+// ============================================================================
+// STL Tests
+// ============================================================================
+
+TEST(TriMeshIOStl, ReadsFacesInPlace) {
+    std::string path = TempPath("pyramid.stl");
+    WriteFile(path, PyramidStl());
+
+    StlFile stl(path);
+    auto mesh = stl.mesh();
+    ASSERT_EQ(mesh.nfaces(), 6u);
+    for (size_t f = 0; f < 6; f++)
+        for (int k = 0; k < 3; k++)
+            for (int j = 0; j < 3; j++)
+                EXPECT_EQ(mesh.corner(f, k)[j], PYRAMID_XYZ[PYRAMID_IDS[f][k]][j]);
+
+    EXPECT_NEAR(total_area(mesh), PyramidArea(), 1e-4);
+    EXPECT_EQ(stl.facet_normal(0)[2], 0.0f);
+}
+
+TEST(TriMeshIOStl, FeedsAnalyzerAndClassifier) {
+    std::string path = TempPath("pyramid2.stl");
+    WriteFile(path, PyramidStl());
+    StlFile stl(path);
+
+    MeshQualityReport report = MeshQualityAnalyzer(2).analyze(stl.mesh());
+    EXPECT_EQ(report.nfaces, 6u);
+    EXPECT_EQ(report.ndegenerate, 0u);
+    EXPECT_NEAR(report.total_area, PyramidArea(), 1e-4);
+
+    uint8_t mask[6];
+    classify(stl.mesh(), mask);
+    EXPECT_EQ(mask[4], TRI_RIGHT);
+}
+
+TEST(TriMeshIOStl, RejectsBadFiles) {
+    std::string path = TempPath("bad.stl");
+
+    WriteFile(path, "solid cube\n  facet normal 0 0 1\n");
+    EXPECT_THROW(StlFile{path}, std::runtime_error);
+
+    std::string truncated = PyramidStl();
+    truncated.resize(truncated.size() - 10);
+    WriteFile(path, truncated);
+    EXPECT_THROW(StlFile{path}, std::runtime_error);
+
+    EXPECT_THROW(StlFile{TempPath("does_not_exist.stl")}, std::runtime_error);
+}
+
+// ============================================================================
+// PLY Tests
+// ============================================================================
+
+TEST(TriMeshIOPly, FloatVerticesWithExtraProperties) {
+    std::string path = TempPath("pyramid.ply");
+    WriteFile(path, PyramidPly<float>("float"));
+
+    PlyFile ply(path);
+    EXPECT_EQ(ply.nvertices(), 5u);
+    EXPECT_EQ(ply.nfaces(), 6u);
+    EXPECT_EQ(ply.coordinate_size(), sizeof(float));
+
+    auto mesh = ply.mesh<float>();
+    for (size_t i = 0; i < 5; i++)
+        for (int j = 0; j < 3; j++) EXPECT_EQ(mesh.vertex(i)[j], PYRAMID_XYZ[i][j]);
+    for (size_t f = 0; f < 6; f++) {
+        auto ids = mesh.face(f);
+        for (int k = 0; k < 3; k++) EXPECT_EQ(ids[k], PYRAMID_IDS[f][k]);
+    }
+    EXPECT_NEAR(total_area(mesh), PyramidArea(), 1e-4);
+    EXPECT_THROW(ply.mesh<double>(), std::runtime_error);
+}
+
+TEST(TriMeshIOPly, DoubleVertices) {
+    std::string path = TempPath("pyramid_d.ply");
+    WriteFile(path, PyramidPly<double>("double"));
+
+    PlyFile ply(path);
+    auto mesh = ply.mesh<double>();
+    EXPECT_NEAR(total_area(mesh), PyramidArea(), EPSILON);
+    EXPECT_NEAR(area(mesh, 4), 2.0, EPSILON);
+}
+
+TEST(TriMeshIOPly, CrlfHeader) {
+    std::string path = TempPath("pyramid_crlf.ply");
+    std::string ply = PyramidPly<float>("float");
+    size_t body = ply.find("end_header\n") + 11;
+    std::string header;
+    for (size_t i = 0; i < body; i++) {
+        if (ply[i] == '\n') header += '\r';
+        header += ply[i];
+    }
+    WriteFile(path, header + ply.substr(body));
+
+    PlyFile crlf(path);
+    EXPECT_EQ(crlf.nvertices(), 5u);
+    EXPECT_EQ(crlf.nfaces(), 6u);
+    EXPECT_NEAR(total_area(crlf.mesh<float>()), PyramidArea(), 1e-4);
+}
+
+TEST(TriMeshIOPly, RejectsUnsupportedFiles) {
+    std::string path = TempPath("bad.ply");
+
+    WriteFile(path, PyramidPly<float>("float", 2));
+    EXPECT_THROW(PlyFile{path}, std::runtime_error);
+
+    std::string ascii = PyramidPly<float>("float");
+    ascii.replace(ascii.find("binary_little_endian"), 20, "ascii");
+    WriteFile(path, ascii);
+    EXPECT_THROW(PlyFile{path}, std::runtime_error);
+
+    std::string truncated = PyramidPly<float>("float");
+    truncated.resize(truncated.size() - 20);
+    WriteFile(path, truncated);
+    EXPECT_THROW(PlyFile{path}, std::runtime_error);
+
+    WriteFile(path, "not a mesh");
+    EXPECT_THROW(PlyFile{path}, std::runtime_error);
+}
+
+// Overwrites index k of face f in a PyramidPly<float> file
+void SetPlyIndex(std::string &buf, int f, int k, int32_t id) {
+    size_t faces = buf.find("end_header\n") + 11 + 5*18;
+    memcpy(&buf[faces + f*14 + 1 + k*4], &id, sizeof(id));
+}
+
+TEST(TriMeshIOPly, RejectsBadFaceIndices) {
+    std::string path = TempPath("bad_index.ply");
+
+    std::string ply = PyramidPly<float>("float");
+    SetPlyIndex(ply, 3, 2, 5);
+    WriteFile(path, ply);
+    EXPECT_THROW(PlyFile{path}, std::runtime_error);
+
+    ply = PyramidPly<float>("float");
+    SetPlyIndex(ply, 5, 1, -1);
+    WriteFile(path, ply);
+    EXPECT_THROW(PlyFile{path}, std::runtime_error);
+
+    SetPlyIndex(ply, 5, 1, 4);
+    WriteFile(path, ply);
+    EXPECT_NO_THROW(PlyFile{path});
+}
+
+TEST(TriMeshIOPly, RejectsMalformedHeaders) {
+    std::string path = TempPath("bad_header.ply");
+
+    std::string ply = PyramidPly<float>("float");
+    ply.replace(ply.find("property uchar red"), 18, "property list uchar int red");
+    WriteFile(path, ply);
+    EXPECT_THROW(PlyFile{path}, std::runtime_error);
+
+    ply = PyramidPly<float>("float");
+    ply.replace(ply.find("element edge 1"), 14, "element edge 4611686018427387904");
+    WriteFile(path, ply);
+    EXPECT_THROW(PlyFile{path}, std::runtime_error);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
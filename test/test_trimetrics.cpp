@@ -0,0 +1,128 @@
+#include <gtest/gtest.h>
+#include "../trimetrics.hpp"
+#include <cmath>
+
+const double EPSILON = 1e-6;
+
+// A handful of triangles covering the usual shapes
+static const std::array<std::array<double,3>,3> kTriangles[] = {
+    {{ {0.0, 0.0, 0.0}, {3.0, 0.0, 0.0}, {0.0, 4.0, 0.0} }},           // right 3-4-5
+    {{ {0.0, 0.0, 0.0}, {2.0, 0.0, 0.0}, {1.0, std::sqrt(3.0), 0.0} }},// equilateral
+    {{ {0.0, 0.0, 0.0}, {2.0, 0.0, 0.0}, {0.5, 0.1, 0.0} }},           // obtuse
+    {{ {1.0, 2.0, 3.0}, {-2.0, 0.5, 1.0}, {0.3, -1.0, 2.5} }}          // general 3D
+};
+
+// ============================================================================
+// Agreement with the individual trilib functions
+// ============================================================================
+
+TEST(TriMetrics, MatchesIndividualFunctions) {
+    for (const auto& t : kTriangles) {
+        const auto& pa = t[0];
+        const auto& pb = t[1];
+        const auto& pc = t[2];
+
+        TriangleMetrics<double> m;
+        m.compute(pa, pb, pc);
+
+        EXPECT_DOUBLE_EQ(m.minlength, minlength(pa, pb, pc));
+        EXPECT_DOUBLE_EQ(m.maxlength, maxlength(pa, pb, pc));
+        EXPECT_DOUBLE_EQ(m.area, area(pa, pb, pc));
+        EXPECT_DOUBLE_EQ(m.circumradius, circumradius(pa, pb, pc));
+        EXPECT_DOUBLE_EQ(m.inradius, inradius(pa, pb, pc));
+
+        auto ang = angles(pa, pb, pc);
+        for (int i = 0; i < 3; i++) EXPECT_DOUBLE_EQ(m.angles[i], ang[i]);
+
+        auto mn = minangle(pa, pb, pc);
+        auto mx = maxangle(pa, pb, pc);
+        EXPECT_DOUBLE_EQ(m.minangle.first, mn.first);
+        EXPECT_EQ(m.minangle.second, mn.second);
+        EXPECT_DOUBLE_EQ(m.maxangle.first, mx.first);
+        EXPECT_EQ(m.maxangle.second, mx.second);
+
+        auto cc = circumcenter(pa, pb, pc);
+        auto ic = incenter(pa, pb, pc);
+        for (int k = 0; k < 3; k++) {
+            EXPECT_NEAR(m.circumcenter[k], cc[k], EPSILON);
+            EXPECT_DOUBLE_EQ(m.incenter[k], ic[k]);
+        }
+    }
+}
+
+TEST(TriMetrics, AnglesInRadians) {
+    std::array<double, 3> p1 = {0.0, 0.0, 0.0};
+    std::array<double, 3> p2 = {1.0, 0.0, 0.0};
+    std::array<double, 3> p3 = {0.0, 1.0, 0.0};
+
+    TriangleMetrics<double> m(METRIC_ANGLES, ANGLE_IN_RADIANS);
+    m.compute(p1, p2, p3);
+
+    EXPECT_NEAR(m.angles[0], M_PI / 2.0, EPSILON);
+    EXPECT_NEAR(m.maxangle.first, M_PI / 2.0, EPSILON);
+    EXPECT_EQ(m.maxangle.second, 0);
+}
+
+TEST(TriMetrics, FloatMatchesIndividualFunctions) {
+    std::array<float, 3> p1 = {0.1f, 0.2f, 0.0f};
+    std::array<float, 3> p2 = {3.0f, 0.4f, 1.0f};
+    std::array<float, 3> p3 = {0.5f, 4.0f, -0.5f};
+
+    TriangleMetrics<float> m;
+    m.compute(p1, p2, p3);
+
+    EXPECT_FLOAT_EQ(m.area, area(p1, p2, p3));
+    EXPECT_FLOAT_EQ(m.inradius, inradius(p1, p2, p3));
+    EXPECT_FLOAT_EQ(m.circumradius, circumradius(p1, p2, p3));
+    EXPECT_FLOAT_EQ(m.angles[1], angles(p1, p2, p3)[1]);
+}
+
+// ============================================================================
+// Metric Selection Tests
+// ============================================================================
+
+TEST(TriMetricsSelection, OnlyRequestedQuantitiesAreComputed) {
+    std::array<double, 3> p1 = {0.0, 0.0, 0.0};
+    std::array<double, 3> p2 = {3.0, 0.0, 0.0};
+    std::array<double, 3> p3 = {0.0, 4.0, 0.0};
+
+    TriangleMetrics<double> m(METRIC_AREA | METRIC_INRADIUS);
+    m.compute(p1, p2, p3);
+
+    EXPECT_TRUE(m.has(METRIC_AREA));
+    EXPECT_FALSE(m.has(METRIC_ANGLES));
+    EXPECT_NEAR(m.area, 6.0, EPSILON);
+    EXPECT_NEAR(m.inradius, 1.0, EPSILON);
+
+    // Unrequested quantities keep their zero initial value
+    EXPECT_EQ(m.circumradius, 0.0);
+    EXPECT_EQ(m.angles[0], 0.0);
+    EXPECT_EQ(m.minlength, 0.0);
+}
+
+TEST(TriMetricsSelection, AnglesOnlySkipsEdgeLengths) {
+    std::array<double, 3> p1 = {0.0, 0.0, 0.0};
+    std::array<double, 3> p2 = {3.0, 0.0, 0.0};
+    std::array<double, 3> p3 = {0.0, 4.0, 0.0};
+
+    TriangleMetrics<double> m(METRIC_ANGLES);
+    m.compute(p1, p2, p3);
+
+    EXPECT_NEAR(m.lengths2[2], 9.0, EPSILON);
+    EXPECT_EQ(m.lengths[2], 0.0);
+    EXPECT_NEAR(m.angles[0] + m.angles[1] + m.angles[2], 180.0, EPSILON);
+}
+
+TEST(TriMetricsSelection, ReuseAcrossTriangles) {
+    TriangleMetrics<double> m(METRIC_LENGTHS);
+    for (const auto& t : kTriangles) {
+        m.compute(t[0], t[1], t[2]);
+        EXPECT_DOUBLE_EQ(m.minlength, minlength(t[0], t[1], t[2]));
+        EXPECT_DOUBLE_EQ(m.maxlength, maxlength(t[0], t[1], t[2]));
+    }
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
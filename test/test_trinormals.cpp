@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+#include "../trinormals.hpp"
+#include "grid_mesh.hpp"
+#include <cmath>
+
+const double EPSILON = 1e-6;
+
+// Unit cube, vertex x + 2y + 4z, faces oriented outwards. Vertex 1 touches
+// one triangle of the z = 0 and y = 0 sides and two of the x = 1 side.
+struct Cube {
+    std::vector<double> xyz;
+    std::vector<int> ids = {0, 2, 3,  0, 3, 1,  4, 5, 7,  4, 7, 6,
+                            0, 1, 5,  0, 5, 4,  2, 6, 7,  2, 7, 3,
+                            0, 4, 6,  0, 6, 2,  1, 3, 7,  1, 7, 5};
+    Cube() {
+        for (int v = 0; v < 8; v++) xyz.insert(xyz.end(), {double(v & 1), double((v >> 1) & 1), double((v >> 2) & 1)});
+        xyz.insert(xyz.end(), {5, 5, 5});    // vertex 8 is in no face
+    }
+    IndexedMeshView<double> view() const { return IndexedMeshView<double>(xyz.data(), 9, ids.data(), 12); }
+};
+
+void ExpectNormal(const std::array<double, 3> &n, double x, double y, double z) {
+    double m = std::sqrt(x*x + y*y + z*z);
+    EXPECT_NEAR(n[0], x/m, EPSILON);
+    EXPECT_NEAR(n[1], y/m, EPSILON);
+    EXPECT_NEAR(n[2], z/m, EPSILON);
+}
+
+// ============================================================================
+// Vertex Corner Tests
+// ============================================================================
+
+TEST(VertexCorners, ListsEveryCornerOnce) {
+    Cube cube;
+    VertexCorners vc(cube.view());
+    ASSERT_EQ(vc.nvertices(), 9u);
+    ASSERT_EQ(vc.corners().size(), 36u);
+
+    const auto &off = vc.corner_offsets();
+    EXPECT_EQ(off[2] - off[1], 4u);     // vertex 1 is in four triangles
+    EXPECT_EQ(off[9] - off[8], 0u);
+    for (size_t v = 0; v < 9; v++)
+        for (uint32_t j = off[v]; j < off[v + 1]; j++) {
+            uint32_t c = vc.corners()[j];
+            EXPECT_EQ(cube.ids[c], (int)v);
+            if (j > off[v]) {
+                EXPECT_LT(vc.corners()[j - 1], c);
+            }
+        }
+}
+
+TEST(VertexCorners, ParallelBuildMatchesSerial) {
+    GridMesh<float> t(150, 0, 1, 3);
+    JMath::ThreadPool pool(4);
+    VertexCorners a(t.view()), b(pool, t.view());
+    EXPECT_EQ(a.corner_offsets(), b.corner_offsets());
+    EXPECT_EQ(a.corners(), b.corners());
+}
+
+// ============================================================================
+// Vertex Normal Tests
+// ============================================================================
+
+TEST(VertexNormals, CubeCorners) {
+    Cube cube;
+    std::vector<std::array<double, 3>> n(9);
+
+    // Angle weighting sees three right angles whatever the triangulation
+    vertex_normals(cube.view(), n.data(), NORMAL_ANGLE_WEIGHTED);
+    ExpectNormal(n[0], -1, -1, -1);
+    ExpectNormal(n[1], 1, -1, -1);
+    ExpectNormal(n[7], 1, 1, 1);
+
+    // Area weighting counts the two triangles of the x = 1 side at vertex 1
+    vertex_normals(cube.view(), n.data(), NORMAL_AREA_WEIGHTED);
+    ExpectNormal(n[0], -1, -1, -1);
+    ExpectNormal(n[1], 2, -1, -1);
+
+    // A vertex in no face has no normal
+    EXPECT_EQ(n[8][0], 0.0);
+    EXPECT_EQ(n[8][1], 0.0);
+    EXPECT_EQ(n[8][2], 0.0);
+}
+
+TEST(VertexNormals, FlatGridPointsUp) {
+    GridMesh<double> t(20, 0, 1, 4);
+    for (size_t v = 0; v < t.nvertices(); v++) t.xyz[3*v + 2] = 7;
+    std::vector<std::array<double, 3>> n(t.nvertices());
+    for (auto w : {NORMAL_AREA_WEIGHTED, NORMAL_ANGLE_WEIGHTED}) {
+        vertex_normals(t.view(), n.data(), w);
+        for (size_t v = 0; v < t.nvertices(); v++) ExpectNormal(n[v], 0, 0, 1);
+    }
+}
+
+TEST(VertexNormals, IndependentOfThreadCount) {
+    GridMesh<float> t(200, 0, 1, 5);
+    VertexCorners vc(t.view());
+    JMath::ThreadPool one(1), four(4);
+    std::vector<std::array<float, 3>> a(t.nvertices()), b(t.nvertices()), c(t.nvertices());
+    for (auto w : {NORMAL_AREA_WEIGHTED, NORMAL_ANGLE_WEIGHTED}) {
+        vertex_normals(t.view(), vc, a.data(), w);
+        vertex_normals(one, t.view(), vc, b.data(), w);
+        vertex_normals(four, t.view(), c.data(), w);
+        EXPECT_EQ(a, b);
+        EXPECT_EQ(a, c);
+        for (auto &n : a) {
+            ASSERT_NEAR(n[0]*n[0] + n[1]*n[1] + n[2]*n[2], 1.0, 1e-5);
+            ASSERT_GT(n[2], 0.0f);
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,198 @@
+#include <gtest/gtest.h>
+#include "../tripredicates.hpp"
+#include <cmath>
+
+const double EPSILON = 1e-6;
+
+typedef std::array<double, 2> P2;
+typedef std::array<double, 3> P3;
+__extension__ typedef __int128 i128;
+
+int Sign(double x) { return (x > 0) - (x < 0); }
+int Sign(i128 x)   { return (x > 0) - (x < 0); }
+
+// Exact determinants of integer coordinates (magnitudes kept small enough
+// for 128 bits)
+i128 Orient2dExact(const i128 *a, const i128 *b, const i128 *c) {
+    return (a[0] - c[0])*(b[1] - c[1]) - (a[1] - c[1])*(b[0] - c[0]);
+}
+
+i128 Orient3dExact(const i128 *a, const i128 *b, const i128 *c, const i128 *d) {
+    i128 adx = a[0] - d[0], ady = a[1] - d[1], adz = a[2] - d[2];
+    i128 bdx = b[0] - d[0], bdy = b[1] - d[1], bdz = b[2] - d[2];
+    i128 cdx = c[0] - d[0], cdy = c[1] - d[1], cdz = c[2] - d[2];
+    return adz*(bdx*cdy - cdx*bdy) + bdz*(cdx*ady - adx*cdy) + cdz*(adx*bdy - bdx*ady);
+}
+
+i128 IncircleExact(const i128 *a, const i128 *b, const i128 *c, const i128 *d) {
+    i128 adx = a[0] - d[0], ady = a[1] - d[1];
+    i128 bdx = b[0] - d[0], bdy = b[1] - d[1];
+    i128 cdx = c[0] - d[0], cdy = c[1] - d[1];
+    return (adx*adx + ady*ady)*(bdx*cdy - cdx*bdy) + (bdx*bdx + bdy*bdy)*(cdx*ady - adx*cdy) +
+           (cdx*cdx + cdy*cdy)*(adx*bdy - bdx*ady);
+}
+
+int64_t RandomInt(int64_t range) {
+    return (int64_t)std::floor(JMath::random_value<double>(-(double)range, (double)range));
+}
+
+// ============================================================================
+// Expansion Arithmetic Tests
+// ============================================================================
+
+TEST(TriExactArithmetic, TwoSumAndProductAreExact) {
+    double x, y;
+    TriExact::two_sum(1.0, 1e-30, x, y);
+    EXPECT_EQ(x, 1.0);
+    EXPECT_EQ(y, 1e-30);
+
+    const double a = 1.0 + std::ldexp(1.0, -30), b = 1.0 - std::ldexp(1.0, -30);
+    TriExact::two_product(a, b, x, y);
+    EXPECT_EQ(x, 1.0);
+    EXPECT_EQ(y, -std::ldexp(1.0, -60));
+
+    // (2^60 + 1) - 2^60 survives as an expansion
+    auto e = TriExact::difference(std::ldexp(1.0, 60), -1.0) - TriExact::difference(std::ldexp(1.0, 60), 0.0);
+    EXPECT_EQ(e.estimate(), 1.0);
+}
+
+// ============================================================================
+// Predicate Tests
+// ============================================================================
+
+TEST(TriPredicates, SimpleSigns) {
+    P2 a = {0, 0}, b = {1, 0}, c = {0, 1};
+    EXPECT_GT(orient2d(a, b, c), 0);
+    EXPECT_LT(orient2d(a, c, b), 0);
+    EXPECT_EQ(orient2d(a, b, P2{2, 0}), 0);
+
+    EXPECT_GT(incircle(a, b, c, P2{0.5, 0.5}), 0);
+    EXPECT_LT(incircle(a, b, c, P2{2, 2}), 0);
+    EXPECT_EQ(incircle(a, b, c, P2{1, 1}), 0);
+
+    P3 p = {0, 0, 0}, q = {1, 0, 0}, r = {0, 1, 0};
+    EXPECT_GT(orient3d(p, q, r, P3{0, 0, -1}), 0);
+    EXPECT_LT(orient3d(p, q, r, P3{0, 0, 1}), 0);
+    EXPECT_EQ(orient3d(p, q, r, P3{5, 7, 0}), 0);
+}
+
+// Shewchuk's example: points within a few ulps of (0.5, 0.5) against the line
+// through (12, 12) and (24, 24), where the naive determinant gets many signs
+// wrong. Coordinates times 2^53 are integers, so the reference is exact.
+TEST(TriPredicates, Orient2dNearLine) {
+    const double ulp = std::ldexp(1.0, -53);
+    const i128 scale = (i128)1 << 53;
+    P2 b = {12, 12}, c = {24, 24};
+    i128 bi[2] = {12*scale, 12*scale}, ci[2] = {24*scale, 24*scale};
+
+    int naive_wrong = 0, zeros = 0;
+    for (int i = 0; i < 64; i++)
+        for (int j = 0; j < 64; j++) {
+            P2 a = {0.5 + i*ulp, 0.5 + j*ulp};
+            i128 ai[2] = {scale/2 + i, scale/2 + j};
+            int expected = Sign(Orient2dExact(ai, bi, ci));
+            ASSERT_EQ(Sign(orient2d(a, b, c)), expected) << i << " " << j;
+            double naive = (a[0] - c[0])*(b[1] - c[1]) - (a[1] - c[1])*(b[0] - c[0]);
+            naive_wrong += Sign(naive) != expected;
+            zeros += expected == 0;
+        }
+    EXPECT_GT(naive_wrong, 0);
+    EXPECT_GT(zeros, 0);
+}
+
+TEST(TriPredicates, Orient3dNearPlane) {
+    // Large integer points near a common plane: products exceed 53 bits
+    JMath::seed_random(16);
+    const int64_t R = (int64_t)1 << 38;
+    int coplanar = 0;
+    for (int t = 0; t < 5000; t++) {
+        i128 p[4][3];
+        for (int k = 0; k < 3; k++)
+            for (int j = 0; j < 2; j++) p[k][j] = RandomInt(R/2);
+        // On the plane z = x + 3y, the last point moved off it by at most 2
+        p[3][0] = RandomInt(R/2);
+        p[3][1] = RandomInt(R/2);
+        for (int k = 0; k < 4; k++) p[k][2] = p[k][0] + 3*p[k][1] + (k == 3 ? RandomInt(2) : 0);
+
+        P3 d[4];
+        for (int k = 0; k < 4; k++)
+            for (int j = 0; j < 3; j++) d[k][j] = (double)p[k][j];
+        int expected = Sign(Orient3dExact(p[0], p[1], p[2], p[3]));
+        ASSERT_EQ(Sign(orient3d(d[0], d[1], d[2], d[3])), expected) << t;
+        coplanar += expected == 0;
+    }
+    EXPECT_GT(coplanar, 0);
+}
+
+TEST(TriPredicates, IncircleNearCircle) {
+    // Integer points on (or next to) a circle of radius 5*2^24 about the
+    // origin, from the Pythagorean triple (3, 4, 5)
+    const int64_t s = (int64_t)1 << 24;
+    i128 base[4][2] = {{3*s, 4*s}, {-4*s, 3*s}, {-3*s, -4*s}, {4*s, -3*s}};
+    int checked = 0;
+    for (int dx = -1; dx <= 1; dx++)
+        for (int dy = -1; dy <= 1; dy++) {
+            i128 p[4][2];
+            std::copy(&base[0][0], &base[0][0] + 8, &p[0][0]);
+            p[3][0] += dx;
+            p[3][1] += dy;
+            P2 d[4];
+            for (int k = 0; k < 4; k++) d[k] = {(double)p[k][0], (double)p[k][1]};
+            int expected = Sign(IncircleExact(p[0], p[1], p[2], p[3]));
+            EXPECT_EQ(Sign(incircle(d[0], d[1], d[2], d[3])), expected) << dx << " " << dy;
+            checked++;
+        }
+    EXPECT_EQ(checked, 9);
+
+    // Random integer quadruples, mostly decided by the filter
+    JMath::seed_random(17);
+    for (int t = 0; t < 5000; t++) {
+        i128 p[4][2];
+        for (int k = 0; k < 4; k++)
+            for (int j = 0; j < 2; j++) p[k][j] = RandomInt((int64_t)1 << 28);
+        P2 d[4];
+        for (int k = 0; k < 4; k++) d[k] = {(double)p[k][0], (double)p[k][1]};
+        ASSERT_EQ(Sign(incircle(d[0], d[1], d[2], d[3])), Sign(IncircleExact(p[0], p[1], p[2], p[3])));
+    }
+}
+
+TEST(TriPredicates, ConsistentUnderPermutation) {
+    JMath::seed_random(18);
+    for (int t = 0; t < 1000; t++) {
+        P2 a = {JMath::random_value<double>(0, 1), JMath::random_value<double>(0, 1)};
+        P2 b = {JMath::random_value<double>(0, 1), JMath::random_value<double>(0, 1)};
+        double s = JMath::random_value<double>(0, 1);
+        P2 c = {a[0] + s*(b[0] - a[0]), a[1] + s*(b[1] - a[1])};   // nearly on ab
+        int o = Sign(orient2d(a, b, c));
+        EXPECT_EQ(Sign(orient2d(b, c, a)), o);
+        EXPECT_EQ(Sign(orient2d(c, a, b)), o);
+        EXPECT_EQ(Sign(orient2d(b, a, c)), -o);
+    }
+}
+
+// ============================================================================
+// Collinearity Tests
+// ============================================================================
+
+TEST(TriPredicates, IsCollinearIsExact) {
+    P3 a = {0, 0, 0}, b = {1, 2, 3}, c = {2, 4, 6};
+    EXPECT_TRUE(isCollinear(a, b, c));
+    EXPECT_TRUE(isCollinear(a, a, b));
+    EXPECT_TRUE(isCollinear(a, a, a));
+
+    // One ulp off the line is not collinear, although far below the
+    // isDegenerate angle threshold
+    P3 d = {2, 4, std::nextafter(6.0, 7.0)};
+    EXPECT_FALSE(isCollinear(a, b, d));
+    EXPECT_TRUE(isDegenerate(a, b, d));
+    EXPECT_FALSE(isCollinear(a, b, P3{0, 1, 0}));
+
+    // Float points, collinear along a line with inexact slope
+    std::array<float, 3> f0 = {0.1f, 0.2f, 0.3f}, f1 = {0.2f, 0.4f, 0.6f}, f2 = {0.4f, 0.8f, 1.2f};
+    EXPECT_TRUE(isCollinear(f0, f1, f2));
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
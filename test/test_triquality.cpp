@@ -0,0 +1,223 @@
+#include <gtest/gtest.h>
+#include "../triquality.hpp"
+#include "grid_mesh.hpp"
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+const double EPSILON = 1e-6;
+
+// Jittered n x n grid plus a repeated-vertex face and a collinear triple
+GridMesh<> DegenerateGrid(int n) {
+    GridMesh<> grid(n, 0.3, 0.1, 77);
+    grid.ids.insert(grid.ids.end(), {0, 0, 1});
+    grid.ids.insert(grid.ids.end(), {0, 1, 2});
+    for (int j = 0; j < 3; j++) grid.xyz[3*2 + j] = 2*grid.xyz[3*1 + j] - grid.xyz[j];
+    return grid;
+}
+
+void ExpectSameReport(const MeshQualityReport &a, const MeshQualityReport &b) {
+    EXPECT_EQ(a.nfaces, b.nfaces);
+    EXPECT_EQ(a.ndegenerate, b.ndegenerate);
+    EXPECT_EQ(std::memcmp(&a.total_area, &b.total_area, sizeof(double)), 0);
+    EXPECT_EQ(a.minangle, b.minangle);
+    EXPECT_EQ(a.minangle_face, b.minangle_face);
+    EXPECT_EQ(a.maxangle, b.maxangle);
+    EXPECT_EQ(a.maxangle_face, b.maxangle_face);
+    EXPECT_EQ(a.max_radius_ratio, b.max_radius_ratio);
+    EXPECT_EQ(a.max_radius_ratio_face, b.max_radius_ratio_face);
+    EXPECT_EQ(a.histogram, b.histogram);
+}
+
+// ============================================================================
+// Thread Pool Tests
+// ============================================================================
+
+TEST(TriQualityThreadPool, VisitsEveryTaskOnce) {
+    JMath::ThreadPool pool(4);
+    EXPECT_EQ(pool.size(), 4u);
+
+    std::vector<std::atomic<int>> hits(1000);
+    pool.parallel_for(hits.size(), [&](size_t i, size_t thread) {
+        EXPECT_LT(thread, pool.size());
+        hits[i]++;
+    });
+    for (auto &h : hits) EXPECT_EQ(h.load(), 1);
+}
+
+TEST(TriQualityThreadPool, NestedLoopRunsInline) {
+    JMath::ThreadPool pool(3);
+    std::atomic<int> count(0);
+    pool.parallel_for(8, [&](size_t, size_t) {
+        pool.parallel_for(8, [&](size_t, size_t) { count++; });
+    });
+    EXPECT_EQ(count.load(), 64);
+}
+
+TEST(TriQualityThreadPool, RethrowsTaskException) {
+    JMath::ThreadPool pool(3);
+    EXPECT_THROW(pool.parallel_for(100, [](size_t i, size_t) {
+        if (i == 42) throw std::runtime_error("task failed");
+    }), std::runtime_error);
+
+    // The pool stays usable afterwards
+    std::atomic<int> count(0);
+    pool.parallel_for(10, [&](size_t, size_t) { count++; });
+    EXPECT_EQ(count.load(), 10);
+}
+
+// ============================================================================
+// Analyzer Tests
+// ============================================================================
+
+TEST(TriQualityAnalyzer, MatchesSerialTrilib) {
+    auto grid = DegenerateGrid(60);
+    auto mesh = grid.view();
+
+    MeshQualityAnalyzer analyzer(3, 256);
+    MeshQualityReport report = analyzer.analyze(mesh);
+
+    double minang = 1e9, maxang = -1e9, total = 0, ratio = 0;
+    size_t ndegenerate = 0;
+    for (size_t f = 0; f < mesh.nfaces(); f++) {
+        total += area(mesh, f);
+        if (isDegenerate(mesh, f))
+            ndegenerate++;
+        else
+            ratio = std::max(ratio, circumradius(mesh, f)/inradius(mesh, f));
+        auto a = angles(mesh, f);
+        if (std::isnan(a[0]) || std::isnan(a[1]) || std::isnan(a[2])) continue;
+        for (int k = 0; k < 3; k++) {
+            minang = std::min(minang, a[k]);
+            maxang = std::max(maxang, a[k]);
+        }
+    }
+
+    EXPECT_EQ(report.nfaces, mesh.nfaces());
+    EXPECT_EQ(report.ndegenerate, ndegenerate);
+    EXPECT_GE(report.ndegenerate, 2u);
+    EXPECT_NEAR(report.total_area, total, EPSILON);
+    EXPECT_EQ(report.minangle, minang);
+    EXPECT_EQ(report.maxangle, maxang);
+    EXPECT_NEAR(minangle(mesh, report.minangle_face).first, minang, EPSILON);
+    EXPECT_NEAR(report.max_radius_ratio, ratio, EPSILON*ratio);
+    EXPECT_GT(report.max_radius_ratio, 2.0);
+
+    size_t counted = 0;
+    for (size_t c : report.histogram) counted += c;
+    EXPECT_EQ(counted, 3*(mesh.nfaces() - 1));   // the repeated-vertex face is excluded
+}
+
+TEST(TriQualityAnalyzer, ApproximateAcos) {
+    auto grid = DegenerateGrid(60);
+    auto mesh = grid.view();
+
+    MeshQualityReport exact = MeshQualityAnalyzer(2, 256).analyze(mesh);
+    for (TrigAccuracy accuracy : {TRIG_FINE, TRIG_COARSE}) {
+        MeshQualityAnalyzer analyzer(2, 256, 18, accuracy);
+        EXPECT_EQ(analyzer.accuracy(), accuracy);
+        MeshQualityReport report = analyzer.analyze(mesh);
+
+        const double bound = 180/M_PI*(accuracy == TRIG_FINE ? 1.3e-8 : 3.9e-5);
+        EXPECT_EQ(report.nfaces, exact.nfaces);
+        EXPECT_EQ(report.ndegenerate, exact.ndegenerate);
+        EXPECT_EQ(report.total_area, exact.total_area);
+        EXPECT_NEAR(report.minangle, exact.minangle, bound);
+        EXPECT_NEAR(report.maxangle, exact.maxangle, bound);
+
+        size_t counted = 0;
+        for (size_t c : report.histogram) counted += c;
+        EXPECT_EQ(counted, 3*(mesh.nfaces() - 1));
+
+        // Still independent of the thread count
+        ExpectSameReport(MeshQualityAnalyzer(5, 256, 18, accuracy).analyze(mesh), report);
+    }
+}
+
+TEST(TriQualityAnalyzer, IndependentOfThreadCount) {
+    auto grid = DegenerateGrid(80);
+    auto mesh = grid.view();
+
+    MeshQualityReport reference = MeshQualityAnalyzer(1, 1000).analyze(mesh);
+    for (size_t nthreads : {2, 3, 5, 8}) {
+        SCOPED_TRACE(nthreads);
+        ExpectSameReport(MeshQualityAnalyzer(nthreads, 1000).analyze(mesh), reference);
+    }
+}
+
+TEST(TriQualityAnalyzer, BatchMatchesMeshView) {
+    auto grid = DegenerateGrid(20);
+    auto mesh = grid.view();
+
+    TriangleBatch<double> batch;
+    for (size_t f = 0; f < mesh.nfaces(); f++)
+        batch.push_back(mesh.corner(f, 0), mesh.corner(f, 1), mesh.corner(f, 2));
+
+    MeshQualityAnalyzer analyzer(2, 64);
+    ExpectSameReport(analyzer.analyze(batch), analyzer.analyze(mesh));
+}
+
+TEST(TriQualityAnalyzer, TiesGoToLowestFace) {
+    // Four copies of the same right triangle
+    std::vector<double> xyz = {0, 0, 0, 3, 0, 0, 0, 4, 0};
+    std::vector<int> ids = {0, 1, 2, 0, 1, 2, 0, 1, 2, 0, 1, 2};
+    IndexedMeshView<double> mesh(xyz.data(), 3, ids.data(), 4);
+
+    MeshQualityReport report = MeshQualityAnalyzer(4, 1).analyze(mesh);
+    EXPECT_EQ(report.minangle_face, 0u);
+    EXPECT_EQ(report.maxangle_face, 0u);
+    EXPECT_NEAR(report.maxangle, 90.0, EPSILON);
+    EXPECT_NEAR(report.total_area, 24.0, EPSILON);
+    EXPECT_EQ(report.histogram[3], 4u);   // 36.87 degrees
+    EXPECT_EQ(report.histogram[5], 4u);   // 53.13 degrees
+}
+
+TEST(TriQualityAnalyzer, CollinearFaceAddsNoArea) {
+    // Face 1 is collinear, and rounding makes its Heron radicand negative
+    const double t = 2.4523;
+    std::vector<double> xyz = {0, 0, 0, 3, 0, 0, 0, 4, 0,
+                               0.1, 0.2, 0.3, 1.1, 0.7, 0.4,
+                               0.1 + t, 0.2 + t*0.5, 0.3 + t*0.1};
+    std::vector<int> ids = {0, 1, 2, 3, 4, 5};
+    IndexedMeshView<double> mesh(xyz.data(), 6, ids.data(), 2);
+
+    TriangleMetrics<double> m(METRIC_AREA);
+    m.compute(mesh.corner(1, 0), mesh.corner(1, 1), mesh.corner(1, 2));
+    ASSERT_TRUE(std::isnan(m.area));
+
+    MeshQualityReport report = MeshQualityAnalyzer(2, 1).analyze(mesh);
+    EXPECT_EQ(report.total_area, 6.0);
+    EXPECT_EQ(report.ndegenerate, 1u);
+}
+
+TEST(TriQualityAnalyzer, FoldMatchesAnalyze) {
+    auto grid = DegenerateGrid(40);
+    auto mesh = grid.view();
+    MeshQualityAnalyzer analyzer(3, 100);
+    MeshQualityReport whole = analyzer.analyze(mesh);
+
+    // Fold the same faces in pieces of 300 through views with their own index buffers
+    MeshQualityReport folded(analyzer.bins());
+    for (size_t first = 0; first < mesh.nfaces(); first += 300) {
+        size_t n = std::min<size_t>(300, mesh.nfaces() - first);
+        IndexedMeshView<double> piece(grid.xyz.data(), grid.xyz.size()/3, &grid.ids[3*first], n);
+        analyzer.fold(piece, first, folded);
+    }
+    ExpectSameReport(folded, whole);
+
+    EXPECT_THROW(analyzer.fold(mesh, 150, folded), std::invalid_argument);
+}
+
+TEST(TriQualityAnalyzer, EmptyMesh) {
+    IndexedMeshView<double> mesh;
+    MeshQualityReport report = MeshQualityAnalyzer(2).analyze(mesh);
+    EXPECT_EQ(report.nfaces, 0u);
+    EXPECT_EQ(report.total_area, 0.0);
+    EXPECT_EQ(report.minangle_face, MeshQualityReport::npos);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,192 @@
+#include <gtest/gtest.h>
+#include "../trisample.hpp"
+#include "../tribary.hpp"
+#include "../trimesh.hpp"
+#include <cmath>
+
+const double EPSILON = 1e-6;
+
+template<class T>
+void ExpectSameStreams(const TriangleBatch<T> &a, const TriangleBatch<T> &b) {
+    ASSERT_EQ(a.size(), b.size());
+    for (int k = 0; k < 3; k++)
+        for (size_t i = 0; i < a.size(); i++) {
+            ASSERT_EQ(a.x(k)[i], b.x(k)[i]);
+            ASSERT_EQ(a.y(k)[i], b.y(k)[i]);
+            ASSERT_EQ(a.z(k)[i], b.z(k)[i]);
+        }
+}
+
+// ============================================================================
+// Random Geometry Tests
+// ============================================================================
+
+TEST(TriSample, RandomPointsInBox) {
+    JMath::RandomStream rng(3);
+    const size_t n = 10000;
+    std::vector<float> x(n), y(n), z(n);
+    random_points(rng, n, x.data(), y.data(), z.data(), -5.0f, 5.0f);
+    for (size_t i = 0; i < n; i++) {
+        ASSERT_GE(std::min({x[i], y[i], z[i]}), -5.0f);
+        ASSERT_LE(std::max({x[i], y[i], z[i]}), 5.0f);
+    }
+    EXPECT_NEAR(JMath::moments(x).mean, 0.0, 0.1);
+    EXPECT_NE(x[0], y[0]);
+}
+
+TEST(TriSample, IndependentOfThreadCount) {
+    const size_t n = 3*SAMPLE_CHUNK + 101;
+    TriangleBatch<double> a, b;
+    JMath::ThreadPool one(1), four(4);
+    random_triangles(one, 11, n, a, -1.0, 1.0);
+    random_triangles(four, 11, n, b, -1.0, 1.0);
+    ExpectSameStreams(a, b);
+
+    std::vector<double> x1(n), y1(n), z1(n), x4(n), y4(n), z4(n);
+    sample_triangles(one, 12, a, x1.data(), y1.data(), z1.data());
+    sample_triangles(four, 12, a, x4.data(), y4.data(), z4.data());
+    EXPECT_EQ(x1, x4);
+    EXPECT_EQ(y1, y4);
+    EXPECT_EQ(z1, z4);
+
+    random_points(one, 13, n, x1.data(), y1.data(), z1.data(), 0.0, 2.0);
+    random_points(four, 13, n, x4.data(), y4.data(), z4.data(), 0.0, 2.0);
+    EXPECT_EQ(z1, z4);
+
+    // A different seed gives different triangles
+    random_triangles(four, 14, n, b, -1.0, 1.0);
+    EXPECT_NE(a.x(0)[0], b.x(0)[0]);
+}
+
+// ============================================================================
+// Sampling Tests
+// ============================================================================
+
+TEST(TriSample, SamplesLieInsideTheirTriangles) {
+    JMath::RandomStream rng(15);
+    TriangleBatch<double> batch;
+    random_triangles(rng, 5000, batch, -10.0, 10.0);
+
+    std::vector<double> x(batch.size()), y(batch.size()), z(batch.size());
+    sample_triangles(rng, batch, x.data(), y.data(), z.data());
+    for (size_t i = 0; i < batch.size(); i++) {
+        BaryFrame<double> f(batch.vertex(i, 0), batch.vertex(i, 1), batch.vertex(i, 2));
+        auto l = f(std::array<double, 3>{x[i], y[i], z[i]});
+        for (int k = 0; k < 3; k++) ASSERT_GT(l[k], -1e-6) << i;
+    }
+}
+
+TEST(TriSample, UniformOverTheTriangle) {
+    // The corner region l0 > 1/2 holds a quarter of the area, as does the
+    // middle triangle of the medial subdivision
+    JMath::RandomStream rng(16);
+    std::array<float, 3> a = {0, 0, 0}, b = {4, 0, 1}, c = {1, 3, 0};
+    const size_t n = 200000;
+    std::vector<float> x(n), y(n), z(n);
+    sample_triangle(rng, a, b, c, n, x.data(), y.data(), z.data());
+
+    BaryFrame<double> f(a, b, c);
+    size_t corner = 0, middle = 0;
+    for (size_t i = 0; i < n; i++) {
+        auto l = f(std::array<double, 3>{x[i], y[i], z[i]});
+        corner += l[0] > 0.5;
+        middle += l[0] < 0.5 && l[1] < 0.5 && l[2] < 0.5;
+    }
+    const double sigma = std::sqrt(0.25*0.75/n);
+    EXPECT_NEAR((double)corner/n, 0.25, 5*sigma);
+    EXPECT_NEAR((double)middle/n, 0.25, 5*sigma);
+}
+
+// ============================================================================
+// Surface Sampler Tests
+// ============================================================================
+
+// Unit square split in two (area 1/2 each), a 2x1 rectangle split in two
+// (area 1 each) and a degenerate face
+struct SamplerMesh {
+    std::vector<double> v = {0, 0, 0,  1, 0, 0,  1, 1, 0,  0, 1, 0,
+                             0, 0, 1,  2, 0, 1,  2, 1, 1,  0, 1, 1};
+    std::vector<int>    f = {0, 1, 2,  0, 2, 3,  4, 5, 6,  4, 6, 7,  0, 1, 1};
+    IndexedMeshView<double> view() const { return IndexedMeshView<double>(v.data(), 8, f.data(), 5); }
+};
+
+TEST(SurfaceSampler, AliasTableMatchesAreas) {
+    SamplerMesh m;
+    SurfaceSampler<double> s(m.view());
+    ASSERT_TRUE(s.valid());
+    EXPECT_NEAR(s.total_area(), 3.0, EPSILON);
+    EXPECT_NEAR(s.area(0), 0.5, EPSILON);
+    EXPECT_EQ(s.area(4), 0.0);
+
+    double sum = 0;
+    for (size_t f = 0; f < s.nfaces(); f++) {
+        EXPECT_NEAR(s.probability(f), s.area(f)/s.total_area(), 1e-9) << f;
+        sum += s.probability(f);
+    }
+    EXPECT_NEAR(sum, 1.0, 1e-9);
+
+    // Empty and all-degenerate meshes cannot be sampled
+    EXPECT_FALSE(SurfaceSampler<double>(TriangleBatch<double>()).valid());
+}
+
+TEST(SurfaceSampler, FaceFrequenciesFollowArea) {
+    SamplerMesh m;
+    SurfaceSampler<double> s(m.view());
+    JMath::RandomStream rng(17);
+    const size_t n = 300000;
+    std::vector<int> face(n);
+    std::vector<double> l0(n), l1(n), l2(n), x(n), y(n), z(n);
+    s.sample(rng, m.view(), n, x.data(), y.data(), z.data(), face.data(), l0.data(), l1.data(), l2.data());
+
+    std::vector<size_t> count(s.nfaces());
+    for (size_t i = 0; i < n; i++) {
+        ASSERT_GE(face[i], 0);
+        ASSERT_LT(face[i], 4);
+        count[face[i]]++;
+
+        // Weights are a point of the face, and the point matches them
+        ASSERT_GE(std::min({l0[i], l1[i], l2[i]}), 0.0);
+        ASSERT_NEAR(l0[i] + l1[i] + l2[i], 1.0, EPSILON);
+        auto pa = m.view().corner(face[i], 0), pb = m.view().corner(face[i], 1), pc = m.view().corner(face[i], 2);
+        ASSERT_NEAR(x[i], l0[i]*pa[0] + l1[i]*pb[0] + l2[i]*pc[0], EPSILON);
+        ASSERT_NEAR(z[i], face[i] < 2 ? 0.0 : 1.0, EPSILON);
+    }
+    for (size_t f = 0; f < s.nfaces(); f++) {
+        double p = s.area(f)/s.total_area();
+        EXPECT_NEAR((double)count[f]/n, p, 5*std::sqrt(p*(1 - p)/n) + 1e-12) << f;
+    }
+}
+
+TEST(SurfaceSampler, DeterministicAndIndependentOfThreadCount) {
+    JMath::RandomStream rng(18);
+    TriangleBatch<float> batch;
+    random_triangles(rng, 3000, batch, -1.0f, 1.0f);
+
+    JMath::ThreadPool one(1), four(4);
+    SurfaceSampler<float> s1(batch), s4(four, batch);
+    for (size_t f = 0; f < batch.size(); f++) ASSERT_EQ(s1.area(f), s4.area(f));
+
+    const size_t n = 2*SAMPLE_CHUNK + 77;
+    std::vector<int> f1(n), f4(n);
+    std::vector<float> a1(n), b1(n), c1(n), a4(n), b4(n), c4(n);
+    std::vector<float> x1(n), y1(n), z1(n), x4(n), y4(n), z4(n);
+    s1.sample(one, 19, batch, n, x1.data(), y1.data(), z1.data(), f1.data(), a1.data(), b1.data(), c1.data());
+    s4.sample(four, 19, batch, n, x4.data(), y4.data(), z4.data(), f4.data(), a4.data(), b4.data(), c4.data());
+    EXPECT_EQ(f1, f4);
+    EXPECT_EQ(b1, b4);
+    EXPECT_EQ(x1, x4);
+    EXPECT_EQ(z1, z4);
+
+    // Splitting a run at a multiple of 256 changes nothing
+    JMath::RandomStream r1(20), r2(20);
+    s1.sample(r1, 1024, f1.data(), a1.data(), b1.data(), c1.data());
+    s1.sample(r2, 512, f4.data(), a4.data(), b4.data(), c4.data());
+    s1.sample(r2, 512, f4.data() + 512, a4.data() + 512, b4.data() + 512, c4.data() + 512);
+    EXPECT_TRUE(std::equal(f1.begin(), f1.begin() + 1024, f4.begin()));
+    EXPECT_TRUE(std::equal(c1.begin(), c1.begin() + 1024, c4.begin()));
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
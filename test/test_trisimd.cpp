@@ -0,0 +1,399 @@
+#include <gtest/gtest.h>
+#include "../trisimd.hpp"
+#include <cmath>
+#include <cstring>
+
+const double EPSILON = 1e-6;
+
+// Random triangles plus a few degenerate ones (collinear, repeated vertex)
+template<class T>
+TriangleBatch<T> MakeBatch(size_t n) {
+    JMath::seed_random(4242);
+    TriangleBatch<T> batch;
+    for (size_t i = 0; i < n; i++) {
+        std::array<T, 3> p[3];
+        for (int k = 0; k < 3; k++)
+            for (int j = 0; j < 3; j++)
+                p[k][j] = JMath::random_value<T>(-100, 100);
+        if (i % 17 == 3) p[2] = p[0];
+        if (i % 19 == 5) for (int j = 0; j < 3; j++) p[2][j] = 2*p[1][j] - p[0][j];
+        batch.push_back(p[0], p[1], p[2]);
+    }
+    return batch;
+}
+
+// Bitwise comparison so that NaNs from degenerate inputs compare equal too
+template<class T>
+bool SameBits(T a, T b) {
+    return std::memcmp(&a, &b, sizeof(T)) == 0 || (std::isnan(a) && std::isnan(b));
+}
+
+// Runs a check once per ISA available on this machine, scalar included
+template<class F>
+void ForEachISA(F check) {
+    for (int isa = TriSIMD::ISA_SCALAR; isa <= TriSIMD::detect_isa(); isa++) {
+        TriSIMD::set_isa((TriSIMD::ISA)isa);
+        SCOPED_TRACE(TriSIMD::isa_name(TriSIMD::active_isa()));
+        check();
+    }
+    TriSIMD::set_isa(TriSIMD::detect_isa());
+}
+
+// ============================================================================
+// Dispatch Tests
+// ============================================================================
+
+TEST(TriSIMDDispatch, SetIsaClampsToDetected) {
+    TriSIMD::set_isa(TriSIMD::ISA_AVX512);
+    EXPECT_LE(TriSIMD::active_isa(), TriSIMD::detect_isa());
+
+    TriSIMD::set_isa(TriSIMD::ISA_SCALAR);
+    EXPECT_EQ(TriSIMD::active_isa(), TriSIMD::ISA_SCALAR);
+    EXPECT_STREQ(TriSIMD::isa_name(TriSIMD::ISA_SCALAR), "scalar");
+
+    TriSIMD::set_isa(TriSIMD::detect_isa());
+}
+
+// ============================================================================
+// Kernel Tests (every ISA must match the scalar batch kernels bit for bit)
+// ============================================================================
+
+template<class T>
+void CheckArea(size_t n) {
+    auto batch = MakeBatch<T>(n);
+    std::vector<T> expected(n), out(n);
+    area(batch, expected.data());
+
+    ForEachISA([&] {
+        std::fill(out.begin(), out.end(), T(-1));
+        TriSIMD::area(batch, out.data());
+        for (size_t i = 0; i < n; i++) EXPECT_PRED2(SameBits<T>, out[i], expected[i]) << i;
+    });
+}
+
+template<class T>
+void CheckNormal(size_t n) {
+    auto batch = MakeBatch<T>(n);
+    std::vector<T> ex(n), ey(n), ez(n), nx(n), ny(n), nz(n);
+    normal(batch, ex.data(), ey.data(), ez.data());
+
+    ForEachISA([&] {
+        TriSIMD::normal(batch, nx.data(), ny.data(), nz.data());
+        for (size_t i = 0; i < n; i++) {
+            EXPECT_PRED2(SameBits<T>, nx[i], ex[i]) << i;
+            EXPECT_PRED2(SameBits<T>, ny[i], ey[i]) << i;
+            EXPECT_PRED2(SameBits<T>, nz[i], ez[i]) << i;
+        }
+    });
+}
+
+template<class T>
+void CheckAngles(size_t n, int measure, TrigAccuracy accuracy = TRIG_EXACT) {
+    auto batch = MakeBatch<T>(n);
+    std::vector<T> e0(n), e1(n), e2(n), a0(n), a1(n), a2(n);
+    angles(batch, e0.data(), e1.data(), e2.data(), measure, accuracy);
+
+    ForEachISA([&] {
+        TriSIMD::angles(batch, a0.data(), a1.data(), a2.data(), measure, accuracy);
+        for (size_t i = 0; i < n; i++) {
+            EXPECT_PRED2(SameBits<T>, a0[i], e0[i]) << i;
+            EXPECT_PRED2(SameBits<T>, a1[i], e1[i]) << i;
+            EXPECT_PRED2(SameBits<T>, a2[i], e2[i]) << i;
+        }
+    });
+}
+
+TEST(TriSIMDKernels, AreaDouble) { CheckArea<double>(1037); }
+TEST(TriSIMDKernels, AreaFloat)  { CheckArea<float>(1037); }
+
+TEST(TriSIMDKernels, NormalDouble) { CheckNormal<double>(1037); }
+TEST(TriSIMDKernels, NormalFloat)  { CheckNormal<float>(1037); }
+
+TEST(TriSIMDKernels, AnglesDouble) {
+    CheckAngles<double>(1037, ANGLE_IN_DEGREES);
+    CheckAngles<double>(1037, ANGLE_IN_RADIANS);
+}
+TEST(TriSIMDKernels, AnglesFloat) {
+    CheckAngles<float>(1037, ANGLE_IN_DEGREES);
+    CheckAngles<float>(1037, ANGLE_IN_RADIANS);
+}
+
+TEST(TriSIMDKernels, PolynomialAcosTiers) {
+    for (TrigAccuracy accuracy : {TRIG_FINE, TRIG_COARSE}) {
+        CheckAngles<double>(1037, ANGLE_IN_DEGREES, accuracy);
+        CheckAngles<double>(13, ANGLE_IN_RADIANS, accuracy);
+        CheckAngles<float>(1037, ANGLE_IN_DEGREES, accuracy);
+        CheckAngles<float>(13, ANGLE_IN_RADIANS, accuracy);
+    }
+}
+
+TEST(TriSIMDKernels, ShortBatchesUseTailPath) {
+    for (size_t n : {1, 2, 3, 7, 15}) {
+        CheckArea<double>(n);
+        CheckArea<float>(n);
+    }
+}
+
+TEST(TriSIMDKernels, KnownRightTriangle) {
+    TriangleBatch<double> batch;
+    batch.push_back({0.0, 0.0, 0.0}, {3.0, 0.0, 0.0}, {0.0, 4.0, 0.0});
+
+    ForEachISA([&] {
+        double ar, nx, ny, nz, a0, a1, a2;
+        TriSIMD::area(batch, &ar);
+        TriSIMD::normal(batch, &nx, &ny, &nz);
+        TriSIMD::angles(batch, &a0, &a1, &a2);
+        EXPECT_NEAR(ar, 6.0, EPSILON);
+        EXPECT_NEAR(nz, 1.0, EPSILON);
+        EXPECT_NEAR(a0, 90.0, EPSILON);
+        EXPECT_NEAR(a0 + a1 + a2, 180.0, EPSILON);
+    });
+}
+
+// ============================================================================
+// Ray Kernel Tests (bit for bit against the scalar intersect() loops)
+// ============================================================================
+
+template<class T>
+Ray<T> RandomRay() {
+    Ray<T> ray;
+    for (int j = 0; j < 3; j++) {
+        ray.origin[j] = JMath::random_value<T>(-150, 150);
+        ray.dir[j] = JMath::random_value<T>(-100, 100) - ray.origin[j];
+    }
+    return ray;
+}
+
+template<class T>
+void CheckRay(size_t n) {
+    auto batch = MakeBatch<T>(n);
+    JMath::seed_random(77);
+    std::vector<Ray<T>> rays;
+    for (int r = 0; r < 8; r++) rays.push_back(RandomRay<T>());
+    rays[1].tmin = 0.3;
+    rays[1].tmax = 0.7;
+    rays[2].dir = {1, 0, 0};   // axis-aligned, zero direction components
+
+    size_t hits = 0;
+    for (const auto &ray : rays) {
+        std::vector<T> t(n), u(n), v(n), et(n), eu(n), ev(n);
+        intersect(ray, batch, et.data(), eu.data(), ev.data());
+        for (size_t i = 0; i < n; i++) hits += !std::isinf(et[i]);
+
+        ForEachISA([&] {
+            TriSIMD::intersect(ray, batch, t.data(), u.data(), v.data());
+            for (size_t i = 0; i < n; i++) {
+                EXPECT_PRED2(SameBits<T>, t[i], et[i]) << i;
+                EXPECT_PRED2(SameBits<T>, u[i], eu[i]) << i;
+                EXPECT_PRED2(SameBits<T>, v[i], ev[i]) << i;
+            }
+        });
+    }
+    if (n > 100) {
+        EXPECT_GT(hits, 0u);
+    }
+}
+
+template<class T>
+void CheckPacket(size_t n) {
+    auto batch = MakeBatch<T>(20);
+    JMath::seed_random(78);
+    RayBatch<T> rays;
+    for (size_t r = 0; r < n; r++) {
+        auto ray = RandomRay<T>();
+        if (r % 5 == 1) ray.tmax = JMath::random_value<T>(0, 1);
+        rays.push_back(ray);
+    }
+
+    size_t hits = 0;
+    for (size_t f = 0; f < batch.size(); f++) {
+        auto a = batch.vertex(f, 0), b = batch.vertex(f, 1), c = batch.vertex(f, 2);
+        std::vector<T> t(n), u(n), v(n), et(n), eu(n), ev(n);
+        intersect(rays, a, b, c, et.data(), eu.data(), ev.data());
+        for (size_t i = 0; i < n; i++) hits += !std::isinf(et[i]);
+
+        ForEachISA([&] {
+            TriSIMD::intersect(rays, a, b, c, t.data(), u.data(), v.data());
+            for (size_t i = 0; i < n; i++) {
+                EXPECT_PRED2(SameBits<T>, t[i], et[i]) << i;
+                EXPECT_PRED2(SameBits<T>, u[i], eu[i]) << i;
+                EXPECT_PRED2(SameBits<T>, v[i], ev[i]) << i;
+            }
+        });
+    }
+    if (n > 100) {
+        EXPECT_GT(hits, 0u);
+    }
+}
+
+TEST(TriSIMDRay, OneRayManyTrianglesDouble) { CheckRay<double>(1037); }
+TEST(TriSIMDRay, OneRayManyTrianglesFloat)  { CheckRay<float>(1037); }
+
+TEST(TriSIMDRay, ManyRaysOneTriangleDouble) { CheckPacket<double>(1037); }
+TEST(TriSIMDRay, ManyRaysOneTriangleFloat)  { CheckPacket<float>(1037); }
+
+TEST(TriSIMDRay, ShortBatchesUseTailPath) {
+    for (size_t n : {1, 2, 3, 7, 15}) {
+        CheckRay<double>(n);
+        CheckRay<float>(n);
+        CheckPacket<float>(n);
+    }
+}
+
+TEST(TriSIMDRay, KnownHit) {
+    TriangleBatch<float> batch;
+    batch.push_back({0.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f});
+    batch.push_back({0.0f, 0.0f, 1.0f}, {1.0f, 0.0f, 1.0f}, {0.0f, 1.0f, 1.0f});
+    Ray<float> ray;
+    ray.origin = {0.25f, 0.5f, -1.0f};
+
+    ForEachISA([&] {
+        float t[2], u[2], v[2];
+        TriSIMD::intersect(ray, batch, t, u, v);
+        EXPECT_NEAR(t[0], 1.0f, 1e-6f);
+        EXPECT_NEAR(t[1], 2.0f, 1e-6f);
+        EXPECT_NEAR(u[0], 0.25f, 1e-6f);
+        EXPECT_NEAR(v[1], 0.5f, 1e-6f);
+    });
+}
+
+// ============================================================================
+// Closest Point Kernel Tests (bit for bit against the scalar closest_point() loops)
+// ============================================================================
+
+template<class T>
+std::vector<T> RandomCoords(size_t n, T lo, T hi) {
+    std::vector<T> x(n);
+    for (auto &v : x) v = JMath::random_value<T>(lo, hi);
+    return x;
+}
+
+template<class T>
+void CheckClosest(size_t n) {
+    auto batch = MakeBatch<T>(n);
+    JMath::seed_random(79);
+    auto qx = RandomCoords<T>(n, -150, 150), qy = RandomCoords<T>(n, -150, 150),
+         qz = RandomCoords<T>(n, -150, 150);
+
+    std::vector<T> d(n), x(n), y(n), z(n), ed(n), ex(n), ey(n), ez(n);
+    std::vector<uint8_t> f(n), ef(n);
+    closest_point(batch, qx.data(), qy.data(), qz.data(), ed.data(), ex.data(), ey.data(),
+                  ez.data(), ef.data());
+
+    ForEachISA([&] {
+        TriSIMD::closest_point(batch, qx.data(), qy.data(), qz.data(), d.data(), x.data(),
+                               y.data(), z.data(), f.data());
+        for (size_t i = 0; i < n; i++) {
+            EXPECT_PRED2(SameBits<T>, d[i], ed[i]) << i;
+            EXPECT_PRED2(SameBits<T>, x[i], ex[i]) << i;
+            EXPECT_PRED2(SameBits<T>, y[i], ey[i]) << i;
+            EXPECT_PRED2(SameBits<T>, z[i], ez[i]) << i;
+            EXPECT_EQ(f[i], ef[i]) << i;
+        }
+    });
+}
+
+template<class T>
+void CheckClosestPacket(size_t n) {
+    auto batch = MakeBatch<T>(20);
+    JMath::seed_random(80);
+    auto qx = RandomCoords<T>(n, -150, 150), qy = RandomCoords<T>(n, -150, 150),
+         qz = RandomCoords<T>(n, -150, 150);
+
+    for (size_t t = 0; t < batch.size(); t++) {
+        auto a = batch.vertex(t, 0), b = batch.vertex(t, 1), c = batch.vertex(t, 2);
+        std::vector<T> d(n), x(n), ed(n), ex(n);
+        std::vector<uint8_t> f(n), ef(n);
+        closest_point(a, b, c, n, qx.data(), qy.data(), qz.data(), ed.data(), ex.data(),
+                      nullptr, nullptr, ef.data());
+
+        ForEachISA([&] {
+            TriSIMD::closest_point(a, b, c, n, qx.data(), qy.data(), qz.data(), d.data(),
+                                   x.data(), nullptr, nullptr, f.data());
+            for (size_t i = 0; i < n; i++) {
+                EXPECT_PRED2(SameBits<T>, d[i], ed[i]) << i;
+                EXPECT_PRED2(SameBits<T>, x[i], ex[i]) << i;
+                EXPECT_EQ(f[i], ef[i]) << i;
+            }
+        });
+    }
+}
+
+TEST(TriSIMDClosest, PointPerTriangleDouble) { CheckClosest<double>(1037); }
+TEST(TriSIMDClosest, PointPerTriangleFloat)  { CheckClosest<float>(1037); }
+
+TEST(TriSIMDClosest, ManyPointsOneTriangleDouble) { CheckClosestPacket<double>(1037); }
+TEST(TriSIMDClosest, ManyPointsOneTriangleFloat)  { CheckClosestPacket<float>(1037); }
+
+TEST(TriSIMDClosest, ShortBatchesUseTailPath) {
+    for (size_t n : {1, 2, 3, 7, 15}) {
+        CheckClosest<double>(n);
+        CheckClosest<float>(n);
+        CheckClosestPacket<float>(n);
+    }
+}
+
+TEST(TriSIMDClosest, TiesFollowEricsonOrder) {
+    // c is the midpoint of ab, so every query is in both the AB and the C region
+    std::array<double, 3> a = {0, 0, 0}, b = {2, 0, 0}, c = {1, 0, 0};
+    const size_t n = 9;
+    std::vector<double> qx(n, 1), qy(n), qz(n), d(n);
+    std::vector<uint8_t> f(n);
+    for (size_t i = 0; i < n; i++) qy[i] = 1 + (double)i;
+
+    ForEachISA([&] {
+        TriSIMD::closest_point(a, b, c, n, qx.data(), qy.data(), qz.data(), d.data(),
+                               nullptr, nullptr, nullptr, f.data());
+        for (size_t i = 0; i < n; i++) EXPECT_EQ(f[i], FEATURE_EDGE_AB) << i;
+    });
+}
+
+TEST(TriSIMDKernels, IntegerBatchFallsBackToScalar) {
+    TriangleBatch<int> batch;
+    batch.push_back({0, 0, 0}, {3, 0, 0}, {0, 4, 0});
+    int ar;
+    TriSIMD::area(batch, &ar);
+    EXPECT_EQ(ar, 6);
+}
+
+// ============================================================================
+// Random Fill Tests
+// ============================================================================
+
+// TriSIMD::fill / fill_uniform against RandomStream, from a few starting
+// offsets (unaligned heads) and across the 2^32-block carry of the counter
+template<class T>
+void CheckRandomFill(uint64_t start) {
+    const size_t n = 1037;
+    ForEachISA([&] {
+        for (size_t head : {0, 1, 3}) {
+            JMath::RandomStream ref(99, 5), rng(99, 5);
+            ref.skip(start + head);
+            rng.skip(start + head);
+
+            std::vector<uint32_t> w(n), ew(n);
+            std::vector<T> u(n), eu(n);
+            TriSIMD::fill(rng, w.data(), n);
+            ref.fill(ew.data(), n);
+            TriSIMD::fill_uniform(rng, u.data(), n, (T)-3, (T)7);
+            ref.fill_uniform(eu.data(), n, (T)-3, (T)7);
+
+            EXPECT_EQ(w, ew);
+            for (size_t i = 0; i < n; i++) ASSERT_PRED2(SameBits<T>, u[i], eu[i]) << head << " " << i;
+            EXPECT_EQ(rng.position(), ref.position());
+            EXPECT_EQ(rng.next_u32(), ref.next_u32());
+        }
+    });
+}
+
+TEST(TriSIMDRandom, FillMatchesStreamFloat)  { CheckRandomFill<float>(0); }
+TEST(TriSIMDRandom, FillMatchesStreamDouble) { CheckRandomFill<double>(0); }
+TEST(TriSIMDRandom, CounterCarry) {
+    CheckRandomFill<float>(4*((uint64_t(1) << 32) - 37));
+    CheckRandomFill<double>(4*((uint64_t(1) << 32) - 37));
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,158 @@
+#include <gtest/gtest.h>
+#include "../tristream.hpp"
+#include "grid_mesh.hpp"
+#include <cstring>
+#include <fstream>
+
+const double EPSILON = 1e-6;
+
+std::string TempPath(const std::string &name) {
+    return ::testing::TempDir() + "tristream_" + name;
+}
+
+template<class T>
+void Put(std::string &buf, T value) {
+    buf.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+// Jittered n x n grid plus one degenerate face, written out as STL or PLY
+struct Grid : GridMesh<float> {
+    explicit Grid(int n) : GridMesh<float>(n, 0.3, 0.2, 99) {
+        ids.insert(ids.end(), {0, 0, 1});
+    }
+
+    void WriteStl(const std::string &path) const {
+        std::string buf(80, ' ');
+        Put<uint32_t>(buf, nfaces());
+        for (size_t f = 0; f < nfaces(); f++) {
+            for (int j = 0; j < 3; j++) Put<float>(buf, 0.0f);
+            for (int k = 0; k < 3; k++)
+                for (int j = 0; j < 3; j++) Put<float>(buf, xyz[3*ids[3*f + k] + j]);
+            Put<uint16_t>(buf, 0);
+        }
+        std::ofstream(path, std::ios::binary).write(buf.data(), buf.size());
+    }
+
+    void WritePly(const std::string &path) const {
+        std::string buf = "ply\nformat binary_little_endian 1.0\nelement vertex " +
+            std::to_string(xyz.size()/3) + "\nproperty float x\nproperty float y\nproperty float z\n"
+            "element face " + std::to_string(nfaces()) +
+            "\nproperty list uchar int vertex_indices\nend_header\n";
+        for (float c : xyz) Put<float>(buf, c);
+        for (size_t f = 0; f < nfaces(); f++) {
+            Put<uint8_t>(buf, 3);
+            for (int k = 0; k < 3; k++) Put<int32_t>(buf, ids[3*f + k]);
+        }
+        std::ofstream(path, std::ios::binary).write(buf.data(), buf.size());
+    }
+};
+
+void ExpectSameReport(const MeshQualityReport &a, const MeshQualityReport &b) {
+    EXPECT_EQ(a.nfaces, b.nfaces);
+    EXPECT_EQ(a.ndegenerate, b.ndegenerate);
+    EXPECT_EQ(std::memcmp(&a.total_area, &b.total_area, sizeof(double)), 0);
+    EXPECT_EQ(a.minangle, b.minangle);
+    EXPECT_EQ(a.minangle_face, b.minangle_face);
+    EXPECT_EQ(a.maxangle, b.maxangle);
+    EXPECT_EQ(a.maxangle_face, b.maxangle_face);
+    EXPECT_EQ(a.max_radius_ratio, b.max_radius_ratio);
+    EXPECT_EQ(a.max_radius_ratio_face, b.max_radius_ratio_face);
+    EXPECT_EQ(a.histogram, b.histogram);
+}
+
+// ============================================================================
+// Streaming Tests
+// ============================================================================
+
+TEST(TriStream, StlMatchesInMemory) {
+    Grid grid(50);
+    std::string path = TempPath("grid.stl");
+    grid.WriteStl(path);
+
+    MeshQualityAnalyzer analyzer(3, 128);
+    MeshQualityReport whole = analyzer.analyze(StlFile(path).mesh());
+    EXPECT_EQ(whole.nfaces, grid.nfaces());
+    EXPECT_EQ(whole.ndegenerate, 1u);
+
+    for (size_t chunk : {128, 384, 1024, 100000}) {
+        SCOPED_TRACE(chunk);
+        StlChunkReader reader(path, chunk);
+        EXPECT_EQ(reader.nfaces(), grid.nfaces());
+        ExpectSameReport(analyze_stream(analyzer, reader), whole);
+    }
+}
+
+TEST(TriStream, PlyMatchesInMemory) {
+    Grid grid(50);
+    std::string path = TempPath("grid.ply");
+    grid.WritePly(path);
+
+    MeshQualityAnalyzer analyzer(2, 256);
+    MeshQualityReport whole = analyzer.analyze(PlyFile(path).mesh<float>());
+
+    for (size_t chunk : {256, 768}) {
+        SCOPED_TRACE(chunk);
+        PlyChunkReader<float> reader(path, chunk);
+        ExpectSameReport(analyze_stream(analyzer, reader), whole);
+    }
+    EXPECT_THROW(PlyChunkReader<double>(path, 256), std::runtime_error);
+}
+
+TEST(TriStream, ChunksCoverEveryFaceOnce) {
+    Grid grid(10);
+    std::string path = TempPath("small.stl");
+    grid.WriteStl(path);
+
+    StlChunkReader reader(path, 64);
+    size_t expected_first = 0;
+    while (reader.next()) {
+        EXPECT_EQ(reader.first_face(), expected_first);
+        auto chunk = reader.mesh();
+        EXPECT_LE(chunk.nfaces(), 64u);
+        for (size_t f = 0; f < chunk.nfaces(); f++) {
+            int id = grid.ids[3*(expected_first + f) + 1];
+            EXPECT_EQ(chunk.corner(f, 1)[0], grid.xyz[3*id]);
+        }
+        expected_first += chunk.nfaces();
+    }
+    EXPECT_EQ(expected_first, grid.nfaces());
+    EXPECT_FALSE(reader.next());
+}
+
+TEST(TriStream, MisalignedChunksAreRejected) {
+    Grid grid(10);
+    std::string path = TempPath("misaligned.stl");
+    grid.WriteStl(path);
+
+    MeshQualityAnalyzer analyzer(1, 64);
+    StlChunkReader reader(path, 100);
+    EXPECT_THROW(analyze_stream(analyzer, reader), std::invalid_argument);
+    EXPECT_EQ(reader.first_face(), 0u);   // rejected before the first read
+
+    // A single chunk never needs to line up with the blocks
+    StlChunkReader whole(path, 1000);
+    EXPECT_EQ(analyze_stream(analyzer, whole).nfaces, grid.nfaces());
+}
+
+TEST(TriStream, KnownTotalArea) {
+    Grid grid(8);
+    std::string path = TempPath("area.stl");
+    grid.WriteStl(path);
+
+    double expected = 0;
+    for (size_t f = 0; f < grid.nfaces(); f++) {
+        std::array<float, 3> p[3];
+        for (int k = 0; k < 3; k++)
+            for (int j = 0; j < 3; j++) p[k][j] = grid.xyz[3*grid.ids[3*f + k] + j];
+        expected += area(p[0], p[1], p[2]);
+    }
+
+    MeshQualityAnalyzer analyzer(2, 16);
+    StlChunkReader reader(path, 32);
+    EXPECT_NEAR(analyze_stream(analyzer, reader).total_area, expected, EPSILON*expected);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
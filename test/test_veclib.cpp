@@ -2,6 +2,7 @@
 #include "../veclib.hpp"
 #include <cmath>
 #include <vector>
+#include <cstring>
 
 const double EPSILON = 1e-6;
 
@@ -57,6 +58,32 @@ TEST(VecLibLength, Length2SquaredDistance) {
     EXPECT_NEAR(len2, 25.0, EPSILON);
 }
 
+TEST(VecLibLength, PrecisionPolicies) {
+    std::array<float, 3> a = {0.1f, 0.2f, 0.3f};
+    std::array<float, 3> b = {1.7f, -2.9f, 0.55f};
+
+    // The policy overloads return their evaluation type
+    static_assert(std::is_same<decltype(JMath::length(a, b, JMath::DoublePrecision())), double>::value, "");
+    static_assert(std::is_same<decltype(JMath::length2(a, b, JMath::NativePrecision())), float>::value, "");
+    EXPECT_EQ((float)JMath::length(a, b, JMath::DoublePrecision()), JMath::length(a, b));
+    EXPECT_EQ((float)JMath::length2(a, b, JMath::DoublePrecision()), JMath::length2(a, b));
+    EXPECT_NEAR(JMath::length(a, b, JMath::NativePrecision()), JMath::length(a, b), 1e-6);
+    EXPECT_NEAR(JMath::length2(a, b, JMath::NativePrecision()), JMath::length2(a, b), 1e-5);
+    EXPECT_EQ(JMath::length(a, b, JMath::MixedPrecision()), JMath::length(a, b, JMath::NativePrecision()));
+
+    // Squares that overflow or underflow in float are redone in double
+    std::array<float, 3> big = {3e20f, 0.0f, 0.0f}, tiny = {0.0f, 4e-25f, 0.0f}, zero = {0, 0, 0};
+    EXPECT_TRUE(std::isinf(JMath::length(big, zero, JMath::NativePrecision())));
+    EXPECT_NEAR(JMath::length(big, zero, JMath::MixedPrecision()), 3e20f, 1e14f);
+    EXPECT_EQ(JMath::length(tiny, zero, JMath::NativePrecision()), 0.0f);
+    EXPECT_NEAR(JMath::length(tiny, zero, JMath::MixedPrecision()), 4e-25f, 1e-31f);
+
+    // Double points give the same result under every policy
+    std::array<double, 3> c = {0.1, 0.2, 0.3}, d = {1.7, -2.9, 0.55};
+    EXPECT_EQ(JMath::length(c, d, JMath::NativePrecision()), JMath::length(c, d));
+    EXPECT_EQ(JMath::length(c, d, JMath::MixedPrecision()), JMath::length(c, d));
+}
+
 TEST(VecLibLength, MagnitudeOfVector) {
     std::array<double, 3> v = {3.0, 4.0, 0.0};
 
@@ -296,6 +323,27 @@ TEST(VecLibStatistics, MedianValue) {
     EXPECT_NEAR(median, 3.0, EPSILON);
 }
 
+TEST(VecLibStatistics, SelectionMatchesSort) {
+    JMath::seed_random(20);
+    std::vector<double> values(1001);
+    for (auto &v : values) v = JMath::random_value<double>(-10, 10);
+    std::vector<double> sorted(values);
+    std::sort(sorted.begin(), sorted.end());
+
+    EXPECT_EQ(JMath::mean_value(values), sorted[500]);
+    for (double q : {0.0, 0.1, 0.25, 0.9, 0.999, 1.0})
+        EXPECT_EQ(JMath::quantile_value(values, q), sorted[std::min<size_t>(q*1001, 1000)]);
+
+    // In place: same answer, values reordered around it
+    std::vector<double> work(values);
+    EXPECT_EQ(JMath::select_value(work, 0.25), sorted[250]);
+    EXPECT_EQ(work[250], sorted[250]);
+    for (size_t i = 0; i < 250; i++) EXPECT_LE(work[i], work[250]);
+
+    std::vector<int> even = {4, 1, 3, 2};
+    EXPECT_EQ(JMath::mean_value(even), 3);
+}
+
 // ============================================================================
 // Coordinate Angle Tests
 // ============================================================================
@@ -326,6 +374,90 @@ TEST(VecLibTemplates, IntegerType) {
     EXPECT_NEAR(mag, 5, 1);  // Integer division/rounding
 }
 
+// ============================================================================
+// Point Adapter Tests
+// ============================================================================
+
+// Minimal stand-in for an Eigen fixed-size vector
+struct FakeEigenVector3d {
+    typedef double Scalar;
+    enum { RowsAtCompileTime = 3, ColsAtCompileTime = 1 };
+    double data[3];
+    double operator[](int i) const { return data[i]; }
+};
+
+TEST(VecLibPointAdapters, RawArrays) {
+    double a[3] = {1.0, 2.0, 3.0};
+    double b[3] = {4.0, 5.0, 6.0};
+
+    EXPECT_NEAR(JMath::length2(a, b), 27.0, EPSILON);
+    EXPECT_NEAR(JMath::dot_product(a, b), 32.0, EPSILON);
+    auto cross = JMath::cross_product(a, b);
+    EXPECT_NEAR(cross[1], 6.0, EPSILON);
+}
+
+TEST(VecLibPointAdapters, EigenStyleVectors) {
+    FakeEigenVector3d a = {{3.0, 4.0, 0.0}};
+    FakeEigenVector3d b = {{0.0, 0.0, 0.0}};
+
+    EXPECT_NEAR(JMath::length(a, b), 5.0, EPSILON);
+    EXPECT_NEAR(JMath::magnitude(a), 5.0, EPSILON);
+    auto unit = JMath::unit_vector(a);
+    EXPECT_NEAR(unit[0], 0.6, EPSILON);
+}
+
+TEST(VecLibPointAdapters, StridedInterleavedBuffer) {
+    // position(3) + normal(3) + uv(2) floats = 32 byte stride
+    std::vector<float> buffer = {
+        0, 0, 0,   9, 9, 9,   7, 7,
+        3, 4, 0,   9, 9, 9,   7, 7,
+        1, 2, 2,   9, 9, 9,   7, 7
+    };
+    JMath::StridedView<float> points(buffer.data(), 3, 8 * sizeof(float));
+
+    EXPECT_EQ(points.size(), 3u);
+    EXPECT_EQ(points[1][1], 4.0f);
+    EXPECT_NEAR(JMath::length(points[0], points[1]), 5.0f, 1e-6f);
+    EXPECT_NEAR(JMath::length(points[0], points[2]), 3.0f, 1e-6f);
+    EXPECT_NEAR(JMath::dot_product(points[1], points[2]), 11.0f, 1e-6f);
+}
+
+TEST(VecLibPointAdapters, StridedColumnMajorBuffer) {
+    // Three points stored as x[], y[], z[] rows of a 3xN array
+    std::vector<double> soa = {
+        0.0, 3.0,   // x
+        0.0, 4.0,   // y
+        0.0, 0.0    // z
+    };
+    JMath::StridedView<double> points(soa.data(), 2, sizeof(double), 2 * sizeof(double));
+
+    EXPECT_EQ(JMath::to_array(points[1]), (std::array<double, 3>{3.0, 4.0, 0.0}));
+    EXPECT_NEAR(JMath::length(points[0], points[1]), 5.0, EPSILON);
+}
+
+TEST(VecLibPointAdapters, UnalignedStridedPoint) {
+    unsigned char bytes[1 + 3 * sizeof(double)];
+    double xyz[3] = {1.0, 2.0, 2.0};
+    memcpy(bytes + 1, xyz, sizeof(xyz));
+
+    JMath::StridedPoint<double> p(bytes + 1);
+    EXPECT_NEAR(JMath::magnitude(p), 3.0, EPSILON);
+}
+
+TEST(VecLibPointAdapters, ExplicitCoordinateType) {
+    std::array<double, 3> a = {3.0, 4.0, 0.0};
+    std::array<double, 3> b = {0.0, 0.0, 0.0};
+
+    EXPECT_NEAR(JMath::length<double>(a, b), 5.0, EPSILON);
+    EXPECT_NEAR(JMath::length2<double>(a, b), 25.0, EPSILON);
+    EXPECT_NEAR(JMath::magnitude<double>(a), 5.0, EPSILON);
+    EXPECT_NEAR(JMath::dot_product<double>(a, a), 25.0, EPSILON);
+    EXPECT_EQ(JMath::cross_product<double>(a, a), b);
+    EXPECT_EQ(JMath::make_vector<double>(a, b), a);
+    EXPECT_NEAR(JMath::unit_vector<double>(a)[0], 0.6, EPSILON);
+    EXPECT_NEAR(JMath::angle<double>(a, std::array<double, 3>{0.0, 0.0, 1.0}), M_PI/2, EPSILON);
+}
+
 // ============================================================================
 // Edge Cases
 // ============================================================================
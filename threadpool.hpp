@@ -0,0 +1,139 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace JMath
+{
+///////////////////////////////////////////////////////////////////////////////
+// Fixed-size pool of worker threads for data-parallel loops.
+//
+// parallel_for(ntasks, f) calls f(task, thread) for every task in
+// [0, ntasks) and returns when all of them are done. Tasks are handed out
+// dynamically; thread is in [0, size()) and identifies the executing thread
+// (0 is the calling thread, which takes part in the work), so callers can
+// keep per-thread scratch data without locking.
+//
+// A parallel_for issued from inside a task runs serially on that thread
+// instead of deadlocking the pool. The first exception thrown by a task is
+// rethrown to the caller after the loop has drained.
+///////////////////////////////////////////////////////////////////////////////
+
+class ThreadPool
+{
+public:
+    // nthreads == 0 selects std::thread::hardware_concurrency()
+    explicit ThreadPool( size_t nthreads = 0 )
+    {
+        if( nthreads == 0 ) nthreads = std::thread::hardware_concurrency();
+        if( nthreads == 0 ) nthreads = 1;
+        for( size_t t = 1; t < nthreads; t++)
+            workers.emplace_back( [this, t] { worker_loop(t); } );
+    }
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for( auto &w : workers ) w.join();
+    }
+
+    ThreadPool( const ThreadPool & ) = delete;
+    ThreadPool &operator=( const ThreadPool & ) = delete;
+
+    size_t size() const { return workers.size() + 1; }
+
+    template<class F>
+    void parallel_for( size_t ntasks, F &&f )
+    {
+        if( ntasks == 0 ) return;
+
+        if( workers.empty() || ntasks == 1 || inside_task() ) {
+            for( size_t i = 0; i < ntasks; i++) f(i, 0);
+            return;
+        }
+
+        std::lock_guard<std::mutex> serial(call_mutex);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            job       = [&f]( size_t task, size_t thread ) { f(task, thread); };
+            job_size  = ntasks;
+            next_task = 0;
+            pending   = workers.size();
+            error     = nullptr;
+            generation++;
+        }
+        wake.notify_all();
+
+        run_tasks(0);
+
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait( lock, [this] { return pending == 0; } );
+        job = nullptr;
+        if( error ) std::rethrow_exception(error);
+    }
+
+private:
+    static bool &inside_task()
+    {
+        static thread_local bool flag = false;
+        return flag;
+    }
+
+    void run_tasks( size_t thread )
+    {
+        inside_task() = true;
+        for( ;; ) {
+            size_t task = next_task.fetch_add(1);
+            if( task >= job_size ) break;
+            try {
+                job(task, thread);
+            } catch(...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if( !error ) error = std::current_exception();
+                next_task = job_size;
+            }
+        }
+        inside_task() = false;
+    }
+
+    void worker_loop( size_t thread )
+    {
+        size_t seen = 0;
+        for( ;; ) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait( lock, [&] { return stopping || generation != seen; } );
+                if( stopping ) return;
+                seen = generation;
+            }
+            run_tasks(thread);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                pending--;
+            }
+            done.notify_one();
+        }
+    }
+
+    std::vector<std::thread> workers;
+    std::mutex               mutex, call_mutex;
+    std::condition_variable  wake, done;
+
+    std::function<void(size_t,size_t)> job;
+    size_t                   job_size   = 0;
+    std::atomic<size_t>      next_task{0};
+    size_t                   pending    = 0;
+    size_t                   generation = 0;
+    bool                     stopping   = false;
+    std::exception_ptr       error;
+};
+}
@@ -0,0 +1,265 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "threadpool.hpp"
+#include "trimesh.hpp"
+
+///////////////////////////////////////////////////////////////////////////////
+// Connectivity of indexed meshes.
+//
+// VertexCorners lists the corners (3*face + k) around every vertex in CSR
+// form. Its parallel build counts and places corners with relaxed atomic
+// increments on per-vertex counters (distinct vertices, so hardly any
+// contention) and then sorts each vertex's few corners, which gives the
+// same lists as the serial build.
+//
+// CornerTable is an index-based half-edge structure on top of it. Half-edge
+// h = 3*f + k runs from corner k of face f to corner k+1, so next, prev and
+// face are arithmetic and only the origins and twins are stored (24 bytes a
+// face, plus the CSR). Bucketing the half-edges by origin vertex is a
+// counting sort of the edge keys on their first vertex. Each vertex's
+// half-edges are then sorted by target, so the twin of v -> w is a binary
+// search among the half-edges leaving w and high-valence fan vertices cost
+// O(d log d); one thread handles each vertex range with no shared writes. An
+// edge with one half-edge is on the boundary. Edges with more than two
+// half-edges, with two of the same direction (inconsistent orientation) are
+// non-manifold and their half-edges get no twin; so are the half-edges of
+// faces with a repeated vertex, which are left out of the matching.
+///////////////////////////////////////////////////////////////////////////////
+
+class VertexCorners
+{
+public:
+    VertexCorners() = default;
+
+    // Mesh is IndexedMeshView<T> or anything else with nvertices(), nfaces()
+    // and face(f) returning three vertex indices
+    template<class Mesh>
+    explicit VertexCorners( const Mesh &mesh ) { build(mesh); }
+
+    template<class Mesh>
+    VertexCorners( JMath::ThreadPool &pool, const Mesh &mesh ) { build(pool, mesh); }
+
+    template<class Mesh>
+    void build( const Mesh &mesh )
+    {
+        const size_t nv = mesh.nvertices(), nf = mesh.nfaces();
+        offsets.assign( nv + 1, 0 );
+        for( size_t f = 0; f < nf; f++)
+            for( int v : mesh.face(f) ) offsets[v + 1]++;
+        for( size_t v = 0; v < nv; v++) offsets[v+1] += offsets[v];
+
+        members.resize( offsets[nv] );
+        std::vector<uint32_t> next( offsets.begin(), offsets.end() - 1 );
+        for( size_t f = 0; f < nf; f++) {
+            auto ids = mesh.face(f);
+            for( int k = 0; k < 3; k++) members[next[ids[k]]++] = (uint32_t)(3*f + k);
+        }
+    }
+
+    template<class Mesh>
+    void build( JMath::ThreadPool &pool, const Mesh &mesh )
+    {
+        const size_t nv = mesh.nvertices(), nf = mesh.nfaces();
+        const size_t block = 4096;
+
+        std::vector<std::atomic<uint32_t>> count( nv );
+        pool.parallel_for( (nv + block - 1)/block, [&]( size_t b, size_t ) {
+            for( size_t v = b*block; v < std::min(nv, (b + 1)*block); v++)
+                count[v].store( 0, std::memory_order_relaxed );
+        });
+        pool.parallel_for( (nf + block - 1)/block, [&]( size_t b, size_t ) {
+            for( size_t f = b*block; f < std::min(nf, (b + 1)*block); f++)
+                for( int v : mesh.face(f) ) count[v].fetch_add( 1, std::memory_order_relaxed );
+        });
+
+        offsets.resize( nv + 1 );
+        offsets[0] = 0;
+        for( size_t v = 0; v < nv; v++) {
+            offsets[v+1] = offsets[v] + count[v].load( std::memory_order_relaxed );
+            count[v].store( offsets[v], std::memory_order_relaxed );
+        }
+
+        members.resize( offsets[nv] );
+        pool.parallel_for( (nf + block - 1)/block, [&]( size_t b, size_t ) {
+            for( size_t f = b*block; f < std::min(nf, (b + 1)*block); f++) {
+                auto ids = mesh.face(f);
+                for( int k = 0; k < 3; k++)
+                    members[count[ids[k]].fetch_add( 1, std::memory_order_relaxed )] = (uint32_t)(3*f + k);
+            }
+        });
+        pool.parallel_for( (nv + block - 1)/block, [&]( size_t b, size_t ) {
+            for( size_t v = b*block; v < std::min(nv, (b + 1)*block); v++)
+                std::sort( members.begin() + offsets[v], members.begin() + offsets[v+1] );
+        });
+    }
+
+    size_t nvertices() const { return offsets.empty() ? 0 : offsets.size() - 1; }
+
+    // Corners of vertex v are corners()[offsets()[v] .. offsets()[v+1]), in
+    // increasing order; corner c is corner c%3 of face c/3
+    const std::vector<uint32_t> &corner_offsets() const { return offsets; }
+    const std::vector<uint32_t> &corners()        const { return members; }
+
+private:
+    std::vector<uint32_t> offsets, members;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+class CornerTable
+{
+public:
+    // twin() of half-edges without a partner
+    static const int BOUNDARY    = -1;
+    static const int NONMANIFOLD = -2;
+
+    CornerTable() = default;
+
+    // Mesh is IndexedMeshView<T> or anything else with nvertices(), nfaces()
+    // and face(f) returning three vertex indices
+    template<class Mesh>
+    explicit CornerTable( const Mesh &mesh ) { build(mesh); }
+
+    template<class Mesh>
+    CornerTable( JMath::ThreadPool &pool, const Mesh &mesh ) { build(pool, mesh); }
+
+    template<class Mesh>
+    void build( const Mesh &mesh )
+    {
+        vc.build( mesh );
+        origins.resize( 3*mesh.nfaces() );
+        copy_origins( mesh, 0, mesh.nfaces() );
+        twins.resize( origins.size() );
+        std::unique_ptr<Edge[]> to( new Edge[origins.size()] );   // no zero fill
+        targets( to.get(), 0, vc.nvertices() );
+        link( to.get(), 0, vc.nvertices() );
+        count_open();
+    }
+
+    template<class Mesh>
+    void build( JMath::ThreadPool &pool, const Mesh &mesh )
+    {
+        const size_t block = 4096;
+        const size_t nf    = mesh.nfaces();
+        vc.build( pool, mesh );
+        origins.resize( 3*nf );
+        pool.parallel_for( (nf + block - 1)/block, [&]( size_t b, size_t ) {
+            copy_origins( mesh, b*block, std::min(nf, (b + 1)*block) );
+        });
+
+        const size_t nv = vc.nvertices();
+        twins.resize( origins.size() );
+        std::unique_ptr<Edge[]> to( new Edge[origins.size()] );   // no zero fill
+        pool.parallel_for( (nv + block - 1)/block, [&]( size_t b, size_t ) {
+            targets( to.get(), b*block, std::min(nv, (b + 1)*block) );
+        });
+        pool.parallel_for( (nv + block - 1)/block, [&]( size_t b, size_t ) {
+            link( to.get(), b*block, std::min(nv, (b + 1)*block) );
+        });
+        count_open();
+    }
+
+    size_t nvertices()  const { return vc.nvertices(); }
+    size_t nfaces()     const { return origins.size()/3; }
+    size_t nhalfedges() const { return origins.size(); }
+
+    static int face( int h ) { return h/3; }
+    static int next( int h ) { return h % 3 == 2 ? h - 2 : h + 1; }
+    static int prev( int h ) { return h % 3 == 0 ? h + 2 : h - 1; }
+
+    int origin( int h ) const { return origins[h]; }
+    int target( int h ) const { return origins[next(h)]; }
+
+    // Opposite half-edge, or BOUNDARY / NONMANIFOLD
+    int  twin( int h )           const { return twins[h]; }
+    bool is_boundary( int h )    const { return twins[h] == BOUNDARY; }
+    bool is_nonmanifold( int h ) const { return twins[h] == NONMANIFOLD; }
+
+    // Face across edge k (corner k to corner k+1) of face f, -1 if none
+    int adjacent_face( int f, int k ) const
+    {
+        int t = twins[3*f + k];
+        return t >= 0 ? face(t) : -1;
+    }
+
+    size_t boundary_halfedges()    const { return nboundary; }
+    size_t nonmanifold_halfedges() const { return nnonmanifold; }
+
+    // Every edge has exactly two consistently oriented half-edges
+    bool is_closed_manifold() const { return nboundary == 0 && nnonmanifold == 0; }
+
+    // The half-edges leaving vertex v are its corners
+    const VertexCorners &vertex_corners() const { return vc; }
+
+private:
+    VertexCorners    vc;
+    std::vector<int> origins, twins;
+    size_t           nboundary = 0, nnonmanifold = 0;
+
+    struct Edge
+    {
+        int target, h;
+        bool operator<( const Edge &o ) const { return target < o.target || (target == o.target && h < o.h); }
+    };
+
+    template<class Mesh>
+    void copy_origins( const Mesh &mesh, size_t first, size_t last )
+    {
+        for( size_t f = first; f < last; f++) {
+            auto ids = mesh.face(f);
+            for( int k = 0; k < 3; k++) origins[3*f + k] = ids[k];
+        }
+    }
+
+    // to[j] = (target, half-edge) of the j-th half-edge of the CSR, for
+    // vertices [first, last), sorted by target within each vertex; the target
+    // is -1 for the half-edges of faces with a repeated vertex
+    void targets( Edge *to, size_t first, size_t last ) const
+    {
+        const uint32_t *offsets = vc.corner_offsets().data();
+        const uint32_t *out     = vc.corners().data();
+        for( size_t v = first; v < last; v++) {
+            for( uint32_t j = offsets[v]; j < offsets[v+1]; j++) {
+                int h = (int)out[j], f = 3*face(h);
+                bool repeated = origins[f] == origins[f+1] || origins[f+1] == origins[f+2] || origins[f+2] == origins[f];
+                to[j] = Edge{ repeated ? -1 : target(h), h };
+            }
+            std::sort( to + offsets[v], to + offsets[v+1] );
+        }
+    }
+
+    // Twins of the half-edges leaving vertices [first, last): every run of
+    // half-edges v -> w is matched against the equal range of w -> v
+    void link( const Edge *to, size_t first, size_t last )
+    {
+        const uint32_t *offsets = vc.corner_offsets().data();
+        for( size_t v = first; v < last; v++)
+            for( uint32_t j = offsets[v], k; j < offsets[v+1]; j = k) {
+                const int w = to[j].target;
+                for( k = j + 1; k < offsets[v+1] && to[k].target == w; k++);
+
+                int t = NONMANIFOLD;
+                if( w >= 0 && k - j == 1 ) {
+                    auto r = std::equal_range( to + offsets[w], to + offsets[w+1], Edge{ (int)v, 0 },
+                                               []( const Edge &a, const Edge &b ) { return a.target < b.target; } );
+                    if( r.second - r.first == 0 ) t = BOUNDARY;
+                    if( r.second - r.first == 1 ) t = r.first->h;
+                }
+                for( uint32_t i = j; i < k; i++) twins[to[i].h] = t;
+            }
+    }
+    void count_open()
+    {
+        nboundary = nnonmanifold = 0;
+        for( int t : twins ) {
+            nboundary    += t == BOUNDARY;
+            nnonmanifold += t == NONMANIFOLD;
+        }
+    }
+};
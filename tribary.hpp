@@ -0,0 +1,197 @@
+#pragma once
+
+#include <limits>
+
+#include "tribatch.hpp"
+#include "trimesh.hpp"
+
+///////////////////////////////////////////////////////////////////////////////
+// Precomputed barycentric frames.
+//
+// barycoordinates() in trilib.hpp derives the weights from four Heron areas
+// per query, and the areas are unsigned, so points outside the triangle get
+// positive weights. A BaryFrame is built once per triangle and stores the
+// origin pa and two dual vectors g1, g2 (nine numbers) with
+//
+//   l1 = g1.(q - pa),  l2 = g2.(q - pa),  l0 = 1 - l1 - l2
+//
+// which costs three subtractions and two dot products per query. The weights
+// are signed (negative outside the opposite edge) and are those of the
+// orthogonal projection of q onto the triangle's plane.
+//
+// A degenerate or nearly flat triangle (sine of the angle at pa below about
+// 1.5e-8) has no frame: its dual vectors are not finite and valid() returns
+// false.
+///////////////////////////////////////////////////////////////////////////////
+
+template<class T>
+struct BaryFrame
+{
+    std::array<T,3> origin = {0, 0, 0};
+    std::array<T,3> g1     = {0, 0, 0};
+    std::array<T,3> g2     = {0, 0, 0};
+
+    BaryFrame() = default;
+
+    template<class P>
+    BaryFrame( const P &pa, const P &pb, const P &pc)
+    {
+        // The dual vectors are built in double for any T from the normal
+        // n = e1 x e2 as g1 = (e2 x n)/|n|^2 and g2 = (n x e1)/|n|^2. |n|^2
+        // is the Gram determinant d00*d11 - d01^2 without its cancellation
+        // for slivers; relative to d00*d11 it is the squared sine of the
+        // angle at pa, and below machine epsilon the frame is rejected.
+        double e1[3], e2[3];
+        for( int j = 0; j < 3; j++) {
+            e1[j] = (double)pb[j] - pa[j];
+            e2[j] = (double)pc[j] - pa[j];
+        }
+        double d00 = e1[0]*e1[0] + e1[1]*e1[1] + e1[2]*e1[2];
+        double d11 = e2[0]*e2[0] + e2[1]*e2[1] + e2[2]*e2[2];
+        double n[3] = { e1[1]*e2[2] - e1[2]*e2[1],
+                        e1[2]*e2[0] - e1[0]*e2[2],
+                        e1[0]*e2[1] - e1[1]*e2[0] };
+        double det = n[0]*n[0] + n[1]*n[1] + n[2]*n[2];
+        double inv = det > std::numeric_limits<double>::epsilon()*d00*d11
+                   ? 1.0/det : std::numeric_limits<double>::quiet_NaN();
+
+        for( int j = 0; j < 3; j++) {
+            int j1 = (j + 1) % 3, j2 = (j + 2) % 3;
+            origin[j] = pa[j];
+            g1[j]     = (e2[j1]*n[j2] - e2[j2]*n[j1])*inv;
+            g2[j]     = (n[j1]*e1[j2] - n[j2]*e1[j1])*inv;
+        }
+    }
+
+    bool valid() const
+    {
+        for( int j = 0; j < 3; j++)
+            if( !std::isfinite(g1[j]) || !std::isfinite(g2[j]) ) return false;
+        return true;
+    }
+
+    template<class Q>
+    std::array<T,3> operator()( const Q &q ) const
+    {
+        T vx = q[0] - origin[0], vy = q[1] - origin[1], vz = q[2] - origin[2];
+        T l1 = g1[0]*vx + g1[1]*vy + g1[2]*vz;
+        T l2 = g2[0]*vx + g2[1]*vy + g2[2]*vz;
+        return { 1 - l1 - l2, l1, l2 };
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Frames for every face of a TriangleBatch or mesh view, stored as nine
+// streams like TriangleBatch.
+
+template<class T>
+class BaryFrameBatch
+{
+public:
+    BaryFrameBatch() = default;
+
+    // Mesh is TriangleBatch<T>, IndexedMeshView<T>, TriangleSoupView<T>, or
+    // anything else with nfaces() and corner(face, k)
+    template<class Mesh>
+    explicit BaryFrameBatch( const Mesh &mesh ) { build(mesh); }
+
+    template<class Mesh>
+    void build( const Mesh &mesh )
+    {
+        const size_t n = mesh.nfaces();
+        for( int j = 0; j < 3; j++) {
+            o[j].resize(n);
+            u[j].resize(n);
+            v[j].resize(n);
+        }
+        for( size_t f = 0; f < n; f++) {
+            BaryFrame<T> fr( mesh.corner(f,0), mesh.corner(f,1), mesh.corner(f,2) );
+            set( f, fr );
+        }
+    }
+
+    size_t size() const { return o[0].size(); }
+
+    BaryFrame<T> frame( size_t f ) const
+    {
+        BaryFrame<T> fr;
+        for( int j = 0; j < 3; j++) {
+            fr.origin[j] = o[j][f];
+            fr.g1[j]     = u[j][f];
+            fr.g2[j]     = v[j][f];
+        }
+        return fr;
+    }
+
+    template<class Q>
+    std::array<T,3> operator()( size_t f, const Q &q ) const
+    {
+        T vx = q[0] - o[0][f], vy = q[1] - o[1][f], vz = q[2] - o[2][f];
+        T l1 = u[0][f]*vx + u[1][f]*vy + u[2][f]*vz;
+        T l2 = v[0][f]*vx + v[1][f]*vy + v[2][f]*vz;
+        return { 1 - l1 - l2, l1, l2 };
+    }
+
+    const T *origin( int j ) const { return o[j].data(); }
+    const T *g1( int j )     const { return u[j].data(); }
+    const T *g2( int j )     const { return v[j].data(); }
+
+private:
+    void set( size_t f, const BaryFrame<T> &fr )
+    {
+        for( int j = 0; j < 3; j++) {
+            o[j][f] = fr.origin[j];
+            u[j][f] = fr.g1[j];
+            v[j][f] = fr.g2[j];
+        }
+    }
+
+    std::array<std::vector<T>,3> o, u, v;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Batched evaluation. Query points and results are coordinate streams of n
+// entries, as in the TriangleBatch kernels.
+
+// n points against one triangle
+template<class T>
+inline void barycoordinates( const BaryFrame<T> &fr, size_t n,
+                             const T *qx, const T *qy, const T *qz,
+                             T *l0, T *l1, T *l2)
+{
+    const T ox = fr.origin[0], oy = fr.origin[1], oz = fr.origin[2];
+    const T ux = fr.g1[0], uy = fr.g1[1], uz = fr.g1[2];
+    const T vx = fr.g2[0], vy = fr.g2[1], vz = fr.g2[2];
+
+    for( size_t i = 0; i < n; i++) {
+        T dx = qx[i] - ox, dy = qy[i] - oy, dz = qz[i] - oz;
+        T a  = ux*dx + uy*dy + uz*dz;
+        T b  = vx*dx + vy*dy + vz*dz;
+        l0[i] = 1 - a - b;
+        l1[i] = a;
+        l2[i] = b;
+    }
+}
+
+// Point i against face faces[i]
+template<class T>
+inline void barycoordinates( const BaryFrameBatch<T> &frames, size_t n, const int *faces,
+                             const T *qx, const T *qy, const T *qz,
+                             T *l0, T *l1, T *l2)
+{
+    const T *ox = frames.origin(0), *oy = frames.origin(1), *oz = frames.origin(2);
+    const T *ux = frames.g1(0),     *uy = frames.g1(1),     *uz = frames.g1(2);
+    const T *vx = frames.g2(0),     *vy = frames.g2(1),     *vz = frames.g2(2);
+
+    for( size_t i = 0; i < n; i++) {
+        const int f = faces[i];
+        T dx = qx[i] - ox[f], dy = qy[i] - oy[f], dz = qz[i] - oz[f];
+        T a  = ux[f]*dx + uy[f]*dy + uz[f]*dz;
+        T b  = vx[f]*dx + vy[f]*dy + vz[f]*dz;
+        l0[i] = 1 - a - b;
+        l1[i] = a;
+        l2[i] = b;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
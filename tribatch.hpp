@@ -0,0 +1,244 @@
+#pragma once
+
+#include "trilib.hpp"
+
+///////////////////////////////////////////////////////////////////////////////
+// Structure-of-arrays storage for many triangles.
+//
+// Corner k (0,1,2 for pa,pb,pc) of triangle i is stored as
+// (x(k)[i], y(k)[i], z(k)[i]), i.e. nine separate coordinate streams. The
+// batch kernels below walk these streams with unit stride, which lets the
+// compiler vectorize across triangles instead of within one.
+//
+// Every kernel writes into caller-provided output arrays holding at least
+// size() entries and uses the same arithmetic as its scalar counterpart in
+// trilib.hpp.
+///////////////////////////////////////////////////////////////////////////////
+
+template<class T>
+class TriangleBatch
+{
+public:
+    using value_type = T;
+
+    TriangleBatch() = default;
+    explicit TriangleBatch( size_t n ) { resize(n); }
+
+    size_t size()  const { return xs[0].size(); }
+    bool   empty() const { return xs[0].empty(); }
+
+    void resize( size_t n )
+    {
+        for( int k = 0; k < 3; k++) {
+            xs[k].resize(n);
+            ys[k].resize(n);
+            zs[k].resize(n);
+        }
+    }
+
+    void reserve( size_t n )
+    {
+        for( int k = 0; k < 3; k++) {
+            xs[k].reserve(n);
+            ys[k].reserve(n);
+            zs[k].reserve(n);
+        }
+    }
+
+    void clear() { resize(0); }
+
+    void push_back( const std::array<T,3> &pa,
+                    const std::array<T,3> &pb,
+                    const std::array<T,3> &pc)
+    {
+        push_back<std::array<T,3>>( pa, pb, pc);
+    }
+
+    // Any point type accepted by veclib (see JMath::point_traits)
+    template<class P>
+    void push_back( const P &pa, const P &pb, const P &pc)
+    {
+        resize( size() + 1 );
+        set( size() - 1, pa, pb, pc);
+    }
+
+    template<class P>
+    void set( size_t i, const P &pa, const P &pb, const P &pc)
+    {
+        const P *p[3] = { &pa, &pb, &pc };
+        for( int k = 0; k < 3; k++) {
+            xs[k][i] = (*p[k])[0];
+            ys[k][i] = (*p[k])[1];
+            zs[k][i] = (*p[k])[2];
+        }
+    }
+
+    std::array<T,3> vertex( size_t i, int k ) const
+    {
+        return { xs[k][i], ys[k][i], zs[k][i] };
+    }
+
+    // Same face interface as IndexedMeshView, for mesh-level algorithms
+    size_t          nfaces() const { return size(); }
+    std::array<T,3> corner( size_t f, int k ) const { return vertex(f, k); }
+
+    const T *x( int k ) const { return xs[k].data(); }
+    const T *y( int k ) const { return ys[k].data(); }
+    const T *z( int k ) const { return zs[k].data(); }
+    T       *x( int k )       { return xs[k].data(); }
+    T       *y( int k )       { return ys[k].data(); }
+    T       *z( int k )       { return zs[k].data(); }
+
+private:
+    std::array<std::vector<T>,3> xs, ys, zs;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+template<class T>
+inline void area( const TriangleBatch<T> &batch, T *out)
+{
+    const T *x0 = batch.x(0), *y0 = batch.y(0), *z0 = batch.z(0);
+    const T *x1 = batch.x(1), *y1 = batch.y(1), *z1 = batch.z(1);
+    const T *x2 = batch.x(2), *y2 = batch.y(2), *z2 = batch.z(2);
+
+    const size_t n = batch.size();
+    for( size_t i = 0; i < n; i++) {
+        double ax = x1[i] - x2[i], ay = y1[i] - y2[i], az = z1[i] - z2[i];
+        double bx = x2[i] - x0[i], by = y2[i] - y0[i], bz = z2[i] - z0[i];
+        double cx = x0[i] - x1[i], cy = y0[i] - y1[i], cz = z0[i] - z1[i];
+        T a = sqrt( ax*ax + ay*ay + az*az );
+        T b = sqrt( bx*bx + by*by + bz*bz );
+        T c = sqrt( cx*cx + cy*cy + cz*cz );
+        T s = 0.5*(a+b+c);
+        out[i] = sqrt(s*(s-a)*(s-b)*(s-c));
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template<class T>
+inline void normal( const TriangleBatch<T> &batch, T *nx, T *ny, T *nz)
+{
+    const T *x0 = batch.x(0), *y0 = batch.y(0), *z0 = batch.z(0);
+    const T *x1 = batch.x(1), *y1 = batch.y(1), *z1 = batch.z(1);
+    const T *x2 = batch.x(2), *y2 = batch.y(2), *z2 = batch.z(2);
+
+    const size_t n = batch.size();
+    for( size_t i = 0; i < n; i++) {
+        T ux = x1[i] - x0[i], uy = y1[i] - y0[i], uz = z1[i] - z0[i];
+        T vx = x2[i] - x0[i], vy = y2[i] - y0[i], vz = z2[i] - z0[i];
+        T cx = uy*vz - uz*vy;
+        T cy = uz*vx - ux*vz;
+        T cz = ux*vy - uy*vx;
+        double mag = (T)sqrt( cx*cx + cy*cy + cz*cz );
+        nx[i] = cx/mag;
+        ny[i] = cy/mag;
+        nz[i] = cz/mag;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template<class T>
+inline void centroid( const TriangleBatch<T> &batch, T *cx, T *cy, T *cz)
+{
+    const T *x0 = batch.x(0), *y0 = batch.y(0), *z0 = batch.z(0);
+    const T *x1 = batch.x(1), *y1 = batch.y(1), *z1 = batch.z(1);
+    const T *x2 = batch.x(2), *y2 = batch.y(2), *z2 = batch.z(2);
+
+    const size_t n = batch.size();
+    for( size_t i = 0; i < n; i++) {
+        cx[i] = (x0[i] + x1[i] + x2[i])/3.0;
+        cy[i] = (y0[i] + y1[i] + y2[i])/3.0;
+        cz[i] = (z0[i] + z1[i] + z2[i])/3.0;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Trig is TrigExact, TrigFine or TrigCoarse (fastmath.hpp)
+template<class T, class Trig>
+inline void angles( const TriangleBatch<T> &batch, T *a0, T *a1, T *a2,
+                    int measure, Trig)
+{
+    const T *x0 = batch.x(0), *y0 = batch.y(0), *z0 = batch.z(0);
+    const T *x1 = batch.x(1), *y1 = batch.y(1), *z1 = batch.z(1);
+    const T *x2 = batch.x(2), *y2 = batch.y(2), *z2 = batch.z(2);
+
+    const double scale = (measure == ANGLE_IN_DEGREES) ? 180/M_PI : 1.0;
+
+    const size_t n = batch.size();
+    for( size_t i = 0; i < n; i++) {
+        double ax = (double)x1[i] - x2[i], ay = (double)y1[i] - y2[i], az = (double)z1[i] - z2[i];
+        double bx = (double)x2[i] - x0[i], by = (double)y2[i] - y0[i], bz = (double)z2[i] - z0[i];
+        double cx = (double)x0[i] - x1[i], cy = (double)y0[i] - y1[i], cz = (double)z0[i] - z1[i];
+        double la2 = ax*ax + ay*ay + az*az;
+        double lb2 = bx*bx + by*by + bz*bz;
+        double lc2 = cx*cx + cy*cy + cz*cz;
+
+        double cosA = (lb2 + lc2 - la2)/(2*sqrt(lb2*lc2) );
+        double cosB = (la2 + lc2 - lb2)/(2*sqrt(la2*lc2) );
+        double cosC = (la2 + lb2 - lc2)/(2*sqrt(la2*lb2) );
+        cosA = cosA > 1.0 ? 1.0 : (cosA < -1.0 ? -1.0 : cosA);
+        cosB = cosB > 1.0 ? 1.0 : (cosB < -1.0 ? -1.0 : cosB);
+        cosC = cosC > 1.0 ? 1.0 : (cosC < -1.0 ? -1.0 : cosC);
+
+        a0[i] = (T)Trig::acos(cosA)*scale;
+        a1[i] = (T)Trig::acos(cosB)*scale;
+        a2[i] = (T)Trig::acos(cosC)*scale;
+    }
+}
+
+template<class T>
+inline void angles( const TriangleBatch<T> &batch, T *a0, T *a1, T *a2,
+                    int measure = ANGLE_IN_DEGREES, TrigAccuracy accuracy = TRIG_EXACT)
+{
+    with_trig( accuracy, [&]( auto trig ) { angles( batch, a0, a1, a2, measure, trig ); });
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template<class T>
+inline void circumradius( const TriangleBatch<T> &batch, T *out)
+{
+    const T *x0 = batch.x(0), *y0 = batch.y(0), *z0 = batch.z(0);
+    const T *x1 = batch.x(1), *y1 = batch.y(1), *z1 = batch.z(1);
+    const T *x2 = batch.x(2), *y2 = batch.y(2), *z2 = batch.z(2);
+
+    const size_t n = batch.size();
+    for( size_t i = 0; i < n; i++) {
+        double ax = x1[i] - x2[i], ay = y1[i] - y2[i], az = z1[i] - z2[i];
+        double bx = x2[i] - x0[i], by = y2[i] - y0[i], bz = z2[i] - z0[i];
+        double cx = x0[i] - x1[i], cy = y0[i] - y1[i], cz = z0[i] - z1[i];
+        T a = sqrt( ax*ax + ay*ay + az*az );
+        T b = sqrt( bx*bx + by*by + bz*bz );
+        T c = sqrt( cx*cx + cy*cy + cz*cz );
+        T s = 0.5*(a+b+c);
+        out[i] = 0.25*a*b*c/sqrt(s*(s-a)*(s-b)*(s-c));
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template<class T>
+inline void inradius( const TriangleBatch<T> &batch, T *out)
+{
+    const T *x0 = batch.x(0), *y0 = batch.y(0), *z0 = batch.z(0);
+    const T *x1 = batch.x(1), *y1 = batch.y(1), *z1 = batch.z(1);
+    const T *x2 = batch.x(2), *y2 = batch.y(2), *z2 = batch.z(2);
+
+    const size_t n = batch.size();
+    for( size_t i = 0; i < n; i++) {
+        double ax = x1[i] - x2[i], ay = y1[i] - y2[i], az = z1[i] - z2[i];
+        double bx = x2[i] - x0[i], by = y2[i] - y0[i], bz = z2[i] - z0[i];
+        double cx = x0[i] - x1[i], cy = y0[i] - y1[i], cz = z0[i] - z1[i];
+        T a = sqrt( ax*ax + ay*ay + az*az );
+        T b = sqrt( bx*bx + by*by + bz*bz );
+        T c = sqrt( cx*cx + cy*cy + cz*cz );
+        T s = a+b+c;
+        out[i] = 0.5*sqrt((b+c-a)*(c+a-b)*(a+b-c)/s);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,681 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include "threadpool.hpp"
+#include "tribatch.hpp"
+#include "triclosest.hpp"
+#include "trimesh.hpp"
+#include "triray.hpp"
+
+///////////////////////////////////////////////////////////////////////////////
+// Bounding volume hierarchy over the faces of a mesh.
+//
+// The tree is built top-down with binned SAH splits (16 bins over the face
+// box centroids along their widest axis, Wald 2007) down to leaves of at
+// most max_leaf faces. The bins also carry the bounds of the faces that fall
+// in them, so each level takes one binning and one partitioning pass. The
+// upper levels are split on the calling thread with the binning passes
+// spread over a thread pool; once a range is small enough its whole subtree
+// becomes one pool task. Split decisions depend only on the faces,
+// so the tree is identical for any thread count.
+//
+// Nodes are stored depth-first in one array: the left child of an inner node
+// is the next node and index holds the right child; a leaf holds count faces
+// starting at index. The leaf faces are copied, in leaf order, into a
+// TriangleBatch so that a leaf is a contiguous run of each coordinate stream.
+//
+// Queries report original face ids and barycentrics relative to the face's
+// corners 0, 1, 2:
+//
+//   intersect(ray, hit)       nearest hit within [ray.tmin, ray.tmax]
+//   closest_point(q)          closest surface point to q
+//   overlap(lo, hi, f)        f(face) for every face touching the box
+///////////////////////////////////////////////////////////////////////////////
+
+// Separating axis test between a triangle and the box [lo, hi]
+// (Akenine-Moller, "Fast 3D Triangle-Box Overlap Testing", 2001)
+template<class P, class B>
+inline bool triangle_box_overlap( const P &pa, const P &pb, const P &pc,
+                                  const B &lo, const B &hi)
+{
+    double h[3], v[3][3];
+    for( int j = 0; j < 3; j++) {
+        double c = 0.5*((double)lo[j] + hi[j]);
+        h[j]    = 0.5*((double)hi[j] - lo[j]);
+        v[0][j] = pa[j] - c;
+        v[1][j] = pb[j] - c;
+        v[2][j] = pc[j] - c;
+    }
+
+    auto separated = [&]( const double a[3] ) {
+        double p0 = a[0]*v[0][0] + a[1]*v[0][1] + a[2]*v[0][2];
+        double p1 = a[0]*v[1][0] + a[1]*v[1][1] + a[2]*v[1][2];
+        double p2 = a[0]*v[2][0] + a[1]*v[2][1] + a[2]*v[2][2];
+        double r  = h[0]*std::abs(a[0]) + h[1]*std::abs(a[1]) + h[2]*std::abs(a[2]);
+        return min_value(p0, p1, p2) > r || max_value(p0, p1, p2) < -r;
+    };
+
+    double e[3][3];
+    for( int i = 0; i < 3; i++)
+        for( int j = 0; j < 3; j++) e[i][j] = v[(i+1)%3][j] - v[i][j];
+
+    // box face normals
+    for( int j = 0; j < 3; j++) {
+        double a[3] = {0, 0, 0};
+        a[j] = 1;
+        if( separated(a) ) return false;
+    }
+
+    // triangle normal
+    double n[3] = { e[0][1]*e[1][2] - e[0][2]*e[1][1],
+                    e[0][2]*e[1][0] - e[0][0]*e[1][2],
+                    e[0][0]*e[1][1] - e[0][1]*e[1][0] };
+    if( separated(n) ) return false;
+
+    // edge x box axis
+    for( int i = 0; i < 3; i++) {
+        double a0[3] = { 0, e[i][2], -e[i][1] };
+        double a1[3] = { -e[i][2], 0, e[i][0] };
+        double a2[3] = { e[i][1], -e[i][0], 0 };
+        if( separated(a0) || separated(a1) || separated(a2) ) return false;
+    }
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template<class T>
+class TriangleBVH
+{
+public:
+    struct Node
+    {
+        T        lo[3];
+        T        hi[3];
+        uint32_t index;   // inner: right child, leaf: first face in leaf order
+        uint32_t count;   // faces in a leaf, 0 for an inner node
+
+        bool leaf() const { return count != 0; }
+    };
+
+    TriangleBVH() = default;
+
+    // Mesh is TriangleBatch<T>, IndexedMeshView<T>, TriangleSoupView<T>, or
+    // anything else with nfaces() and corner(face, k). nthreads == 0 uses
+    // every hardware thread. Meshes of more than INT_MAX faces throw
+    // std::length_error.
+    template<class Mesh>
+    explicit TriangleBVH( const Mesh &mesh, size_t nthreads = 0, int max_leaf = 4 )
+    {
+        build( mesh, nthreads, max_leaf );
+    }
+
+    template<class Mesh>
+    void build( const Mesh &mesh, size_t nthreads = 0, int max_leaf = 4 );
+
+    size_t nfaces() const { return faces.size(); }
+    bool   empty()  const { return faces.empty(); }
+
+    const std::vector<Node> &nodes()     const { return tree; }
+    const TriangleBatch<T>  &triangles() const { return tris; }
+
+    // Original id of the i-th face in leaf order
+    int face( size_t i ) const { return faces[i]; }
+
+    // Nearest hit, if any, is stored in hit
+    bool intersect( const Ray<T> &ray, RayHit<T> &hit ) const;
+
+    RayHit<T> intersect( const Ray<T> &ray ) const
+    {
+        RayHit<T> hit;
+        intersect( ray, hit );
+        return hit;
+    }
+
+    // Closest point of the mesh to q among points closer than sqrt(max_dist2);
+    // face is -1 if there is none
+    template<class Q>
+    ClosestPoint<T> closest_point( const Q &q,
+                                   T max_dist2 = std::numeric_limits<T>::infinity() ) const;
+
+    template<class B, class F>
+    void overlap( const B &lo, const B &hi, F f ) const;
+
+    template<class B>
+    std::vector<int> overlap( const B &lo, const B &hi ) const
+    {
+        std::vector<int> result;
+        overlap( lo, hi, [&result]( int f ) { result.push_back(f); } );
+        return result;
+    }
+
+private:
+    static constexpr int      NBINS     = 16;
+    static constexpr int      MAX_DEPTH = 64;    // SAH gives way to median splits below this
+    static constexpr int      STACK     = 128;
+    static constexpr uint32_t DEFERRED  = std::numeric_limits<uint32_t>::max();
+
+    struct Box
+    {
+        T lo[3] = {  std::numeric_limits<T>::max(),  std::numeric_limits<T>::max(),
+                     std::numeric_limits<T>::max() };
+        T hi[3] = { -std::numeric_limits<T>::max(), -std::numeric_limits<T>::max(),
+                    -std::numeric_limits<T>::max() };
+
+        void grow( const Box &b )
+        {
+            for( int j = 0; j < 3; j++) {
+                lo[j] = std::min( lo[j], b.lo[j] );
+                hi[j] = std::max( hi[j], b.hi[j] );
+            }
+        }
+        void grow( const T p[3] )
+        {
+            for( int j = 0; j < 3; j++) {
+                lo[j] = std::min( lo[j], p[j] );
+                hi[j] = std::max( hi[j], p[j] );
+            }
+        }
+        double half_area() const
+        {
+            double dx = (double)hi[0] - lo[0], dy = (double)hi[1] - lo[1], dz = (double)hi[2] - lo[2];
+            return dx*dy + dy*dz + dz*dx;
+        }
+    };
+
+    struct Bounds
+    {
+        Box box;        // of the faces
+        Box centroids;  // of the face box centers
+
+        void merge( const Bounds &b ) { box.grow(b.box); centroids.grow(b.centroids); }
+    };
+
+    struct Bins
+    {
+        Bounds   bounds[NBINS];
+        uint32_t count[NBINS] = {};
+
+        void merge( const Bins &b )
+        {
+            for( int i = 0; i < NBINS; i++) {
+                bounds[i].merge( b.bounds[i] );
+                count[i] += b.count[i];
+            }
+        }
+    };
+
+    // Face box and id, moved around as a unit while partitioning
+    struct Ref : Box
+    {
+        uint32_t id;
+
+        T center( int j ) const { return (this->lo[j] + this->hi[j])/2; }
+    };
+
+    struct Task
+    {
+        uint32_t begin, end;
+        int      depth;
+        Bounds   bounds;
+    };
+
+    static constexpr uint32_t CHUNK = 1 << 15;
+
+    template<class R, class F>
+    R reduce( uint32_t begin, uint32_t end, F accumulate ) const;
+
+    template<class F>
+    uint32_t partition( uint32_t begin, uint32_t end, F left );
+
+    Bounds bounds( uint32_t begin, uint32_t end ) const;
+
+    uint32_t subdivide( std::vector<Node> &out, uint32_t begin, uint32_t end, int depth,
+                        const Bounds &bounds, std::vector<Task> *defer );
+
+    uint32_t emit( const std::vector<Node> &top, uint32_t i,
+                   const std::vector<std::vector<Node>> &subtrees );
+
+    static bool hit_box( const Node &n, const T o[3], const T inv[3], T tmin, T tmax, T &tenter )
+    {
+        for( int j = 0; j < 3; j++) {
+            T t0 = (n.lo[j] - o[j])*inv[j];
+            T t1 = (n.hi[j] - o[j])*inv[j];
+            if( inv[j] < 0 ) std::swap(t0, t1);
+            // written so that a NaN slab (0*inf) leaves the interval alone
+            tmin = t0 > tmin ? t0 : tmin;
+            tmax = t1 < tmax ? t1 : tmax;
+        }
+        tenter = tmin;
+        return tmin <= tmax;
+    }
+
+    static T box_dist2( const Node &n, const T q[3] )
+    {
+        T d2 = 0;
+        for( int j = 0; j < 3; j++) {
+            T d = std::max( T(0), std::max( n.lo[j] - q[j], q[j] - n.hi[j] ) );
+            d2 += d*d;
+        }
+        return d2;
+    }
+
+    std::vector<Node> tree;
+    TriangleBatch<T>  tris;
+    std::vector<int>  faces;
+
+    // build state
+    std::vector<Ref>   refs, scratch;
+    JMath::ThreadPool *pool      = nullptr;
+    uint32_t           leaf_size = 4;
+    uint32_t           grain     = 0;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+template<class T>
+template<class Mesh>
+void TriangleBVH<T>::build( const Mesh &mesh, size_t nthreads, int max_leaf )
+{
+    // Face ids are reported as int and nodes are indexed with uint32_t
+    if( mesh.nfaces() > (size_t)std::numeric_limits<int>::max() )
+        throw std::length_error( "TriangleBVH::build: more faces than int face ids can hold" );
+
+    const uint32_t n = mesh.nfaces();
+    JMath::ThreadPool threads(nthreads);
+    pool      = &threads;
+    leaf_size = std::max( 1, max_leaf );
+
+    refs.resize( n );
+    if( n > CHUNK ) scratch.resize( n );
+    const uint32_t chunk   = CHUNK;
+    const size_t   nchunks = (n + chunk - 1)/chunk;
+    threads.parallel_for( nchunks, [&]( size_t c, size_t ) {
+        for( uint32_t f = c*chunk; f < std::min<size_t>(n, (c + 1)*chunk); f++) {
+            Ref &r = refs[f];
+            static_cast<Box&>(r) = Box();
+            for( int k = 0; k < 3; k++) {
+                auto p = mesh.corner(f, k);
+                T xyz[3] = { (T)p[0], (T)p[1], (T)p[2] };
+                r.grow( xyz );
+            }
+            r.id = f;
+        }
+    });
+
+    tree.clear();
+    if( n > 0 ) {
+        // Ranges of at most grain faces are built as separate tasks
+        grain = threads.size() > 1 ? std::max<uint32_t>( n/(4*threads.size()), 4096 ) : 0;
+
+        std::vector<Node> top;
+        std::vector<Task> tasks;
+        subdivide( top, 0, n, 0, bounds(0, n), &tasks );
+
+        std::vector<std::vector<Node>> subtrees( tasks.size() );
+        threads.parallel_for( tasks.size(), [&]( size_t t, size_t ) {
+            const Task &task = tasks[t];
+            subdivide( subtrees[t], task.begin, task.end, task.depth, task.bounds, nullptr );
+        });
+
+        size_t total = top.size();
+        for( auto &s : subtrees ) total += s.size();
+        tree.reserve( total );
+        emit( top, 0, subtrees );
+    }
+
+    tris.resize( n );
+    faces.resize( n );
+    threads.parallel_for( nchunks, [&]( size_t c, size_t ) {
+        for( uint32_t i = c*chunk; i < std::min<size_t>(n, (c + 1)*chunk); i++) {
+            const uint32_t f = refs[i].id;
+            tris.set( i, mesh.corner(f, 0), mesh.corner(f, 1), mesh.corner(f, 2) );
+            faces[i] = f;
+        }
+    });
+
+    std::vector<Ref>().swap( refs );
+    std::vector<Ref>().swap( scratch );
+    pool = nullptr;
+}
+
+// Runs accumulate(result, begin, end) over [begin, end), in chunks on the
+// pool when the range is large, and merges the chunk results
+template<class T>
+template<class R, class F>
+R TriangleBVH<T>::reduce( uint32_t begin, uint32_t end, F accumulate ) const
+{
+    R result;
+    if( !pool || pool->size() == 1 || end - begin <= CHUNK ) {
+        accumulate( result, begin, end );
+        return result;
+    }
+
+    const size_t   nchunks = (end - begin + CHUNK - 1)/CHUNK;
+    std::vector<R> partial( nchunks );
+    pool->parallel_for( nchunks, [&]( size_t c, size_t ) {
+        uint32_t b = begin + c*CHUNK;
+        accumulate( partial[c], b, std::min(end, b + CHUNK) );
+    });
+    for( auto &p : partial ) result.merge(p);
+    return result;
+}
+
+// Moves the refs in [begin, end) for which left(ref) holds to the front and
+// returns where the rest start. Large ranges are split stably through the
+// scratch buffer, chunk by chunk on the pool; the choice depends on the
+// range size only, so the resulting order does not depend on the pool.
+template<class T>
+template<class F>
+uint32_t TriangleBVH<T>::partition( uint32_t begin, uint32_t end, F left )
+{
+    Ref *first = refs.data() + begin;
+    if( end - begin <= CHUNK )
+        return begin + (std::partition( first, first + (end - begin), left ) - first);
+
+    const size_t          nchunks = (end - begin + CHUNK - 1)/CHUNK;
+    std::vector<uint32_t> nleft( nchunks ), lpos( nchunks ), rpos( nchunks );
+    pool->parallel_for( nchunks, [&]( size_t c, size_t ) {
+        uint32_t b = begin + c*CHUNK, e = std::min(end, b + CHUNK);
+        nleft[c] = std::count_if( refs.data() + b, refs.data() + e, left );
+    });
+
+    uint32_t split = begin;
+    for( size_t c = 0; c < nchunks; c++) split += nleft[c];
+    for( uint32_t c = 0, l = begin, r = split; c < nchunks; c++) {
+        lpos[c] = l;
+        rpos[c] = r;
+        l += nleft[c];
+        r += std::min(end, begin + (c + 1)*CHUNK) - (begin + c*CHUNK) - nleft[c];
+    }
+
+    pool->parallel_for( nchunks, [&]( size_t c, size_t ) {
+        uint32_t b = begin + c*CHUNK, e = std::min(end, b + CHUNK);
+        uint32_t l = lpos[c], r = rpos[c];
+        for( uint32_t i = b; i < e; i++)
+            scratch[ left(refs[i]) ? l++ : r++ ] = refs[i];
+    });
+    pool->parallel_for( nchunks, [&]( size_t c, size_t ) {
+        uint32_t b = begin + c*CHUNK, e = std::min(end, b + CHUNK);
+        std::copy( scratch.data() + b, scratch.data() + e, refs.data() + b );
+    });
+    return split;
+}
+
+template<class T>
+typename TriangleBVH<T>::Bounds TriangleBVH<T>::bounds( uint32_t begin, uint32_t end ) const
+{
+    return reduce<Bounds>( begin, end, [this]( Bounds &r, uint32_t b, uint32_t e ) {
+        for( uint32_t i = b; i < e; i++) {
+            const Ref &f = refs[i];
+            T c[3] = { f.center(0), f.center(1), f.center(2) };
+            r.box.grow( f );
+            r.centroids.grow( c );
+        }
+    });
+}
+
+// Builds the subtree over refs[begin, end), whose bounds are known, into out
+// and returns the index of its root
+template<class T>
+uint32_t TriangleBVH<T>::subdivide( std::vector<Node> &out, uint32_t begin, uint32_t end,
+                                    int depth, const Bounds &bounds, std::vector<Task> *defer )
+{
+    const uint32_t self  = out.size();
+    const uint32_t count = end - begin;
+    out.emplace_back();
+
+    if( defer && count <= grain ) {
+        out[self].index = defer->size();
+        out[self].count = DEFERRED;
+        defer->push_back( {begin, end, depth, bounds} );
+        return self;
+    }
+
+    for( int j = 0; j < 3; j++) {
+        out[self].lo[j] = bounds.box.lo[j];
+        out[self].hi[j] = bounds.box.hi[j];
+    }
+    if( count <= leaf_size ) {
+        out[self].index = begin;
+        out[self].count = count;
+        return self;
+    }
+
+    const Box &cb = bounds.centroids;
+    int axis = 0;
+    for( int j = 1; j < 3; j++)
+        if( cb.hi[j] - cb.lo[j] > cb.hi[axis] - cb.lo[axis] ) axis = j;
+
+    Ref   *first = refs.data() + begin, *last = refs.data() + end, *mid = nullptr;
+    Bounds left, right;
+
+    if( cb.hi[axis] > cb.lo[axis] && depth < MAX_DEPTH ) {
+        const T lo    = cb.lo[axis];
+        const T scale = NBINS/(cb.hi[axis] - cb.lo[axis]);
+        auto bin_of = [=]( const Ref &f ) {
+            return std::min( NBINS - 1, (int)((f.center(axis) - lo)*scale) );
+        };
+
+        Bins bins = reduce<Bins>( begin, end, [&]( Bins &r, uint32_t b, uint32_t e ) {
+            for( uint32_t i = b; i < e; i++) {
+                const Ref &f = refs[i];
+                T c[3] = { f.center(0), f.center(1), f.center(2) };
+                int k = bin_of( f );
+                r.bounds[k].box.grow( f );
+                r.bounds[k].centroids.grow( c );
+                r.count[k]++;
+            }
+        });
+
+        // cost of splitting after bin i: N_left*A_left + N_right*A_right
+        double   right_cost[NBINS];
+        Box      acc;
+        uint32_t nacc = 0;
+        for( int i = NBINS - 1; i > 0; i--) {
+            acc.grow( bins.bounds[i].box );
+            nacc += bins.count[i];
+            right_cost[i] = nacc ? nacc*acc.half_area() : 0;
+        }
+
+        double best_cost  = std::numeric_limits<double>::infinity();
+        int    best_split = -1;
+        acc  = Box();
+        nacc = 0;
+        for( int i = 0; i < NBINS - 1; i++) {
+            acc.grow( bins.bounds[i].box );
+            nacc += bins.count[i];
+            if( nacc == 0 || nacc == count ) continue;
+            double cost = nacc*acc.half_area() + right_cost[i+1];
+            if( cost < best_cost ) {
+                best_cost  = cost;
+                best_split = i;
+            }
+        }
+
+        if( best_split >= 0 ) {
+            mid = refs.data() + partition( begin, end, [&]( const Ref &f ) { return bin_of(f) <= best_split; } );
+            for( int i = 0; i < NBINS; i++)
+                (i <= best_split ? left : right).merge( bins.bounds[i] );
+        }
+    }
+
+    if( !mid ) {
+        // Coincident centroids, or too deep: split at the median
+        mid = first + count/2;
+        std::nth_element( first, mid, last, [axis]( const Ref &a, const Ref &b ) {
+            T ca = a.center(axis), cb = b.center(axis);
+            return ca < cb || (ca == cb && a.id < b.id);
+        });
+        left  = this->bounds( begin, begin + count/2 );
+        right = this->bounds( begin + count/2, end );
+    }
+
+    const uint32_t split = begin + (mid - first);
+    subdivide( out, begin, split, depth + 1, left, defer );
+    out[self].index = subdivide( out, split, end, depth + 1, right, defer );
+    out[self].count = 0;
+    return self;
+}
+
+// Appends top[i] and its descendants to the tree in depth-first order,
+// splicing in the deferred subtrees, and returns the new index of top[i]
+template<class T>
+uint32_t TriangleBVH<T>::emit( const std::vector<Node> &top, uint32_t i,
+                               const std::vector<std::vector<Node>> &subtrees )
+{
+    const uint32_t self = tree.size();
+    const Node    &n    = top[i];
+
+    if( n.count == DEFERRED ) {
+        for( Node s : subtrees[n.index] ) {
+            if( !s.leaf() ) s.index += self;
+            tree.push_back( s );
+        }
+        return self;
+    }
+
+    tree.push_back( n );
+    if( !n.leaf() ) {
+        emit( top, i + 1, subtrees );
+        tree[self].index = emit( top, n.index, subtrees );
+    }
+    return self;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template<class T>
+bool TriangleBVH<T>::intersect( const Ray<T> &ray, RayHit<T> &hit ) const
+{
+    if( tree.empty() ) return false;
+
+    Ray<T> r = ray;
+    T inv[3];
+    for( int j = 0; j < 3; j++) inv[j] = 1/ray.dir[j];
+
+    T        tenter;
+    bool     found = false;
+    uint32_t stack[STACK];
+    int      sp = 0;
+
+    if( !hit_box( tree[0], r.origin.data(), inv, r.tmin, r.tmax, tenter ) ) return false;
+    uint32_t i = 0;
+
+    while( true ) {
+        const Node &n = tree[i];
+        if( n.leaf() ) {
+            for( uint32_t k = n.index; k < n.index + n.count; k++) {
+                T t, u, v;
+                if( ::intersect( r, tris.vertex(k,0), tris.vertex(k,1), tris.vertex(k,2), t, u, v ) ) {
+                    r.tmax   = t;
+                    hit.face = faces[k];
+                    hit.t    = t;
+                    hit.u    = u;
+                    hit.v    = v;
+                    found    = true;
+                }
+            }
+        } else {
+            uint32_t near = i + 1, far = n.index;
+            T tnear, tfar;
+            bool hnear = hit_box( tree[near], r.origin.data(), inv, r.tmin, r.tmax, tnear );
+            bool hfar  = hit_box( tree[far],  r.origin.data(), inv, r.tmin, r.tmax, tfar );
+            if( hnear && hfar ) {
+                if( tfar < tnear ) std::swap( near, far );
+                stack[sp++] = far;
+                i = near;
+                continue;
+            }
+            if( hnear || hfar ) {
+                i = hnear ? near : far;
+                continue;
+            }
+        }
+
+        // Pop the next subtree that can still hold a closer hit
+        bool next = false;
+        while( sp > 0 && !next ) {
+            i    = stack[--sp];
+            next = hit_box( tree[i], r.origin.data(), inv, r.tmin, r.tmax, tenter );
+        }
+        if( !next ) break;
+    }
+    return found;
+}
+
+template<class T>
+template<class Q>
+ClosestPoint<T> TriangleBVH<T>::closest_point( const Q &q, T max_dist2 ) const
+{
+    ClosestPoint<T> best;
+    best.dist2 = max_dist2;
+    if( tree.empty() ) return best;
+
+    const T qa[3] = { (T)q[0], (T)q[1], (T)q[2] };
+    const std::array<T,3> qp = { qa[0], qa[1], qa[2] };
+
+    struct Entry { uint32_t node; T dist2; };
+    Entry stack[STACK];
+    int   sp = 0;
+
+    stack[sp++] = { 0, box_dist2(tree[0], qa) };
+    while( sp > 0 ) {
+        Entry e = stack[--sp];
+        if( e.dist2 >= best.dist2 ) continue;
+
+        const Node &n = tree[e.node];
+        if( n.leaf() ) {
+            for( uint32_t k = n.index; k < n.index + n.count; k++) {
+                auto c = ::closest_point( tris.vertex(k,0), tris.vertex(k,1), tris.vertex(k,2), qp );
+                if( c.dist2 < best.dist2 ) {
+                    best      = c;
+                    best.face = faces[k];
+                }
+            }
+            continue;
+        }
+
+        // Push the farther child first so that the nearer one is visited next
+        Entry l = { e.node + 1, box_dist2(tree[e.node + 1], qa) };
+        Entry r = { n.index,    box_dist2(tree[n.index], qa) };
+        if( l.dist2 < r.dist2 ) std::swap( l, r );
+        if( l.dist2 < best.dist2 ) stack[sp++] = l;
+        if( r.dist2 < best.dist2 ) stack[sp++] = r;
+    }
+    return best;
+}
+
+template<class T>
+template<class B, class F>
+void TriangleBVH<T>::overlap( const B &lo, const B &hi, F f ) const
+{
+    if( tree.empty() ) return;
+
+    uint32_t stack[STACK];
+    int      sp = 0;
+    stack[sp++] = 0;
+    while( sp > 0 ) {
+        const Node &n = tree[stack[--sp]];
+        bool disjoint = false;
+        for( int j = 0; j < 3; j++)
+            disjoint = disjoint || n.lo[j] > hi[j] || n.hi[j] < lo[j];
+        if( disjoint ) continue;
+
+        if( n.leaf() ) {
+            for( uint32_t k = n.index; k < n.index + n.count; k++)
+                if( triangle_box_overlap( tris.vertex(k,0), tris.vertex(k,1), tris.vertex(k,2), lo, hi ) )
+                    f( faces[k] );
+        } else {
+            stack[sp++] = n.index;
+            stack[sp++] = (uint32_t)(&n - tree.data()) + 1;
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
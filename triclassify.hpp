@@ -0,0 +1,128 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "tribatch.hpp"
+#include "trimesh.hpp"
+
+///////////////////////////////////////////////////////////////////////////////
+// Per-face shape classification as a bitmask, without transcendental calls.
+//
+// Every test compares the cosine of the largest or smallest angle against a
+// threshold, using the squared-edge form described above isObtuse in
+// trilib.hpp. The thresholds are turned into squared cosines once, when the
+// classifier is constructed.
+//
+// A degenerate face (as isDegenerate) gets TRI_DEGENERATE and nothing else.
+// Any other face gets exactly one of TRI_ACUTE, TRI_RIGHT and TRI_OBTUSE, plus
+//   TRI_SLIVER  smallest angle below sliver_angle
+//   TRI_CAP     largest angle above cap_angle
+//   TRI_NEEDLE  a sliver that is not a cap, i.e. thin because of a short edge
+///////////////////////////////////////////////////////////////////////////////
+
+enum TriangleClass : uint8_t
+{
+    TRI_ACUTE      = 1u << 0,
+    TRI_RIGHT      = 1u << 1,
+    TRI_OBTUSE     = 1u << 2,
+    TRI_DEGENERATE = 1u << 3,
+    TRI_SLIVER     = 1u << 4,
+    TRI_NEEDLE     = 1u << 5,
+    TRI_CAP        = 1u << 6
+};
+
+class TriangleClassifier
+{
+public:
+    // Angles in degrees; a face is right when |cos(largest angle)| <= right_tolerance
+    explicit TriangleClassifier( double sliver_angle = 10.0, double cap_angle = 160.0,
+                                 double right_tolerance = 1e-6 )
+    {
+        double cs = cos( sliver_angle*M_PI/180.0 );
+        double cc = cos( cap_angle*M_PI/180.0 );
+        sliver_cos2 = cs*cs;
+        cap_cos2    = cc*cc;
+        right_cos2  = right_tolerance*right_tolerance;
+    }
+
+    // Squared edge lengths in any order
+    uint8_t classify_lengths2( double a2, double b2, double c2 ) const
+    {
+        double s2 = std::min( a2, b2 );
+        double l2 = std::max( a2, b2 );
+        double m2 = std::max( s2, std::min( l2, c2 ));
+        s2 = std::min( s2, c2 );
+        l2 = std::max( l2, c2 );
+
+        // cos(largest angle) = nmax/sqrt(dmax), cos(smallest angle) = nmin/sqrt(dmin)
+        double nmax = s2 + m2 - l2, dmax = 4*s2*m2;
+        double nmin = l2 + m2 - s2, dmin = 4*l2*m2;
+        double nmax2 = nmax*nmax;
+
+        bool degenerate = s2 == 0.0 || (nmax < 0.0 && nmax2 > DEGENERATE_COS2*dmax);
+        bool right      = nmax2 <= right_cos2*dmax;
+        bool sliver     = nmin*nmin > sliver_cos2*dmin;
+        bool cap        = nmax < 0.0 && nmax2 > cap_cos2*dmax;
+
+        uint8_t mask = right ? TRI_RIGHT : (nmax > 0.0 ? TRI_ACUTE : TRI_OBTUSE);
+        mask |= (sliver ? TRI_SLIVER : 0) | (cap ? TRI_CAP : 0) |
+                (sliver && !cap ? TRI_NEEDLE : 0);
+        return degenerate ? uint8_t(TRI_DEGENERATE) : mask;
+    }
+
+    template<class P, class T = point3_t<P>>
+    uint8_t operator()( const P &pa, const P &pb, const P &pc ) const
+    {
+        return classify_lengths2( length2(pb,pc), length2(pc,pa), length2(pa,pb) );
+    }
+
+private:
+    double sliver_cos2, cap_cos2, right_cos2;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+template<class P, class T = point3_t<P>>
+inline uint8_t classify( const P &pa, const P &pb, const P &pc,
+                         const TriangleClassifier &classifier = TriangleClassifier())
+{
+    return classifier(pa, pb, pc);
+}
+
+// One pass over the nine coordinate streams; the loop body is branch-free
+// so that it vectorizes across triangles.
+template<class T>
+inline void classify( const TriangleBatch<T> &batch, uint8_t *out,
+                      const TriangleClassifier &classifier = TriangleClassifier())
+{
+    const T *x0 = batch.x(0), *y0 = batch.y(0), *z0 = batch.z(0);
+    const T *x1 = batch.x(1), *y1 = batch.y(1), *z1 = batch.z(1);
+    const T *x2 = batch.x(2), *y2 = batch.y(2), *z2 = batch.z(2);
+
+    const size_t n = batch.size();
+    for( size_t i = 0; i < n; i++) {
+        double ax = x1[i] - x2[i], ay = y1[i] - y2[i], az = z1[i] - z2[i];
+        double bx = x2[i] - x0[i], by = y2[i] - y0[i], bz = z2[i] - z0[i];
+        double cx = x0[i] - x1[i], cy = y0[i] - y1[i], cz = z0[i] - z1[i];
+        T a2 = ax*ax + ay*ay + az*az;
+        T b2 = bx*bx + by*by + bz*bz;
+        T c2 = cx*cx + cy*cy + cz*cz;
+        out[i] = classifier.classify_lengths2( a2, b2, c2 );
+    }
+}
+
+template<class Mesh, class T = mesh_value_t<Mesh>>
+inline uint8_t classify( const Mesh &mesh, size_t f,
+                         const TriangleClassifier &classifier = TriangleClassifier())
+{
+    return classifier( mesh.corner(f,0), mesh.corner(f,1), mesh.corner(f,2) );
+}
+
+template<class Mesh, class T = mesh_value_t<Mesh>>
+inline void classify( const Mesh &mesh, uint8_t *out,
+                      const TriangleClassifier &classifier = TriangleClassifier())
+{
+    for( size_t f = 0; f < mesh.nfaces(); f++) out[f] = classify(mesh, f, classifier);
+}
+
+///////////////////////////////////////////////////////////////////////////////
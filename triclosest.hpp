@@ -0,0 +1,206 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+
+#include "tribatch.hpp"
+
+///////////////////////////////////////////////////////////////////////////////
+// Closest point on a triangle to a query point.
+//
+// The query is located in one of the seven Voronoi regions of the triangle
+// (three vertices, three edges, interior) from the signs of a few dot
+// products, following Ericson, Real-Time Collision Detection, 5.1.5. Rather
+// than returning from the first region that matches, the kernel computes the
+// weights of every region and keeps the winner through a chain of selects,
+// so there are no data-dependent branches: queries that land in random
+// regions cost the same as coherent ones, and the batched loops compile to
+// vector blends.
+//
+// The result holds the closest point, its barycentric coordinates relative to
+// (pa, pb, pc), the squared distance to the query and the feature (vertex,
+// edge or interior) the point lies on; face is left for mesh-level queries to
+// fill in.
+//
+// The batched forms read query points from coordinate streams, like the
+// TriangleBatch kernels, and give the same results as the scalar form.
+///////////////////////////////////////////////////////////////////////////////
+
+enum TriangleFeature : uint8_t
+{
+    FEATURE_VERTEX_A = 0,
+    FEATURE_VERTEX_B = 1,
+    FEATURE_VERTEX_C = 2,
+    FEATURE_EDGE_AB  = 3,
+    FEATURE_EDGE_AC  = 4,
+    FEATURE_EDGE_BC  = 5,
+    FEATURE_FACE     = 6
+};
+
+template<class T>
+struct ClosestPoint
+{
+    std::array<T,3> point   = {0, 0, 0};
+    std::array<T,3> bary    = {0, 0, 0};
+    T               dist2   = std::numeric_limits<T>::infinity();
+    int             face    = -1;
+    uint8_t         feature = FEATURE_FACE;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Index of the lowest set bit of a nonzero x
+inline int lowest_set_bit( unsigned x )
+{
+#if defined(__GNUC__)
+    return __builtin_ctz( x );
+#else
+    int r = 0;
+    for( ; !(x & 1u); x >>= 1) r++;
+    return r;
+#endif
+}
+
+// Weights (u, v) of b and c in the closest point to q, and its feature.
+// Takes plain coordinates so that the batched loops vectorize.
+template<class T>
+inline void closest_point_weights( T ax, T ay, T az,
+                                   T bx, T by, T bz,
+                                   T cx, T cy, T cz,
+                                   T qx, T qy, T qz,
+                                   T &u, T &v, uint8_t &feature )
+{
+    const T abx = bx - ax, aby = by - ay, abz = bz - az;
+    const T acx = cx - ax, acy = cy - ay, acz = cz - az;
+    const T apx = qx - ax, apy = qy - ay, apz = qz - az;
+    const T bpx = qx - bx, bpy = qy - by, bpz = qz - bz;
+    const T cpx = qx - cx, cpy = qy - cy, cpz = qz - cz;
+
+    const T d1 = abx*apx + aby*apy + abz*apz, d2 = acx*apx + acy*apy + acz*apz;
+    const T d3 = abx*bpx + aby*bpy + abz*bpz, d4 = acx*bpx + acy*bpy + acz*bpz;
+    const T d5 = abx*cpx + aby*cpy + abz*cpz, d6 = acx*cpx + acy*cpy + acz*cpz;
+
+    const T va = d3*d6 - d5*d4;
+    const T vb = d5*d2 - d1*d6;
+    const T vc = d1*d4 - d3*d2;
+
+    // Regions are numbered in the order Ericson tests them (A, B, AB, C,
+    // AC, BC, face), so the lowest set bit of 'inside' is the region his
+    // chain of early returns would pick; region[] maps that rank back to
+    // its TriangleFeature. The weights of rank r are (nu[r]/den[r],
+    // nv[r]/den[r]). The tests are combined with integer arithmetic, which
+    // compilers keep branch-free, and only one division is left.
+    static const uint8_t region[7] = { FEATURE_VERTEX_A, FEATURE_VERTEX_B, FEATURE_EDGE_AB,
+                                       FEATURE_VERTEX_C, FEATURE_EDGE_AC, FEATURE_EDGE_BC,
+                                       FEATURE_FACE };
+    const T nu[7]  = { 0, 1, d1,      0, 0,       d5 - d6,               vb };
+    const T nv[7]  = { 0, 0, 0,       1, d2,      d4 - d3,               vc };
+    const T den[7] = { 1, 1, d1 - d3, 1, d2 - d6, (d4 - d3) + (d5 - d6), va + vb + vc };
+
+    const unsigned inside =
+        ((unsigned)(d1 <= 0) & (unsigned)(d2 <= 0))                                  << 0 |
+        ((unsigned)(d3 >= 0) & (unsigned)(d4 <= d3))                                 << 1 |
+        ((unsigned)(vc <= 0) & (unsigned)(d1 >= 0) & (unsigned)(d3 <= 0))            << 2 |
+        ((unsigned)(d6 >= 0) & (unsigned)(d5 <= d6))                                 << 3 |
+        ((unsigned)(vb <= 0) & (unsigned)(d2 >= 0) & (unsigned)(d6 <= 0))            << 4 |
+        ((unsigned)(va <= 0) & (unsigned)(d4 - d3 >= 0) & (unsigned)(d5 - d6 >= 0)) << 5 |
+        1u << 6;
+    const int r = lowest_set_bit( inside );
+
+    const T inv = 1/den[r];
+    u       = nu[r]*inv;
+    v       = nv[r]*inv;
+    feature = region[r];
+}
+
+template<class P, class Q, class T = point3_t<P>>
+inline ClosestPoint<T> closest_point( const P &pa,
+                                      const P &pb,
+                                      const P &pc,
+                                      const Q &queryPoint)
+{
+    const T ax = pa[0], ay = pa[1], az = pa[2];
+    const T bx = pb[0], by = pb[1], bz = pb[2];
+    const T cx = pc[0], cy = pc[1], cz = pc[2];
+    const T qx = queryPoint[0], qy = queryPoint[1], qz = queryPoint[2];
+
+    ClosestPoint<T> r;
+    T u, v;
+    closest_point_weights( ax, ay, az, bx, by, bz, cx, cy, cz, qx, qy, qz, u, v, r.feature );
+
+    r.bary  = { 1 - u - v, u, v };
+    r.point = { ax + u*(bx - ax) + v*(cx - ax),
+                ay + u*(by - ay) + v*(cy - ay),
+                az + u*(bz - az) + v*(cz - az) };
+
+    const T dx = r.point[0] - qx, dy = r.point[1] - qy, dz = r.point[2] - qz;
+    r.dist2 = dx*dx + dy*dy + dz*dz;
+    return r;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Point i against triangle i, for every triangle of the batch. Outputs hold
+// batch.size() entries; px, py, pz and feature may be null.
+template<class T>
+inline void closest_point( const TriangleBatch<T> &batch,
+                           const T *qx, const T *qy, const T *qz, T *dist2,
+                           typename TriangleBatch<T>::value_type *px,
+                           typename TriangleBatch<T>::value_type *py,
+                           typename TriangleBatch<T>::value_type *pz,
+                           uint8_t *feature )
+{
+    const T *x0 = batch.x(0), *y0 = batch.y(0), *z0 = batch.z(0);
+    const T *x1 = batch.x(1), *y1 = batch.y(1), *z1 = batch.z(1);
+    const T *x2 = batch.x(2), *y2 = batch.y(2), *z2 = batch.z(2);
+
+    const size_t n = batch.size();
+    for( size_t i = 0; i < n; i++) {
+        T       u, v;
+        uint8_t f;
+        closest_point_weights( x0[i], y0[i], z0[i], x1[i], y1[i], z1[i], x2[i], y2[i], z2[i],
+                               qx[i], qy[i], qz[i], u, v, f );
+
+        const T kx = x0[i] + u*(x1[i] - x0[i]) + v*(x2[i] - x0[i]);
+        const T ky = y0[i] + u*(y1[i] - y0[i]) + v*(y2[i] - y0[i]);
+        const T kz = z0[i] + u*(z1[i] - z0[i]) + v*(z2[i] - z0[i]);
+        const T dx = kx - qx[i], dy = ky - qy[i], dz = kz - qz[i];
+        dist2[i] = dx*dx + dy*dy + dz*dz;
+        if( px )      px[i]      = kx;
+        if( py )      py[i]      = ky;
+        if( pz )      pz[i]      = kz;
+        if( feature ) feature[i] = f;
+    }
+}
+
+// n query points against one triangle. Outputs hold n entries; px, py, pz
+// and feature may be null.
+template<class P, class T = point3_t<P>>
+inline void closest_point( const P &pa, const P &pb, const P &pc,
+                           size_t n, const T *qx, const T *qy, const T *qz, T *dist2,
+                           point3_t<P> *px, point3_t<P> *py, point3_t<P> *pz,
+                           uint8_t *feature )
+{
+    const T ax = pa[0], ay = pa[1], az = pa[2];
+    const T bx = pb[0], by = pb[1], bz = pb[2];
+    const T cx = pc[0], cy = pc[1], cz = pc[2];
+
+    for( size_t i = 0; i < n; i++) {
+        T       u, v;
+        uint8_t f;
+        closest_point_weights( ax, ay, az, bx, by, bz, cx, cy, cz,
+                               qx[i], qy[i], qz[i], u, v, f );
+
+        const T kx = ax + u*(bx - ax) + v*(cx - ax);
+        const T ky = ay + u*(by - ay) + v*(cy - ay);
+        const T kz = az + u*(bz - az) + v*(cz - az);
+        const T dx = kx - qx[i], dy = ky - qy[i], dz = kz - qz[i];
+        dist2[i] = dx*dx + dy*dy + dz*dz;
+        if( px )      px[i]      = kx;
+        if( py )      py[i]      = ky;
+        if( pz )      pz[i]      = kz;
+        if( feature ) feature[i] = f;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
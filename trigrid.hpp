@@ -0,0 +1,287 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "threadpool.hpp"
+#include "tribatch.hpp"
+#include "trimesh.hpp"
+
+///////////////////////////////////////////////////////////////////////////////
+// Point location on planar meshes with a uniform grid.
+//
+// Faces are projected onto the plane normal to one coordinate axis (z by
+// default) and listed, in CSR form, in every grid cell their bounding box
+// touches. A query visits the faces of a single cell and evaluates per-face
+// affine weights relative to the face's corner 0, (ox, oy),
+//
+//   l1 = ux*(x - ox) + uy*(y - oy),  l2 = vx*(x - ox) + vy*(y - oy),
+//   l0 = 1 - l1 - l2
+//
+// (the 2D counterpart of BaryFrame, six numbers per face), so locating a
+// point costs a cell lookup plus a few multiply-adds per candidate. Taking
+// the differences first keeps the weights accurate far from the origin. The first
+// face, in face order, whose weights are all >= -TOLERANCE wins; points on a
+// shared edge therefore always resolve to the same face. Degenerate faces
+// are left out of the grid.
+//
+// Query points outside the grid are clamped to the border cells, so the
+// grid stays correct (if slower) when vertices move past its initial bounds.
+// update() refreshes the weights after such moves and rebuilds the face
+// lists only if a face's cell range changed.
+///////////////////////////////////////////////////////////////////////////////
+
+template<class T>
+struct PointLocation
+{
+    int             face = -1;
+    std::array<T,3> bary = {0, 0, 0};
+};
+
+template<class T>
+class TriangleGrid
+{
+public:
+    // Slack on the (dimensionless) weights that absorbs roundoff on shared
+    // edges
+    static constexpr T TOLERANCE = 64*std::numeric_limits<T>::epsilon();
+
+    TriangleGrid() = default;
+
+    // Mesh is TriangleBatch<T>, IndexedMeshView<T>, TriangleSoupView<T>, or
+    // anything else with nfaces() and corner(face, k). Coordinate 'axis' is
+    // dropped; the grid has about cells_per_face*nfaces cells.
+    template<class Mesh>
+    explicit TriangleGrid( const Mesh &mesh, int axis = 2, double cells_per_face = 1.0 )
+    {
+        build( mesh, axis, cells_per_face );
+    }
+
+    template<class Mesh>
+    void build( const Mesh &mesh, int axis = 2, double cells_per_face = 1.0 );
+
+    // Same faces, moved vertices. Returns true if the face lists were rebuilt.
+    template<class Mesh>
+    bool update( const Mesh &mesh );
+
+    size_t nfaces()    const { return ux.size(); }
+    int    nx()        const { return ncols; }
+    int    ny()        const { return nrows; }
+    T      cell_size() const { return T(1/inv_size); }
+
+    // Faces of cell (i, j) are cell_faces()[cell_offsets()[c] .. cell_offsets()[c+1]),
+    // c = j*nx() + i
+    const std::vector<uint32_t> &cell_offsets() const { return offsets; }
+    const std::vector<uint32_t> &cell_faces()   const { return members; }
+
+    // (x, y) are the two coordinates kept by the projection, in order
+    PointLocation<T> locate( T x, T y ) const
+    {
+        PointLocation<T> loc;
+        if( offsets.empty() ) return loc;
+
+        const uint32_t c = row(y)*ncols + column(x);
+        for( uint32_t k = offsets[c]; k < offsets[c+1]; k++) {
+            const uint32_t f  = members[k];
+            const T        dx = x - ox[f], dy = y - oy[f];
+            const T        l1 = ux[f]*dx + uy[f]*dy;
+            const T        l2 = vx[f]*dx + vy[f]*dy;
+            const T        l0 = 1 - l1 - l2;
+            if( l0 >= -TOLERANCE && l1 >= -TOLERANCE && l2 >= -TOLERANCE ) {
+                loc.face = f;
+                loc.bary = { l0, l1, l2 };
+                break;
+            }
+        }
+        return loc;
+    }
+
+    // 3D point, projected like the mesh
+    template<class Q>
+    PointLocation<T> locate( const Q &q ) const
+    {
+        return locate( (T)q[(drop + 1)%3], (T)q[(drop + 2)%3] );
+    }
+
+    // Batched: point i -> face[i] (-1 if outside) and weights l0..l2[i]
+    void locate( size_t n, const T *qx, const T *qy,
+                 int *face, T *l0, T *l1, T *l2 ) const
+    {
+        for( size_t i = 0; i < n; i++) {
+            PointLocation<T> loc = locate( qx[i], qy[i] );
+            face[i] = loc.face;
+            l0[i]   = loc.bary[0];
+            l1[i]   = loc.bary[1];
+            l2[i]   = loc.bary[2];
+        }
+    }
+
+    void locate( JMath::ThreadPool &pool, size_t n, const T *qx, const T *qy,
+                 int *face, T *l0, T *l1, T *l2 ) const
+    {
+        const size_t block   = 4096;
+        const size_t nblocks = (n + block - 1)/block;
+        pool.parallel_for( nblocks, [&]( size_t b, size_t ) {
+            size_t i = b*block, m = std::min(n - i, block);
+            locate( m, qx + i, qy + i, face + i, l0 + i, l1 + i, l2 + i );
+        });
+    }
+
+private:
+    struct CellRange
+    {
+        uint32_t i0, i1, j0, j1;
+
+        bool empty() const { return i0 > i1; }
+        bool operator==( const CellRange &r ) const
+        {
+            return i0 == r.i0 && i1 == r.i1 && j0 == r.j0 && j1 == r.j1;
+        }
+    };
+
+    uint32_t column( double x ) const
+    {
+        double t = (x - xmin)*inv_size;
+        return t >= 0 ? (t < ncols ? (uint32_t)t : ncols - 1) : 0;
+    }
+    uint32_t row( double y ) const
+    {
+        double t = (y - ymin)*inv_size;
+        return t >= 0 ? (t < nrows ? (uint32_t)t : nrows - 1) : 0;
+    }
+
+    // Sets the weights of face f and returns its cell range
+    template<class Mesh>
+    CellRange prepare( const Mesh &mesh, size_t f );
+
+    void fill_cells();
+
+    int    drop  = 2;
+    double xmin  = 0, ymin = 0, inv_size = 1;
+    int    ncols = 0, nrows = 0;
+
+    std::vector<T>         ox, oy, ux, uy, vx, vy;
+    std::vector<CellRange> ranges;
+    std::vector<uint32_t>  offsets, members;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+template<class T>
+template<class Mesh>
+void TriangleGrid<T>::build( const Mesh &mesh, int axis, double cells_per_face )
+{
+    const size_t n = mesh.nfaces();
+    const int    a = (axis + 1)%3, b = (axis + 2)%3;
+    drop = axis;
+
+    double x0 = std::numeric_limits<double>::max(), x1 = -x0;
+    double y0 = x0, y1 = x1;
+    for( size_t f = 0; f < n; f++)
+        for( int k = 0; k < 3; k++) {
+            auto p = mesh.corner(f, k);
+            x0 = std::min( x0, (double)p[a] );
+            x1 = std::max( x1, (double)p[a] );
+            y0 = std::min( y0, (double)p[b] );
+            y1 = std::max( y1, (double)p[b] );
+        }
+
+    ox.resize(n); ux.resize(n); uy.resize(n);
+    oy.resize(n); vx.resize(n); vy.resize(n);
+    ranges.resize(n);
+    offsets.clear();
+    members.clear();
+    ncols = nrows = 0;
+    if( n == 0 ) return;
+
+    // Square cells, about cells_per_face*n of them over the bounding box
+    const double w = x1 - x0, h = y1 - y0;
+    const double ncells = std::max( 1.0, cells_per_face*n );
+    double size = std::sqrt( w*h/ncells );
+    if( !(size > 0) ) size = std::max( w, h )/ncells;
+    if( !(size > 0) ) size = 1;
+
+    xmin     = x0;
+    ymin     = y0;
+    inv_size = 1/size;
+    ncols    = (int)std::min( ncells, std::floor(w*inv_size) + 1 );
+    nrows    = (int)std::min( ncells, std::floor(h*inv_size) + 1 );
+
+    for( size_t f = 0; f < n; f++) ranges[f] = prepare( mesh, f );
+    fill_cells();
+}
+
+template<class T>
+template<class Mesh>
+bool TriangleGrid<T>::update( const Mesh &mesh )
+{
+    bool changed = false;
+    for( size_t f = 0; f < nfaces(); f++) {
+        CellRange r = prepare( mesh, f );
+        if( !(r == ranges[f]) ) {
+            ranges[f] = r;
+            changed   = true;
+        }
+    }
+    if( changed ) fill_cells();
+    return changed;
+}
+
+template<class T>
+template<class Mesh>
+typename TriangleGrid<T>::CellRange TriangleGrid<T>::prepare( const Mesh &mesh, size_t f )
+{
+    const int a = (drop + 1)%3, b = (drop + 2)%3;
+    double x[3], y[3];
+    for( int k = 0; k < 3; k++) {
+        auto p = mesh.corner(f, k);
+        x[k] = p[a];
+        y[k] = p[b];
+    }
+
+    // l1 and l2 are the areas opposite corners 1 and 2 over the total area
+    double det = (x[1] - x[0])*(y[2] - y[0]) - (x[2] - x[0])*(y[1] - y[0]);
+    if( det == 0 || !std::isfinite(det) ) {
+        const T nan = std::numeric_limits<T>::quiet_NaN();
+        ox[f] = oy[f] = ux[f] = uy[f] = vx[f] = vy[f] = nan;
+        return { 1, 0, 1, 0 };
+    }
+    double inv = 1/det;
+    ox[f] = x[0];
+    oy[f] = y[0];
+    ux[f] =  (y[2] - y[0])*inv;
+    uy[f] = -(x[2] - x[0])*inv;
+    vx[f] = -(y[1] - y[0])*inv;
+    vy[f] =  (x[1] - x[0])*inv;
+
+    return { column( min_value(x[0], x[1], x[2]) ), column( max_value(x[0], x[1], x[2]) ),
+             row( min_value(y[0], y[1], y[2]) ),    row( max_value(y[0], y[1], y[2]) ) };
+}
+
+// Counting sort of (cell, face) pairs into the CSR arrays
+template<class T>
+void TriangleGrid<T>::fill_cells()
+{
+    const size_t ncells = (size_t)ncols*nrows;
+    offsets.assign( ncells + 1, 0 );
+    for( const CellRange &r : ranges ) {
+        if( r.empty() ) continue;
+        for( uint32_t j = r.j0; j <= r.j1; j++)
+            for( uint32_t i = r.i0; i <= r.i1; i++) offsets[j*ncols + i + 1]++;
+    }
+    for( size_t c = 0; c < ncells; c++) offsets[c+1] += offsets[c];
+
+    members.resize( offsets[ncells] );
+    std::vector<uint32_t> next( offsets.begin(), offsets.end() - 1 );
+    for( size_t f = 0; f < ranges.size(); f++) {
+        const CellRange &r = ranges[f];
+        if( r.empty() ) continue;
+        for( uint32_t j = r.j0; j <= r.j1; j++)
+            for( uint32_t i = r.i0; i <= r.i1; i++) members[ next[j*ncols + i]++ ] = f;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
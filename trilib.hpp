@@ -7,10 +7,65 @@
 
 using namespace JMath;
 
-template<class T>
-inline T minlength( const std::array<T,3> &pa,
-                    const std::array<T,3> &pb,
-                    const std::array<T,3> &pc)
+// Angle units as types. Passing one of these instead of ANGLE_IN_DEGREES or
+// ANGLE_IN_RADIANS selects the conversion at compile time; Cosine returns
+// the (clamped) cosine itself and makes no acos call, for callers that only
+// compare against a threshold. Cosines decrease as angles grow, so
+// "angle > t" becomes "cosine < cos(t)".
+//
+// AngleDegrees and AngleRadians also name the acos to use (fastmath.hpp):
+// AngleDegrees<TrigCoarse>() trades exactness for a short polynomial,
+// accurate to 4e-5 rad.
+template<class Trig>
+struct AngleDegrees
+{
+    template<class T, class R>
+    static T from_cosine( R c ) { T a = Trig::acos(c); return a*(R)(180/M_PI); }
+};
+
+template<class Trig>
+struct AngleRadians
+{
+    template<class T, class R>
+    static T from_cosine( R c ) { return Trig::acos(c); }
+};
+
+typedef AngleDegrees<TrigExact> Degrees;
+typedef AngleRadians<TrigExact> Radians;
+
+struct Cosine
+{
+    template<class T, class R>
+    static T from_cosine( R c ) { return c; }
+};
+
+template<class Unit>
+using angle_unit_t = decltype( Unit::template from_cosine<double>( 0.0 ) );
+
+// The angle functions also take a precision policy (veclib.hpp), double by
+// default. Under MixedPrecision a native cosine c = num/den, computed from
+// squared edge lengths summing to sum2, is off by at most about
+// 8 eps sum2/den, and the angle by that over sin(angle); when this exceeds
+// MIXED_ANGLE_TOLERANCE radians (needles and slivers) the call is redone in
+// double.
+const double MIXED_ANGLE_TOLERANCE = 1e-4;
+
+template<class R>
+inline bool cosine_is_accurate( R c, R sum2, R den )
+{
+    const R e   = 8*std::numeric_limits<R>::epsilon()*sum2/den;
+    const R tol = (R)MIXED_ANGLE_TOLERANCE;
+    return e*e <= tol*tol*(1 - c*c);
+}
+
+template<class Prec, class R>
+using mixed_check = std::integral_constant<bool, std::is_same<Prec,MixedPrecision>::value &&
+                                                 !std::is_same<R,double>::value>;
+
+template<class P, class T = point3_t<P>>
+inline T minlength( const P &pa,
+                    const P &pb,
+                    const P &pc)
 {
     T a  =  length( pb, pc );
     T b  =  length( pc, pa );
@@ -19,10 +74,10 @@ inline T minlength( const std::array<T,3> &pa,
     return min_value(a,b,c);
 }
 
-template<class T>
-inline T maxlength( const std::array<T,3> &pa,
-                    const std::array<T,3> &pb,
-                    const std::array<T,3> &pc)
+template<class P, class T = point3_t<P>>
+inline T maxlength( const P &pa,
+                    const P &pb,
+                    const P &pc)
 {
     T a  =  length( pb, pc );
     T b  =  length( pc, pa );
@@ -31,203 +86,257 @@ inline T maxlength( const std::array<T,3> &pa,
     return max_value(a,b,c);
 }
 
-template<class T>
-inline std::array<T,3> angles( const std::array<T,3> &pa,
-                               const std::array<T,3> &pb,
-                               const std::array<T,3> &pc, 
-			       int measure = ANGLE_IN_DEGREES)
-{
-    std::array<T,3> angles = {0, 0, 0};
-
-    double a2   =  length2( pb, pc );
-    double b2   =  length2( pc, pa );
-    double c2   =  length2( pa, pb );
-    double cosA =  (b2 + c2 - a2)/(2*sqrt(b2*c2) );
-    double cosB =  (a2 + c2 - b2)/(2*sqrt(a2*c2) );
-    double cosC =  (a2 + b2 - c2)/(2*sqrt(a2*b2) );
-
-    if( cosA >  1.0) cosA =  1.0;
-    if( cosA < -1.0) cosA = -1.0;
-    angles[0] = acos(cosA);
-
-    if( cosB >  1.0) cosB =  1.0;
-    if( cosB < -1.0) cosB = -1.0;
-    angles[1] = acos(cosB);
-
-    if( cosC >  1.0) cosC =  1.0;
-    if( cosC < -1.0) cosC = -1.0;
-    angles[2] = acos(cosC);
-
-    if( measure ==  ANGLE_IN_DEGREES) {
-        angles[0] *= 180/M_PI;
-        angles[1] *= 180/M_PI;
-        angles[2] *= 180/M_PI;
+template<class P, class Unit = Degrees, class Prec = DoublePrecision, class T = point3_t<P>,
+         class = angle_unit_t<Unit>, class R = precision_t<Prec,T>>
+inline std::array<T,3> angles( const P &pa,
+                               const P &pb,
+                               const P &pc,
+                               Unit = Unit(),
+                               Prec = Prec())
+{
+    std::array<T,3> result = {0, 0, 0};
+
+    R a2   =  length2( pb, pc, Prec() );
+    R b2   =  length2( pc, pa, Prec() );
+    R c2   =  length2( pa, pb, Prec() );
+    R denA =  2*std::sqrt(b2*c2);
+    R denB =  2*std::sqrt(a2*c2);
+    R denC =  2*std::sqrt(a2*b2);
+    R cosA =  (b2 + c2 - a2)/denA;
+    R cosB =  (a2 + c2 - b2)/denB;
+    R cosC =  (a2 + b2 - c2)/denC;
+
+    if constexpr ( mixed_check<Prec,R>::value ) {
+        const R sum2 = a2 + b2 + c2;
+        if( !(cosine_is_accurate( cosA, sum2, denA ) &&
+              cosine_is_accurate( cosB, sum2, denB ) &&
+              cosine_is_accurate( cosC, sum2, denC )) )
+            return angles( pa, pb, pc, Unit(), DoublePrecision() );
     }
-    return angles;
+
+    if( cosA >  1) cosA =  1;
+    if( cosA < -1) cosA = -1;
+    result[0] = Unit::template from_cosine<T>(cosA);
+
+    if( cosB >  1) cosB =  1;
+    if( cosB < -1) cosB = -1;
+    result[1] = Unit::template from_cosine<T>(cosB);
+
+    if( cosC >  1) cosC =  1;
+    if( cosC < -1) cosC = -1;
+    result[2] = Unit::template from_cosine<T>(cosC);
+
+    return result;
+}
+
+template<class P, class T = point3_t<P>>
+inline std::array<T,3> angles( const P &pa,
+                               const P &pb,
+                               const P &pc,
+                               int measure)
+{
+    if( measure == ANGLE_IN_DEGREES) return angles( pa, pb, pc, Degrees() );
+    return angles( pa, pb, pc, Radians() );
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
-template<class T>
-inline T angleAt( const std::array<T,3> &pa,
-                  const std::array<T,3> &pb,
-                  const std::array<T,3> &pc, 
-		  int measure = ANGLE_IN_DEGREES)
+template<class P, class Unit = Degrees, class Prec = DoublePrecision, class T = point3_t<P>,
+         class = angle_unit_t<Unit>, class R = precision_t<Prec,T>>
+inline T angleAt( const P &pa,
+                  const P &pb,
+                  const P &pc,
+                  Unit = Unit(),
+                  Prec = Prec())
 {
-    T a2   =  length2( pb, pc );
-    T b2   =  length2( pc, pa );
-    T c2   =  length2( pa, pb );
-    double cosA =  (b2 + c2 - a2)/(2*sqrt(b2*c2) );
+    R a2   =  length2( pb, pc, Prec() );
+    R b2   =  length2( pc, pa, Prec() );
+    R c2   =  length2( pa, pb, Prec() );
+    R den  =  2*std::sqrt(b2*c2);
+    R cosA =  (b2 + c2 - a2)/den;
+
+    if constexpr ( mixed_check<Prec,R>::value ) {
+        if( !cosine_is_accurate( cosA, a2 + b2 + c2, den ) )
+            return angleAt( pa, pb, pc, Unit(), DoublePrecision() );
+    }
 
-    if( cosA >  1.0) cosA =  1.0;
-    if( cosA < -1.0) cosA = -1.0;
+    if( cosA >  1) cosA =  1;
+    if( cosA < -1) cosA = -1;
+
+    return Unit::template from_cosine<T>(cosA);
+}
 
-    double angle;
-    if( measure == ANGLE_IN_DEGREES)
-        angle = 180*acos(cosA)/M_PI;
-    else
-        angle = acos(cosA);
-    return angle;
+template<class P, class T = point3_t<P>>
+inline T angleAt( const P &pa,
+                  const P &pb,
+                  const P &pc,
+                  int measure)
+{
+    if( measure == ANGLE_IN_DEGREES) return angleAt( pa, pb, pc, Degrees() );
+    return angleAt( pa, pb, pc, Radians() );
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-template<class T>
-std::pair<T,int> maxangle( const std::array<T,3> &pa,
-                           const std::array<T,3> &pb,
-                           const std::array<T,3> &pc, 
-			   int measure = ANGLE_IN_DEGREES)
+// Angle at corner k given the squared opposite edge u2 and the squared
+// adjacent edges s2, t2; shared by maxangle and minangle
+template<class Unit, class Prec, class T, class R>
+inline bool extreme_angle( R u2, R s2, R t2, int k, std::pair<T,int> &result )
 {
-    T a2   =  length2( pb, pc );
-    T b2   =  length2( pc, pa );
-    T c2   =  length2( pa, pb );
+    R den = 2*std::sqrt(s2*t2);
+    R c   = (s2 + t2 - u2)/den;
 
-    T maxlen = max_value(a2,b2,c2);
+    if constexpr ( mixed_check<Prec,R>::value ) {
+        if( !cosine_is_accurate( c, u2 + s2 + t2, den ) ) return false;
+    }
 
-    std::pair<T,int> result;
+    if( c >  1) c =  1;
+    if( c < -1) c = -1;
+    result.first  = Unit::template from_cosine<T>(c);
+    result.second = k;
+    return true;
+}
 
-    if( maxlen == a2) {
-        double cosA =  (b2 + c2 - a2)/(2*sqrt(b2*c2) );
-        if( cosA >  1.0) cosA =  1.0;
-        if( cosA < -1.0) cosA = -1.0;
-        double angle = acos(cosA);
-        if( measure == ANGLE_IN_DEGREES)  angle *= 180.0/M_PI;
-        result.first  = angle;
-        result.second = 0;
-    }
+template<class P, class Unit = Degrees, class Prec = DoublePrecision, class T = point3_t<P>,
+         class = angle_unit_t<Unit>, class R = precision_t<Prec,T>>
+std::pair<T,int> maxangle( const P &pa,
+                           const P &pb,
+                           const P &pc,
+                           Unit = Unit(),
+                           Prec = Prec())
+{
+    R a2   =  length2( pb, pc, Prec() );
+    R b2   =  length2( pc, pa, Prec() );
+    R c2   =  length2( pa, pb, Prec() );
 
-    if( maxlen == b2 ) {
-        double cosB =  (a2 + c2 - b2)/(2*sqrt(a2*c2) );
-        if( cosB >  1.0) cosB =  1.0;
-        if( cosB < -1.0) cosB = -1.0;
-        double angle  = acos(cosB);
-        if( measure == ANGLE_IN_DEGREES)  angle *= 180.0/M_PI;
-        result.first  = angle;
-        result.second = 1;
-    }
+    R maxlen = max_value(a2,b2,c2);
 
-    if( maxlen == c2 ) {
-        double cosC =  (a2 + b2 - c2)/(2*sqrt(a2*b2) );
-        if( cosC >  1.0) cosC =  1.0;
-        if( cosC < -1.0) cosC = -1.0;
-        double angle = acos(cosC);
-        if( measure == ANGLE_IN_DEGREES)  angle *= 180.0/M_PI;
-        result.first  = angle;
-        result.second = 2;
-    }
+    std::pair<T,int> result;
+    bool ok = true;
+
+    if( maxlen == a2 ) ok = extreme_angle<Unit,Prec>( a2, b2, c2, 0, result ) && ok;
+    if( maxlen == b2 ) ok = extreme_angle<Unit,Prec>( b2, a2, c2, 1, result ) && ok;
+    if( maxlen == c2 ) ok = extreme_angle<Unit,Prec>( c2, a2, b2, 2, result ) && ok;
 
+    if( !ok ) return maxangle( pa, pb, pc, Unit(), DoublePrecision() );
     return result;
 }
 
+template<class P, class T = point3_t<P>>
+std::pair<T,int> maxangle( const P &pa,
+                           const P &pb,
+                           const P &pc,
+                           int measure)
+{
+    if( measure == ANGLE_IN_DEGREES) return maxangle( pa, pb, pc, Degrees() );
+    return maxangle( pa, pb, pc, Radians() );
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
-template<class T>
-std::pair<T,int> minangle( const std::array<T,3> &pa,
-                           const std::array<T,3> &pb,
-                           const std::array<T,3> &pc, 
-			   int measure = ANGLE_IN_DEGREES)
+template<class P, class Unit = Degrees, class Prec = DoublePrecision, class T = point3_t<P>,
+         class = angle_unit_t<Unit>, class R = precision_t<Prec,T>>
+std::pair<T,int> minangle( const P &pa,
+                           const P &pb,
+                           const P &pc,
+                           Unit = Unit(),
+                           Prec = Prec())
 {
-    double a2   =  length2( pb, pc );
-    double b2   =  length2( pc, pa );
-    double c2   =  length2( pa, pb );
+    R a2   =  length2( pb, pc, Prec() );
+    R b2   =  length2( pc, pa, Prec() );
+    R c2   =  length2( pa, pb, Prec() );
 
-    double minlen = min_value(a2,b2,c2);
+    R minlen = min_value(a2,b2,c2);
 
     std::pair<T,int> result;
+    bool ok = true;
 
-    if( minlen == a2) {
-        double cosA =  (b2 + c2 - a2)/(2*sqrt(b2*c2) );
-        if( cosA >  1.0) cosA =  1.0;
-        if( cosA < -1.0) cosA = -1.0;
-        double angle = acos(cosA);
-        if( measure == ANGLE_IN_DEGREES)  angle *= 180.0/M_PI;
-        result.first  = angle;
-        result.second = 0;
-    }
-
-    if( minlen == b2 ) {
-        double cosB =  (a2 + c2 - b2)/(2*sqrt(a2*c2) );
-        if( cosB >  1.0) cosB =  1.0;
-        if( cosB < -1.0) cosB = -1.0;
-        double angle  = acos(cosB);
-        if( measure == ANGLE_IN_DEGREES)  angle *= 180.0/M_PI;
-        result.first  = angle;
-        result.second = 1;
-    }
-
-    if( minlen == c2 ) {
-        double cosC =  (a2 + b2 - c2)/(2*sqrt(a2*b2) );
-        if( cosC >  1.0) cosC =  1.0;
-        if( cosC < -1.0) cosC = -1.0;
-        double angle = acos(cosC);
-        if( measure == ANGLE_IN_DEGREES)  angle *= 180.0/M_PI;
-        result.first  = angle;
-        result.second = 2;
-    }
+    if( minlen == a2 ) ok = extreme_angle<Unit,Prec>( a2, b2, c2, 0, result ) && ok;
+    if( minlen == b2 ) ok = extreme_angle<Unit,Prec>( b2, a2, c2, 1, result ) && ok;
+    if( minlen == c2 ) ok = extreme_angle<Unit,Prec>( c2, a2, b2, 2, result ) && ok;
 
+    if( !ok ) return minangle( pa, pb, pc, Unit(), DoublePrecision() );
     return result;
 }
+
+template<class P, class T = point3_t<P>>
+std::pair<T,int> minangle( const P &pa,
+                           const P &pb,
+                           const P &pc,
+                           int measure)
+{
+    if( measure == ANGLE_IN_DEGREES) return minangle( pa, pb, pc, Degrees() );
+    return minangle( pa, pb, pc, Radians() );
+}
 //
 ////////////////////////////////////////////////////////////////////////////////
 //
-template<class T>
-inline bool isObtuse( const std::array<T,3> &pa,
-                      const std::array<T,3> &pb,
-                      const std::array<T,3> &pc)
+// The classification predicates below work on squared edge lengths only.
+// With the edges sorted s2 <= m2 <= l2, the largest angle (opposite l) has
+// cosine (s2 + m2 - l2)/(2 sqrt(s2 m2)), so comparing it against a threshold
+// needs neither sqrt nor acos once both sides are squared.
+
+// cos^2 of 179.999 degrees, the isDegenerate threshold
+const double DEGENERATE_COS2 = 0.9999999996953826;
+
+template<class P, class T = point3_t<P>>
+inline std::array<double,3> sorted_lengths2( const P &pa,
+                                             const P &pb,
+                                             const P &pc)
 {
-    auto result = maxangle(pa,pb,pc);
-    if( result.first > 90.0) return 1;
-    return 0;
+    double a2 = length2( pb, pc );
+    double b2 = length2( pc, pa );
+    double c2 = length2( pa, pb );
+
+    double s2 = std::min( a2, b2 );
+    double l2 = std::max( a2, b2 );
+    double m2 = std::max( s2, std::min( l2, c2 ));
+    s2 = std::min( s2, c2 );
+    l2 = std::max( l2, c2 );
+    return { s2, m2, l2 };
 }
+
 ////////////////////////////////////////////////////////////////////////////////
 
-template<class T>
-inline bool isDegenerate( const std::array<T,3> &pa,
-                          const std::array<T,3> &pb,
-                          const std::array<T,3> &pc)
+template<class P, class T = point3_t<P>>
+inline bool isObtuse( const P &pa,
+                      const P &pb,
+                      const P &pc)
+{
+    auto e = sorted_lengths2(pa,pb,pc);
+    return e[0] + e[1] < e[2];
+}
+////////////////////////////////////////////////////////////////////////////////
+
+// Largest angle above 179.999 degrees, or two coincident vertices
+template<class P, class T = point3_t<P>>
+inline bool isDegenerate( const P &pa,
+                          const P &pb,
+                          const P &pc)
 {
-    auto result = maxangle(pa,pb,pc);
-    if( result.first > 179.999) return 1;
-    return 0;
+    auto   e   = sorted_lengths2(pa,pb,pc);
+    double num = e[0] + e[1] - e[2];
+    return e[0] == 0.0 || (num < 0.0 && num*num > DEGENERATE_COS2*(4*e[0]*e[1]));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-template<class T>
-inline bool isAcute( const std::array<T,3> &pa,
-                     const std::array<T,3> &pb,
-                     const std::array<T,3> &pc)
+// No angle above 90 degrees; false if two vertices coincide, as the angles
+// are then undefined
+template<class P, class T = point3_t<P>>
+inline bool isAcute( const P &pa,
+                     const P &pb,
+                     const P &pc)
 {
-    auto result = maxangle(pa,pb,pc);
-    if( result.first <= 90.0) return 1;
-    return 0;
+    auto e = sorted_lengths2(pa,pb,pc);
+    return e[0] > 0 && e[0] + e[1] >= e[2];
 }
 ////////////////////////////////////////////////////////////////////////////////
 
-template<class T>
-inline std::array<T,3> normal( const std::array<T,3> &p0,
-                               const std::array<T,3> &p1,
-                               const std::array<T,3> &p2)
+template<class P, class T = point3_t<P>>
+inline std::array<T,3> normal( const P &p0,
+                               const P &p1,
+                               const P &p2)
 {
     auto p1p0   = make_vector( p1, p0);
     auto p2p0   = make_vector( p2, p0);
@@ -242,10 +351,10 @@ inline std::array<T,3> normal( const std::array<T,3> &p0,
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-template<class T>
-inline T area( const std::array<T,3> &pa,
-               const std::array<T,3> &pb,
-               const std::array<T,3> &pc)
+template<class P, class T = point3_t<P>>
+inline T area( const P &pa,
+               const P &pb,
+               const P &pc)
 {
     T a     =  length( pb, pc );
     T b     =  length( pc, pa );
@@ -255,10 +364,10 @@ inline T area( const std::array<T,3> &pa,
     return heron;
 }
 ////////////////////////////////////////////////////////////////////////////////
-template<class T>
-inline std::array<T,3> centroid( const std::array<T,3> &pa,
-                                 const std::array<T,3> &pb,
-                                 const std::array<T,3> &pc)
+template<class P, class T = point3_t<P>>
+inline std::array<T,3> centroid( const P &pa,
+                                 const P &pb,
+                                 const P &pc)
 {
     std::array<T,3> c;
     c[0] = (pa[0] + pb[0] + pc[0])/3.0;
@@ -267,27 +376,48 @@ inline std::array<T,3> centroid( const std::array<T,3> &pa,
     return c;
 }
 ////////////////////////////////////////////////////////////////////////////////
-template<class T>
-inline std::array<T,3> barycoordinates( const std::array<T,3> &pa,
-                                        const std::array<T,3> &pb,
-                                        const std::array<T,3> &pc, 
-					const std::array<T,3> &queryPoint)
+// Heron area of corners of possibly different point types, read as T like
+// area() reads them
+template<class T, class A, class B, class C>
+inline T mixed_area( const A &pa,
+                     const B &pb,
+                     const C &pc)
+{
+    auto edge = []( const auto &p, const auto &q ) {
+        double dx = (T)p[0] - (T)q[0];
+        double dy = (T)p[1] - (T)q[1];
+        double dz = (T)p[2] - (T)q[2];
+        return (T)sqrt( dx*dx + dy*dy + dz*dz );
+    };
+    T a     =  edge( pb, pc );
+    T b     =  edge( pc, pa );
+    T c     =  edge( pa, pb );
+    T s     =  0.5*(a+b+c);
+    T heron =  sqrt(s*(s-a)*(s-b)*(s-c));
+    return heron;
+}
+
+template<class P, class Q, class T = point3_t<P>>
+inline std::array<T,3> barycoordinates( const P &pa,
+                                        const P &pb,
+                                        const P &pc, 
+					const Q &queryPoint)
 {
     std::array<T,3> bcoords;
 
     T total_area = area(pa,pb,pc);
 
-    bcoords[0] = area(pb,pc,queryPoint)/total_area;
-    bcoords[1] = area(pc,pa,queryPoint)/total_area;
-    bcoords[2] = area(pa,pb,queryPoint)/total_area;
+    bcoords[0] = mixed_area<T>(pb,pc,queryPoint)/total_area;
+    bcoords[1] = mixed_area<T>(pc,pa,queryPoint)/total_area;
+    bcoords[2] = mixed_area<T>(pa,pb,queryPoint)/total_area;
 
     return bcoords;
 }
 ////////////////////////////////////////////////////////////////////////////////
-template<class T>
-inline std::array<T,3> circumcenter( const std::array<T,3> &pa,
-                                     const std::array<T,3> &pb,
-                                     const std::array<T,3> &pc)
+template<class P, class T = point3_t<P>>
+inline std::array<T,3> circumcenter( const P &pa,
+                                     const P &pb,
+                                     const P &pc)
 {
    // Source : Wikipedia ...
     std::array<T,3> coords;
@@ -308,10 +438,10 @@ inline std::array<T,3> circumcenter( const std::array<T,3> &pa,
 
 ////////////////////////////////////////////////////////////////////////////////
 
-template<class T>
-inline T circumradius( const std::array<T,3> &pa,
-                       const std::array<T,3> &pb,
-                       const std::array<T,3> &pc)
+template<class P, class T = point3_t<P>>
+inline T circumradius( const P &pa,
+                       const P &pb,
+                       const P &pc)
 {
     T a  =  length( pb, pc );
     T b  =  length( pc, pa );
@@ -324,10 +454,10 @@ inline T circumradius( const std::array<T,3> &pa,
 
 ////////////////////////////////////////////////////////////////////////////////
 
-template<class T>
-inline std::array<T,3> incenter( const std::array<T,3> &pa,
-                                 const std::array<T,3> &pb,
-                                 const std::array<T,3> &pc)
+template<class P, class T = point3_t<P>>
+inline std::array<T,3> incenter( const P &pa,
+                                 const P &pb,
+                                 const P &pc)
 {
     std::array<T,3> coords;
     T a  =  length( pb, pc );
@@ -343,10 +473,10 @@ inline std::array<T,3> incenter( const std::array<T,3> &pa,
 }
 ////////////////////////////////////////////////////////////////////////////////
 
-template<class T>
-inline T inradius( const std::array<T,3> &pa,
-                   const std::array<T,3> &pb,
-                   const std::array<T,3> &pc)
+template<class P, class T = point3_t<P>>
+inline T inradius( const P &pa,
+                   const P &pb,
+                   const P &pc)
 {
     T a  =  length( pb, pc );
     T b  =  length( pc, pa );
@@ -357,3 +487,116 @@ inline T inradius( const std::array<T,3> &pa,
     return r;
 }
 ////////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+// std::array overloads of the original API, so that calls naming the
+// coordinate type, e.g. area<double>(pa, pb, pc), still compile (see the
+// matching block at the end of veclib.hpp).
+
+template<class T>
+inline T minlength( const std::array<T,3> &pa, const std::array<T,3> &pb, const std::array<T,3> &pc)
+{
+    return minlength< std::array<T,3> >( pa, pb, pc );
+}
+
+template<class T>
+inline T maxlength( const std::array<T,3> &pa, const std::array<T,3> &pb, const std::array<T,3> &pc)
+{
+    return maxlength< std::array<T,3> >( pa, pb, pc );
+}
+
+template<class T>
+inline std::array<T,3> angles( const std::array<T,3> &pa, const std::array<T,3> &pb,
+                               const std::array<T,3> &pc, int measure = ANGLE_IN_DEGREES)
+{
+    return angles< std::array<T,3> >( pa, pb, pc, measure );
+}
+
+template<class T>
+inline T angleAt( const std::array<T,3> &pa, const std::array<T,3> &pb,
+                  const std::array<T,3> &pc, int measure = ANGLE_IN_DEGREES)
+{
+    return angleAt< std::array<T,3> >( pa, pb, pc, measure );
+}
+
+template<class T>
+std::pair<T,int> maxangle( const std::array<T,3> &pa, const std::array<T,3> &pb,
+                           const std::array<T,3> &pc, int measure = ANGLE_IN_DEGREES)
+{
+    return maxangle< std::array<T,3> >( pa, pb, pc, measure );
+}
+
+template<class T>
+std::pair<T,int> minangle( const std::array<T,3> &pa, const std::array<T,3> &pb,
+                           const std::array<T,3> &pc, int measure = ANGLE_IN_DEGREES)
+{
+    return minangle< std::array<T,3> >( pa, pb, pc, measure );
+}
+
+template<class T>
+inline bool isObtuse( const std::array<T,3> &pa, const std::array<T,3> &pb, const std::array<T,3> &pc)
+{
+    return isObtuse< std::array<T,3> >( pa, pb, pc );
+}
+
+template<class T>
+inline bool isDegenerate( const std::array<T,3> &pa, const std::array<T,3> &pb, const std::array<T,3> &pc)
+{
+    return isDegenerate< std::array<T,3> >( pa, pb, pc );
+}
+
+template<class T>
+inline bool isAcute( const std::array<T,3> &pa, const std::array<T,3> &pb, const std::array<T,3> &pc)
+{
+    return isAcute< std::array<T,3> >( pa, pb, pc );
+}
+
+template<class T>
+inline std::array<T,3> normal( const std::array<T,3> &p0, const std::array<T,3> &p1, const std::array<T,3> &p2)
+{
+    return normal< std::array<T,3> >( p0, p1, p2 );
+}
+
+template<class T>
+inline T area( const std::array<T,3> &pa, const std::array<T,3> &pb, const std::array<T,3> &pc)
+{
+    return area< std::array<T,3> >( pa, pb, pc );
+}
+
+template<class T>
+inline std::array<T,3> centroid( const std::array<T,3> &pa, const std::array<T,3> &pb, const std::array<T,3> &pc)
+{
+    return centroid< std::array<T,3> >( pa, pb, pc );
+}
+
+template<class T>
+inline std::array<T,3> barycoordinates( const std::array<T,3> &pa, const std::array<T,3> &pb,
+                                        const std::array<T,3> &pc, const std::array<T,3> &queryPoint)
+{
+    return barycoordinates< std::array<T,3> >( pa, pb, pc, queryPoint );
+}
+
+template<class T>
+inline std::array<T,3> circumcenter( const std::array<T,3> &pa, const std::array<T,3> &pb, const std::array<T,3> &pc)
+{
+    return circumcenter< std::array<T,3> >( pa, pb, pc );
+}
+
+template<class T>
+inline T circumradius( const std::array<T,3> &pa, const std::array<T,3> &pb, const std::array<T,3> &pc)
+{
+    return circumradius< std::array<T,3> >( pa, pb, pc );
+}
+
+template<class T>
+inline std::array<T,3> incenter( const std::array<T,3> &pa, const std::array<T,3> &pb, const std::array<T,3> &pc)
+{
+    return incenter< std::array<T,3> >( pa, pb, pc );
+}
+
+template<class T>
+inline T inradius( const std::array<T,3> &pa, const std::array<T,3> &pb, const std::array<T,3> &pc)
+{
+    return inradius< std::array<T,3> >( pa, pb, pc );
+}
+////////////////////////////////////////////////////////////////////////////////
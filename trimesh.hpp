@@ -0,0 +1,332 @@
+#pragma once
+
+#include "trilib.hpp"
+
+///////////////////////////////////////////////////////////////////////////////
+// Non-owning view of an indexed triangle mesh.
+//
+// The view wraps a vertex buffer of nverts xyz triples and a face buffer of
+// nfaces index triples, both owned by the caller. Vertices are read in place
+// through StridedPoint accessors, so evaluating a face costs no gather copy.
+// Both buffers may be strided and unaligned, which lets the view sit directly
+// on interleaved vertex buffers or on memory-mapped file records.
+//
+// TriangleSoupView is the unindexed counterpart: every face record holds its
+// three corners itself, as in binary STL.
+//
+// Every trilib.hpp function has two overloads on either view:
+//   f(mesh, face, ...)  evaluates one face and returns the scalar result
+//   f(mesh, out, ...)   evaluates every face into out[0..nfaces())
+///////////////////////////////////////////////////////////////////////////////
+
+template<class T>
+class IndexedMeshView
+{
+public:
+    IndexedMeshView() = default;
+
+    // Packed buffers: nverts xyz triples and nfaces int[3] triples
+    IndexedMeshView( const T *vertices, size_t nverts, const int *indices, size_t nfaces)
+        : IndexedMeshView( vertices, nverts, 3*sizeof(T), indices, nfaces, 3*sizeof(int)) {}
+
+    // Strided buffers: vertex i (xyz contiguous) starts i*vstride bytes into
+    // vertices, and the three ints of face f start f*istride bytes into indices.
+    IndexedMeshView( const void *vertices, size_t nverts, size_t vstride,
+                     const void *indices,  size_t nfaces, size_t istride)
+        : verts(static_cast<const unsigned char*>(vertices)), vcount(nverts), vstride(vstride),
+          index(static_cast<const unsigned char*>(indices)), fcount(nfaces), istride(istride) {}
+
+    size_t nvertices() const { return vcount; }
+    size_t nfaces()    const { return fcount; }
+
+    StridedPoint<T> vertex( size_t i ) const
+    {
+        return StridedPoint<T>( verts + i*vstride );
+    }
+
+    std::array<int,3> face( size_t f ) const
+    {
+        std::array<int,3> ids;
+        memcpy( ids.data(), index + f*istride, sizeof(ids) );
+        return ids;
+    }
+
+    // Corner k (0,1,2) of face f
+    StridedPoint<T> corner( size_t f, int k ) const
+    {
+        int id;
+        memcpy( &id, index + f*istride + k*sizeof(int), sizeof(int) );
+        return vertex(id);
+    }
+
+private:
+    const unsigned char *verts   = nullptr;
+    size_t               vcount  = 0;
+    size_t               vstride = 3*sizeof(T);
+    const unsigned char *index   = nullptr;
+    size_t               fcount  = 0;
+    size_t               istride = 3*sizeof(int);
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+template<class T>
+class TriangleSoupView
+{
+public:
+    TriangleSoupView() = default;
+
+    // Packed buffer: nfaces records of nine coordinates (pa, pb, pc)
+    TriangleSoupView( const T *corners, size_t nfaces)
+        : TriangleSoupView( corners, nfaces, 9*sizeof(T), 3*sizeof(T)) {}
+
+    // Strided buffer: corner k (xyz contiguous) of face f starts
+    // f*fstride + k*kstride bytes into corners.
+    TriangleSoupView( const void *corners, size_t nfaces, size_t fstride, size_t kstride)
+        : base(static_cast<const unsigned char*>(corners)), fcount(nfaces),
+          fstride(fstride), kstride(kstride) {}
+
+    size_t nfaces() const { return fcount; }
+
+    StridedPoint<T> corner( size_t f, int k ) const
+    {
+        return StridedPoint<T>( base + f*fstride + k*kstride );
+    }
+
+private:
+    const unsigned char *base    = nullptr;
+    size_t               fcount  = 0;
+    size_t               fstride = 9*sizeof(T);
+    size_t               kstride = 3*sizeof(T);
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Coordinate type of a mesh view; substitution fails for anything else, so
+// the overloads below never compete with the TriangleBatch kernels.
+
+template<class Mesh> struct mesh_traits {};
+template<class T> struct mesh_traits< IndexedMeshView<T> >  { typedef T value_type; };
+template<class T> struct mesh_traits< TriangleSoupView<T> > { typedef T value_type; };
+
+template<class Mesh>
+using mesh_value_t = typename mesh_traits<Mesh>::value_type;
+
+///////////////////////////////////////////////////////////////////////////////
+// Per-face evaluators
+///////////////////////////////////////////////////////////////////////////////
+
+template<class Mesh, class T = mesh_value_t<Mesh>>
+inline T minlength( const Mesh &mesh, size_t f)
+{
+    return minlength( mesh.corner(f,0), mesh.corner(f,1), mesh.corner(f,2) );
+}
+
+template<class Mesh, class T = mesh_value_t<Mesh>>
+inline T maxlength( const Mesh &mesh, size_t f)
+{
+    return maxlength( mesh.corner(f,0), mesh.corner(f,1), mesh.corner(f,2) );
+}
+
+template<class Mesh, class Unit = Degrees, class T = mesh_value_t<Mesh>>
+inline std::array<T,3> angles( const Mesh &mesh, size_t f,
+                               Unit measure = Unit())
+{
+    return angles( mesh.corner(f,0), mesh.corner(f,1), mesh.corner(f,2), measure );
+}
+
+// Angle of face f at corner k
+template<class Mesh, class Unit = Degrees, class T = mesh_value_t<Mesh>>
+inline T angleAt( const Mesh &mesh, size_t f, int k,
+                  Unit measure = Unit())
+{
+    return angleAt( mesh.corner(f,k), mesh.corner(f,(k+1)%3), mesh.corner(f,(k+2)%3), measure );
+}
+
+template<class Mesh, class Unit = Degrees, class T = mesh_value_t<Mesh>>
+inline std::pair<T,int> maxangle( const Mesh &mesh, size_t f,
+                                  Unit measure = Unit())
+{
+    return maxangle( mesh.corner(f,0), mesh.corner(f,1), mesh.corner(f,2), measure );
+}
+
+template<class Mesh, class Unit = Degrees, class T = mesh_value_t<Mesh>>
+inline std::pair<T,int> minangle( const Mesh &mesh, size_t f,
+                                  Unit measure = Unit())
+{
+    return minangle( mesh.corner(f,0), mesh.corner(f,1), mesh.corner(f,2), measure );
+}
+
+template<class Mesh, class T = mesh_value_t<Mesh>>
+inline bool isObtuse( const Mesh &mesh, size_t f)
+{
+    return isObtuse( mesh.corner(f,0), mesh.corner(f,1), mesh.corner(f,2) );
+}
+
+template<class Mesh, class T = mesh_value_t<Mesh>>
+inline bool isDegenerate( const Mesh &mesh, size_t f)
+{
+    return isDegenerate( mesh.corner(f,0), mesh.corner(f,1), mesh.corner(f,2) );
+}
+
+template<class Mesh, class T = mesh_value_t<Mesh>>
+inline bool isAcute( const Mesh &mesh, size_t f)
+{
+    return isAcute( mesh.corner(f,0), mesh.corner(f,1), mesh.corner(f,2) );
+}
+
+template<class Mesh, class T = mesh_value_t<Mesh>>
+inline std::array<T,3> normal( const Mesh &mesh, size_t f)
+{
+    return normal( mesh.corner(f,0), mesh.corner(f,1), mesh.corner(f,2) );
+}
+
+template<class Mesh, class T = mesh_value_t<Mesh>>
+inline T area( const Mesh &mesh, size_t f)
+{
+    return area( mesh.corner(f,0), mesh.corner(f,1), mesh.corner(f,2) );
+}
+
+template<class Mesh, class T = mesh_value_t<Mesh>>
+inline std::array<T,3> centroid( const Mesh &mesh, size_t f)
+{
+    return centroid( mesh.corner(f,0), mesh.corner(f,1), mesh.corner(f,2) );
+}
+
+template<class Mesh, class Q, class T = mesh_value_t<Mesh>>
+inline std::array<T,3> barycoordinates( const Mesh &mesh, size_t f,
+                                        const Q &queryPoint)
+{
+    return barycoordinates( mesh.corner(f,0), mesh.corner(f,1), mesh.corner(f,2), queryPoint );
+}
+
+template<class Mesh, class T = mesh_value_t<Mesh>>
+inline std::array<T,3> circumcenter( const Mesh &mesh, size_t f)
+{
+    return circumcenter( mesh.corner(f,0), mesh.corner(f,1), mesh.corner(f,2) );
+}
+
+template<class Mesh, class T = mesh_value_t<Mesh>>
+inline T circumradius( const Mesh &mesh, size_t f)
+{
+    return circumradius( mesh.corner(f,0), mesh.corner(f,1), mesh.corner(f,2) );
+}
+
+template<class Mesh, class T = mesh_value_t<Mesh>>
+inline std::array<T,3> incenter( const Mesh &mesh, size_t f)
+{
+    return incenter( mesh.corner(f,0), mesh.corner(f,1), mesh.corner(f,2) );
+}
+
+template<class Mesh, class T = mesh_value_t<Mesh>>
+inline T inradius( const Mesh &mesh, size_t f)
+{
+    return inradius( mesh.corner(f,0), mesh.corner(f,1), mesh.corner(f,2) );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Whole-mesh evaluators
+///////////////////////////////////////////////////////////////////////////////
+
+template<class Mesh, class T = mesh_value_t<Mesh>>
+inline void minlength( const Mesh &mesh, T *out)
+{
+    for( size_t f = 0; f < mesh.nfaces(); f++) out[f] = minlength(mesh, f);
+}
+
+template<class Mesh, class T = mesh_value_t<Mesh>>
+inline void maxlength( const Mesh &mesh, T *out)
+{
+    for( size_t f = 0; f < mesh.nfaces(); f++) out[f] = maxlength(mesh, f);
+}
+
+template<class Mesh, class Unit = Degrees, class T = mesh_value_t<Mesh>>
+inline void angles( const Mesh &mesh, std::array<T,3> *out,
+                    Unit measure = Unit())
+{
+    for( size_t f = 0; f < mesh.nfaces(); f++) out[f] = angles(mesh, f, measure);
+}
+
+template<class Mesh, class Unit = Degrees, class T = mesh_value_t<Mesh>>
+inline void maxangle( const Mesh &mesh, std::pair<T,int> *out,
+                      Unit measure = Unit())
+{
+    for( size_t f = 0; f < mesh.nfaces(); f++) out[f] = maxangle(mesh, f, measure);
+}
+
+template<class Mesh, class Unit = Degrees, class T = mesh_value_t<Mesh>>
+inline void minangle( const Mesh &mesh, std::pair<T,int> *out,
+                      Unit measure = Unit())
+{
+    for( size_t f = 0; f < mesh.nfaces(); f++) out[f] = minangle(mesh, f, measure);
+}
+
+template<class Mesh, class T = mesh_value_t<Mesh>>
+inline void isObtuse( const Mesh &mesh, bool *out)
+{
+    for( size_t f = 0; f < mesh.nfaces(); f++) out[f] = isObtuse(mesh, f);
+}
+
+template<class Mesh, class T = mesh_value_t<Mesh>>
+inline void isDegenerate( const Mesh &mesh, bool *out)
+{
+    for( size_t f = 0; f < mesh.nfaces(); f++) out[f] = isDegenerate(mesh, f);
+}
+
+template<class Mesh, class T = mesh_value_t<Mesh>>
+inline void isAcute( const Mesh &mesh, bool *out)
+{
+    for( size_t f = 0; f < mesh.nfaces(); f++) out[f] = isAcute(mesh, f);
+}
+
+template<class Mesh, class T = mesh_value_t<Mesh>>
+inline void normal( const Mesh &mesh, std::array<T,3> *out)
+{
+    for( size_t f = 0; f < mesh.nfaces(); f++) out[f] = normal(mesh, f);
+}
+
+template<class Mesh, class T = mesh_value_t<Mesh>>
+inline void area( const Mesh &mesh, T *out)
+{
+    for( size_t f = 0; f < mesh.nfaces(); f++) out[f] = area(mesh, f);
+}
+
+template<class Mesh, class T = mesh_value_t<Mesh>>
+inline void centroid( const Mesh &mesh, std::array<T,3> *out)
+{
+    for( size_t f = 0; f < mesh.nfaces(); f++) out[f] = centroid(mesh, f);
+}
+
+template<class Mesh, class T = mesh_value_t<Mesh>>
+inline void circumcenter( const Mesh &mesh, std::array<T,3> *out)
+{
+    for( size_t f = 0; f < mesh.nfaces(); f++) out[f] = circumcenter(mesh, f);
+}
+
+template<class Mesh, class T = mesh_value_t<Mesh>>
+inline void circumradius( const Mesh &mesh, T *out)
+{
+    for( size_t f = 0; f < mesh.nfaces(); f++) out[f] = circumradius(mesh, f);
+}
+
+template<class Mesh, class T = mesh_value_t<Mesh>>
+inline void incenter( const Mesh &mesh, std::array<T,3> *out)
+{
+    for( size_t f = 0; f < mesh.nfaces(); f++) out[f] = incenter(mesh, f);
+}
+
+template<class Mesh, class T = mesh_value_t<Mesh>>
+inline void inradius( const Mesh &mesh, T *out)
+{
+    for( size_t f = 0; f < mesh.nfaces(); f++) out[f] = inradius(mesh, f);
+}
+
+// Total surface area of the mesh
+template<class Mesh, class T = mesh_value_t<Mesh>>
+inline double total_area( const Mesh &mesh)
+{
+    double sum = 0.0;
+    for( size_t f = 0; f < mesh.nfaces(); f++) sum += area(mesh, f);
+    return sum;
+}
+
+///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,344 @@
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "trimesh.hpp"
+
+///////////////////////////////////////////////////////////////////////////////
+// Zero-copy readers for binary STL and binary PLY files (POSIX).
+//
+// The file is memory-mapped read-only and exposed as a TriangleSoupView
+// (STL) or an IndexedMeshView (PLY) over the mapped bytes, so faces are read
+// straight from the page cache by the trimesh.hpp evaluators, classify() and
+// MeshQualityAnalyzer. Opening parses only the header; nothing is allocated
+// per face. The views stay valid for as long as the file object lives.
+//
+// Malformed or unsupported files throw std::runtime_error.
+///////////////////////////////////////////////////////////////////////////////
+
+class MappedFile
+{
+public:
+    MappedFile() = default;
+
+    explicit MappedFile( const std::string &path ) : name(path)
+    {
+        int fd = ::open( path.c_str(), O_RDONLY );
+        if( fd < 0 ) fail( strerror(errno) );
+
+        struct stat st;
+        if( fstat(fd, &st) != 0 ) {
+            int err = errno;
+            ::close(fd);
+            fail( strerror(err) );
+        }
+        length = st.st_size;
+
+        if( length > 0 ) {
+            void *p = mmap( nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0 );
+            if( p == MAP_FAILED ) {
+                int err = errno;
+                ::close(fd);
+                fail( strerror(err) );
+            }
+            bytes = static_cast<const unsigned char*>(p);
+            madvise( p, length, MADV_SEQUENTIAL );
+        }
+        ::close(fd);
+    }
+
+    ~MappedFile()
+    {
+        if( bytes ) munmap( const_cast<unsigned char*>(bytes), length );
+    }
+
+    MappedFile( const MappedFile & ) = delete;
+    MappedFile &operator=( const MappedFile & ) = delete;
+
+    const unsigned char *data() const { return bytes; }
+    size_t               size() const { return length; }
+    const std::string   &path() const { return name; }
+
+    [[noreturn]] void fail( const std::string &msg ) const
+    {
+        throw std::runtime_error( name + ": " + msg );
+    }
+
+private:
+    std::string          name;
+    const unsigned char *bytes  = nullptr;
+    size_t               length = 0;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Binary STL: 80-byte header, uint32 face count, then one 50-byte record per
+// face (float normal[3], float corners[3][3], uint16 attribute).
+
+class StlFile
+{
+public:
+    static const size_t HEADER_SIZE = 84;
+    static const size_t RECORD_SIZE = 50;
+
+    explicit StlFile( const std::string &path ) : file(path)
+    {
+        if( file.size() < HEADER_SIZE ) file.fail( "too short for a binary STL header" );
+
+        uint32_t n;
+        memcpy( &n, file.data() + 80, sizeof(n) );
+        count = n;
+
+        if( file.size() != HEADER_SIZE + count*RECORD_SIZE ) {
+            if( memcmp(file.data(), "solid", 5) == 0 )
+                file.fail( "ASCII STL is not supported" );
+            file.fail( "size does not match the face count of " + std::to_string(count) );
+        }
+    }
+
+    size_t nfaces() const { return count; }
+
+    TriangleSoupView<float> mesh() const
+    {
+        return TriangleSoupView<float>( file.data() + HEADER_SIZE + 3*sizeof(float),
+                                        count, RECORD_SIZE, 3*sizeof(float) );
+    }
+
+    // Facet normal as stored in the file
+    StridedPoint<float> facet_normal( size_t f ) const
+    {
+        return StridedPoint<float>( file.data() + HEADER_SIZE + f*RECORD_SIZE );
+    }
+
+private:
+    MappedFile file;
+    size_t     count = 0;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Binary little-endian PLY with a "vertex" element holding consecutive
+// float or double x, y, z properties and a "face" element whose index list
+// (int or uint items) has exactly three entries on every face. Any other
+// properties and elements are skipped, as long as they have a fixed size.
+
+class PlyFile
+{
+public:
+    // check = false skips the scan that makes sure every face is a triangle,
+    // for callers that read and check the face records themselves
+    explicit PlyFile( const std::string &path, bool check = true ) : file(path)
+    {
+        parse_header();
+        if( check ) check_faces( file.data() + foffset, fcount, 0 );
+    }
+
+    size_t nvertices() const { return vcount; }
+    size_t nfaces()    const { return fcount; }
+
+    // Size in bytes of one vertex coordinate: 4 (float) or 8 (double)
+    size_t coordinate_size() const { return csize; }
+
+    // Byte offset of the face block in the file and size of one face record
+    size_t face_offset() const { return foffset; }
+    size_t face_stride() const { return fstride; }
+
+    template<class T>
+    IndexedMeshView<T> mesh() const
+    {
+        return mesh<T>( file.data() + foffset, fcount );
+    }
+
+    // The mapped vertices with nfaces face records copied out of the file
+    template<class T>
+    IndexedMeshView<T> mesh( const void *records, size_t nfaces ) const
+    {
+        if( sizeof(T) != csize )
+            file.fail( "vertex coordinates are " + std::string(csize == 4 ? "float" : "double") );
+        return IndexedMeshView<T>( file.data() + voffset, vcount, vstride,
+                                   static_cast<const unsigned char*>(records) + (ioffset - foffset),
+                                   nfaces, fstride );
+    }
+
+    // The views assume fixed-size face records, so every index list must
+    // hold exactly three entries, and read the vertices unchecked, so every
+    // index must name one of the nvertices() vertices
+    void check_faces( const void *records, size_t nfaces, size_t first_face ) const
+    {
+        const unsigned char *p = static_cast<const unsigned char*>(records);
+        for( size_t f = 0; f < nfaces; f++, p += fstride) {
+            uint32_t n = 0;
+            memcpy( &n, p, count_size );   // little-endian host
+            if( n != 3 ) file.fail( "face " + std::to_string(first_face + f) + " is not a triangle" );
+            for( int k = 0; k < 3; k++) {
+                uint32_t id;
+                memcpy( &id, p + (ioffset - foffset) + k*sizeof(id), sizeof(id) );
+                if( (index_signed && id > INT32_MAX) || id >= vcount )
+                    file.fail( "face " + std::to_string(first_face + f) + " has an out of range vertex index" );
+            }
+        }
+    }
+
+private:
+    struct Property
+    {
+        std::string name;
+        size_t      size       = 0;   // scalar size, or list item size
+        size_t      count_size = 0;   // list count size, 0 for scalars
+        bool        is_float   = false;
+        bool        is_signed  = false;
+    };
+
+    struct Element
+    {
+        std::string           name;
+        size_t                count = 0;
+        std::vector<Property> props;
+    };
+
+    static size_t type_size( const std::string &t, bool *is_float = nullptr )
+    {
+        if( is_float ) *is_float = (t == "float" || t == "float32" || t == "double" || t == "float64");
+        if( t == "char"   || t == "int8"    || t == "uchar"  || t == "uint8"  ) return 1;
+        if( t == "short"  || t == "int16"   || t == "ushort" || t == "uint16" ) return 2;
+        if( t == "int"    || t == "int32"   || t == "uint"   || t == "uint32" ||
+            t == "float"  || t == "float32" ) return 4;
+        if( t == "double" || t == "float64" ) return 8;
+        return 0;
+    }
+
+    void parse_header()
+    {
+        const char *text = reinterpret_cast<const char*>( file.data() );
+        const char *end  = text + file.size();
+        // Header lines may end in "\r\n"; the body starts after end_header's newline
+        const char  tag[] = "\nend_header";
+        const char *hend = std::search( text, end, tag, tag + sizeof(tag) - 1 );
+        const char *body = hend == end ? end : hend + sizeof(tag) - 1;
+        if( body != end && *body == '\r' ) body++;
+        if( file.size() < 4 || memcmp(text, "ply", 3) != 0 || body == end || *body != '\n' )
+            file.fail( "not a PLY file" );
+
+        std::istringstream header( std::string(text, hend) );
+        std::vector<Element> elements;
+        std::string line;
+        std::getline( header, line );   // "ply"
+        while( std::getline(header, line) ) {
+            if( !line.empty() && line.back() == '\r' ) line.pop_back();
+            std::istringstream ls(line);
+            std::string word;
+            ls >> word;
+            if( word == "format" ) {
+                std::string fmt;
+                ls >> fmt;
+                if( fmt != "binary_little_endian" )
+                    file.fail( "only binary_little_endian PLY is supported, not " + fmt );
+            } else if( word == "element" ) {
+                Element e;
+                ls >> e.name >> e.count;
+                elements.push_back(e);
+            } else if( word == "property" ) {
+                if( elements.empty() ) file.fail( "property outside an element" );
+                Property p;
+                std::string type;
+                ls >> type;
+                if( type == "list" ) {
+                    std::string ctype;
+                    ls >> ctype >> type;
+                    p.count_size = type_size(ctype);
+                    if( p.count_size == 0 ) file.fail( "unknown type " + ctype );
+                }
+                p.size      = type_size( type, &p.is_float );
+                p.is_signed = (type == "int" || type == "int32");
+                if( p.size == 0 ) file.fail( "unknown type " + type );
+                ls >> p.name;
+                elements.back().props.push_back(p);
+            }
+        }
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        file.fail( "binary_little_endian PLY needs a little-endian host" );
+#endif
+
+        size_t offset = (body + 1) - text;
+        bool   have_vertices = false, have_faces = false;
+        for( const Element &e : elements ) {
+            size_t stride = 0, list_offset = 0;
+            int    nlists = 0;
+            for( const Property &p : e.props ) {
+                if( p.count_size ) {
+                    list_offset = stride;
+                    stride += p.count_size + 3*p.size;
+                    nlists++;
+                } else {
+                    stride += p.size;
+                }
+            }
+
+            if( e.name == "vertex" ) {
+                parse_vertex(e, offset, stride);
+                have_vertices = true;
+            } else if( e.name == "face" ) {
+                const Property *list = nullptr;
+                for( const Property &p : e.props ) if( p.count_size ) list = &p;
+                if( nlists != 1 ) file.fail( "face element needs exactly one index list" );
+                if( list->size != 4 || list->is_float ) file.fail( "face indices must be int or uint" );
+                fcount     = e.count;
+                fstride    = stride;
+                foffset    = offset;
+                ioffset    = offset + list_offset + list->count_size;
+                count_size = list->count_size;
+                index_signed = list->is_signed;
+                have_faces = true;
+            } else if( nlists ) {
+                file.fail( "element " + e.name + " has variable-size records" );
+            }
+            if( stride && e.count > (SIZE_MAX - offset)/stride ) file.fail( "truncated data" );
+            offset += e.count*stride;
+        }
+
+        if( !have_vertices || !have_faces ) file.fail( "missing vertex or face element" );
+        if( offset > file.size() ) file.fail( "truncated data" );
+    }
+
+    void parse_vertex( const Element &e, size_t offset, size_t stride )
+    {
+        for( const Property &p : e.props )
+            if( p.count_size ) file.fail( "vertex element has a list property" );
+
+        size_t pos = 0;
+        for( size_t i = 0; i < e.props.size(); i++) {
+            const Property &p = e.props[i];
+            if( p.name == "x" ) {
+                if( i + 2 >= e.props.size() || e.props[i+1].name != "y" || e.props[i+2].name != "z" )
+                    file.fail( "vertex x, y, z must be consecutive" );
+                for( int k = 0; k < 3; k++)
+                    if( !e.props[i+k].is_float || e.props[i+k].size != p.size || e.props[i+k].count_size )
+                        file.fail( "vertex x, y, z must all be float or all be double" );
+                vcount  = e.count;
+                vstride = stride;
+                voffset = offset + pos;
+                csize   = p.size;
+                return;
+            }
+            pos += p.size;
+        }
+        file.fail( "vertex element has no x property" );
+    }
+
+    MappedFile file;
+    size_t     vcount  = 0, vstride = 0, voffset = 0, csize = 0;
+    size_t     fcount  = 0, fstride = 0, foffset = 0, ioffset = 0, count_size = 0;
+    bool       index_signed = false;
+};
+
+///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,142 @@
+#pragma once
+
+#include "trilib.hpp"
+
+///////////////////////////////////////////////////////////////////////////////
+// Fused evaluation of several triangle quantities.
+//
+// The free functions in trilib.hpp each recompute the three edge lengths.
+// TriangleMetrics computes the squared and plain edge lengths once and
+// derives every requested quantity from them, so evaluating N quantities
+// costs three square roots instead of 3N.
+//
+// Edge a is opposite pa (|pb-pc|), b is opposite pb and c is opposite pc,
+// matching the convention used throughout trilib.hpp.
+//
+// Trig selects the acos used for the angles (TrigExact, TrigFine or
+// TrigCoarse from fastmath.hpp).
+///////////////////////////////////////////////////////////////////////////////
+
+enum TriangleMetricFlags : unsigned
+{
+    METRIC_LENGTHS      = 1u << 0,   // lengths, lengths2, minlength, maxlength
+    METRIC_ANGLES       = 1u << 1,   // angles, minangle, maxangle
+    METRIC_AREA         = 1u << 2,
+    METRIC_CIRCUMRADIUS = 1u << 3,
+    METRIC_INRADIUS     = 1u << 4,
+    METRIC_CIRCUMCENTER = 1u << 5,
+    METRIC_INCENTER     = 1u << 6,
+    METRIC_ALL          = (1u << 7) - 1
+};
+
+template<class T, class Trig = TrigExact>
+struct TriangleMetrics
+{
+    explicit TriangleMetrics( unsigned which = METRIC_ALL, int measure = ANGLE_IN_DEGREES)
+        : which(which), measure(measure) {}
+
+    template<class P>
+    void compute( const P &pa, const P &pb, const P &pc);
+
+    bool has( unsigned flags ) const { return (which & flags) == flags; }
+
+    unsigned which;
+    int      measure;
+
+    std::array<T,3>  lengths2  = {0, 0, 0};
+    std::array<T,3>  lengths   = {0, 0, 0};
+    T                minlength = 0;
+    T                maxlength = 0;
+
+    std::array<T,3>  angles    = {0, 0, 0};
+    std::pair<T,int> minangle  = {0, 0};
+    std::pair<T,int> maxangle  = {0, 0};
+
+    T                area         = 0;
+    T                circumradius = 0;
+    T                inradius     = 0;
+    std::array<T,3>  circumcenter = {0, 0, 0};
+    std::array<T,3>  incenter     = {0, 0, 0};
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+template<class T, class Trig>
+template<class P>
+void TriangleMetrics<T,Trig>::compute( const P &pa, const P &pb, const P &pc)
+{
+    // Same arithmetic as JMath::length2/length, so every quantity below is
+    // bit-identical to its trilib.hpp counterpart (circumcenter excepted,
+    // which uses the exact squared lengths instead of squaring a sqrt).
+    const bool need_lengths = which & (METRIC_LENGTHS | METRIC_AREA | METRIC_CIRCUMRADIUS |
+                                       METRIC_INRADIUS | METRIC_INCENTER);
+
+    const P *p[3] = { &pb, &pc, &pa };
+    const P *q[3] = { &pc, &pa, &pb };
+    for( int i = 0; i < 3; i++) {
+        double dx = (*p[i])[0] - (*q[i])[0];
+        double dy = (*p[i])[1] - (*q[i])[1];
+        double dz = (*p[i])[2] - (*q[i])[2];
+        double d2 = dx*dx + dy*dy + dz*dz;
+        lengths2[i] = d2;
+        if( need_lengths ) lengths[i] = sqrt(d2);
+    }
+
+    const T a  = lengths[0],  b  = lengths[1],  c  = lengths[2];
+    const T a2 = lengths2[0], b2 = lengths2[1], c2 = lengths2[2];
+
+    if( which & METRIC_LENGTHS ) {
+        minlength = min_value(a,b,c);
+        maxlength = max_value(a,b,c);
+    }
+
+    if( which & METRIC_ANGLES ) {
+        double da2 = a2, db2 = b2, dc2 = c2;
+        double cosang[3];
+        cosang[0] = (db2 + dc2 - da2)/(2*sqrt(db2*dc2) );
+        cosang[1] = (da2 + dc2 - db2)/(2*sqrt(da2*dc2) );
+        cosang[2] = (da2 + db2 - dc2)/(2*sqrt(da2*db2) );
+        for( int i = 0; i < 3; i++) {
+            if( cosang[i] >  1.0) cosang[i] =  1.0;
+            if( cosang[i] < -1.0) cosang[i] = -1.0;
+            angles[i] = Trig::acos(cosang[i]);
+            if( measure == ANGLE_IN_DEGREES) angles[i] *= 180/M_PI;
+        }
+        int imin = 0, imax = 0;
+        for( int i = 1; i < 3; i++) {
+            if( angles[i] <= angles[imin] ) imin = i;
+            if( angles[i] >= angles[imax] ) imax = i;
+        }
+        minangle = std::make_pair(angles[imin], imin);
+        maxangle = std::make_pair(angles[imax], imax);
+    }
+
+    if( which & (METRIC_AREA | METRIC_CIRCUMRADIUS) ) {
+        T s     = 0.5*(a+b+c);
+        T heron = sqrt(s*(s-a)*(s-b)*(s-c));
+        area    = heron;
+        if( which & METRIC_CIRCUMRADIUS )
+            circumradius = 0.25*a*b*c/heron;
+    }
+
+    if( which & METRIC_INRADIUS ) {
+        T s      = a+b+c;
+        inradius = 0.5*sqrt((b+c-a)*(c+a-b)*(a+b-c)/s);
+    }
+
+    if( which & METRIC_CIRCUMCENTER ) {
+        T u  =  a2*(b2 + c2 - a2);
+        T v  =  b2*(c2 + a2 - b2);
+        T w  =  c2*(a2 + b2 - c2);
+        for( int k = 0; k < 3; k++)
+            circumcenter[k] = (u*pa[k] + v*pb[k] + w*pc[k] )/(u+v+w);
+    }
+
+    if( which & METRIC_INCENTER ) {
+        T t = a + b + c;
+        for( int k = 0; k < 3; k++)
+            incenter[k] = (a*pa[k] + b*pb[k] + c*pc[k] )/t;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include "threadpool.hpp"
+#include "triadjacency.hpp"
+
+///////////////////////////////////////////////////////////////////////////////
+// Smooth per-vertex normals of an indexed mesh.
+//
+// Scattering each face's normal into its three vertices makes parallel
+// threads write to the same vertices. Instead, VertexCorners
+// (triadjacency.hpp) lists the corners (3*face + k) around every vertex in
+// CSR form, and each vertex gathers its own corners: threads write disjoint
+// output ranges, with no atomics, locks or per-thread copies of the output.
+//
+// A corner contributes the cross product of its two edges, which is twice
+// the face area times the unit face normal (area weighting), or the unit
+// normal times the angleAt() of the corner in radians (angle weighting,
+// Thurmer and Wuthrich 1998, which does not depend on how a surface is
+// triangulated). Sums are normalized; vertices with no face of nonzero area
+// get {0, 0, 0}.
+//
+// The CSR depends on the faces only, so it is built once and reused while
+// vertices move. Its parallel build gives the same lists as the serial one,
+// and the normals are bit-identical for any thread count.
+///////////////////////////////////////////////////////////////////////////////
+
+enum NormalWeighting { NORMAL_AREA_WEIGHTED = 0, NORMAL_ANGLE_WEIGHTED = 1 };
+
+// Normals of vertices [first, last)
+template<class Mesh, class T = mesh_value_t<Mesh>>
+inline void vertex_normals( const Mesh &mesh, const VertexCorners &vc, size_t first, size_t last,
+                            std::array<T,3> *out, NormalWeighting weighting )
+{
+    const uint32_t *offsets = vc.corner_offsets().data();
+    const uint32_t *corners = vc.corners().data();
+    for( size_t v = first; v < last; v++) {
+        double nx = 0, ny = 0, nz = 0;
+        for( uint32_t j = offsets[v]; j < offsets[v+1]; j++) {
+            size_t f = corners[j]/3;
+            int    k = corners[j]%3;
+            auto   pa = mesh.corner(f, k), pb = mesh.corner(f, (k+1)%3), pc = mesh.corner(f, (k+2)%3);
+
+            double ux = (double)pb[0] - pa[0], uy = (double)pb[1] - pa[1], uz = (double)pb[2] - pa[2];
+            double wx = (double)pc[0] - pa[0], wy = (double)pc[1] - pa[1], wz = (double)pc[2] - pa[2];
+            double cx = uy*wz - uz*wy, cy = uz*wx - ux*wz, cz = ux*wy - uy*wx;
+
+            if( weighting == NORMAL_ANGLE_WEIGHTED ) {
+                double mag = std::sqrt(cx*cx + cy*cy + cz*cz);
+                if( !(mag > 0) ) continue;
+                double s = angleAt( pa, pb, pc, Radians() )/mag;
+                cx *= s;
+                cy *= s;
+                cz *= s;
+            }
+            nx += cx;
+            ny += cy;
+            nz += cz;
+        }
+
+        double mag = std::sqrt(nx*nx + ny*ny + nz*nz);
+        if( mag > 0 ) out[v] = { (T)(nx/mag), (T)(ny/mag), (T)(nz/mag) };
+        else          out[v] = { 0, 0, 0 };
+    }
+}
+
+template<class Mesh, class T = mesh_value_t<Mesh>>
+inline void vertex_normals( const Mesh &mesh, const VertexCorners &vc, std::array<T,3> *out,
+                            NormalWeighting weighting = NORMAL_AREA_WEIGHTED )
+{
+    vertex_normals( mesh, vc, 0, vc.nvertices(), out, weighting );
+}
+
+template<class Mesh, class T = mesh_value_t<Mesh>>
+inline void vertex_normals( JMath::ThreadPool &pool, const Mesh &mesh, const VertexCorners &vc,
+                            std::array<T,3> *out, NormalWeighting weighting = NORMAL_AREA_WEIGHTED )
+{
+    const size_t n       = vc.nvertices();
+    const size_t block   = 4096;
+    const size_t nblocks = (n + block - 1)/block;
+    pool.parallel_for( nblocks, [&]( size_t b, size_t ) {
+        vertex_normals( mesh, vc, b*block, std::min(n, (b + 1)*block), out, weighting );
+    });
+}
+
+// One-off forms that build the CSR themselves
+template<class Mesh, class T = mesh_value_t<Mesh>>
+inline void vertex_normals( const Mesh &mesh, std::array<T,3> *out,
+                            NormalWeighting weighting = NORMAL_AREA_WEIGHTED )
+{
+    vertex_normals( mesh, VertexCorners(mesh), out, weighting );
+}
+
+template<class Mesh, class T = mesh_value_t<Mesh>>
+inline void vertex_normals( JMath::ThreadPool &pool, const Mesh &mesh, std::array<T,3> *out,
+                            NormalWeighting weighting = NORMAL_AREA_WEIGHTED )
+{
+    vertex_normals( pool, mesh, VertexCorners(pool, mesh), out, weighting );
+}
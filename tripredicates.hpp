@@ -0,0 +1,439 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+#include "trilib.hpp"
+
+///////////////////////////////////////////////////////////////////////////////
+// Exact geometric predicates.
+//
+// orient2d, orient3d and incircle return a value whose sign is the sign of
+// the exact determinant for the (double-rounded) input coordinates. Each
+// first evaluates the determinant in plain floating point together with a
+// static bound on its rounding error (Shewchuk, "Adaptive Precision
+// Floating-Point Arithmetic and Fast Robust Geometric Predicates", 1997);
+// only when the result is within that bound of zero is the determinant
+// recomputed exactly with floating-point expansions. Almost every input is
+// decided by the filter, at the cost of the naive determinant plus a few
+// absolute values. Results are exact unless intermediate products overflow
+// or underflow.
+//
+// The magnitude of the return value is the rounded determinant when the
+// filter decides and the leading term of the exact value otherwise, so only
+// its sign should be relied upon.
+//
+// The expansion arithmetic needs IEEE round-to-nearest doubles evaluated
+// without extra precision (no x87, no -ffast-math).
+///////////////////////////////////////////////////////////////////////////////
+
+namespace TriExact
+{
+// Half an ulp of 1, and Shewchuk's error bounds for each stage: A is the
+// plain determinant, B the exact determinant of the rounded differences, C
+// the latter corrected by the first-order terms of the differences' roundoff
+const double EPS          = 1.1102230246251565e-16;   // 2^-53
+const double RESULT_BOUND = (3.0 + 8.0*EPS)*EPS;
+const double CCW_BOUND_A  = (3.0 + 16.0*EPS)*EPS;
+const double CCW_BOUND_B  = (2.0 + 12.0*EPS)*EPS;
+const double CCW_BOUND_C  = (9.0 + 64.0*EPS)*EPS*EPS;
+const double O3D_BOUND_A  = (7.0 + 56.0*EPS)*EPS;
+const double O3D_BOUND_B  = (3.0 + 28.0*EPS)*EPS;
+const double O3D_BOUND_C  = (26.0 + 288.0*EPS)*EPS*EPS;
+const double ICC_BOUND_A  = (10.0 + 96.0*EPS)*EPS;
+const double ICC_BOUND_B  = (4.0 + 48.0*EPS)*EPS;
+const double ICC_BOUND_C  = (44.0 + 576.0*EPS)*EPS*EPS;
+
+// x + y == a + b exactly, with x = fl(a + b); fast_two_sum needs |a| >= |b|
+inline void fast_two_sum( double a, double b, double &x, double &y )
+{
+    x = a + b;
+    y = b - (x - a);
+}
+
+inline void two_sum( double a, double b, double &x, double &y )
+{
+    x = a + b;
+    double bv = x - a, av = x - bv;
+    y = (a - av) + (b - bv);
+}
+
+// Roundoff of x = fl(a - b)
+inline double diff_tail( double a, double b, double x )
+{
+    double bv = a - x, av = x + bv;
+    return (a - av) + (bv - b);
+}
+
+inline void two_diff( double a, double b, double &x, double &y )
+{
+    x = a - b;
+    y = diff_tail( a, b, x );
+}
+
+// x + y == a*b exactly, with x = fl(a*b)
+inline void two_product( double a, double b, double &x, double &y )
+{
+    x = a*b;
+#ifdef FP_FAST_FMA
+    y = std::fma( a, b, -x );
+#else
+    const double splitter = 134217729.0;   // 2^27 + 1
+    double c   = splitter*a, ahi = c - (c - a), alo = a - ahi;
+    double d   = splitter*b, bhi = d - (d - b), blo = b - bhi;
+    y = alo*blo - (((x - ahi*bhi) - alo*bhi) - ahi*blo);
+#endif
+}
+
+// h = e + f. Components are nonoverlapping, in increasing magnitude, zeros
+// removed; h holds at least one component and room for ne + nf.
+inline int expansion_sum( const double *e, int ne, const double *f, int nf, double *h )
+{
+    double Q, Qnew, hh;
+    int    i = 0, j = 0, k = 0;
+
+    auto smaller_e = [&]() { return j == nf || (i < ne && (f[j] > e[i]) == (f[j] > -e[i])); };
+
+    if( smaller_e() ) Q = e[i++];
+    else              Q = f[j++];
+
+    if( i < ne && j < nf ) {
+        if( smaller_e() ) fast_two_sum( e[i++], Q, Qnew, hh );
+        else              fast_two_sum( f[j++], Q, Qnew, hh );
+        Q = Qnew;
+        if( hh != 0 ) h[k++] = hh;
+    }
+    while( i < ne || j < nf ) {
+        if( smaller_e() ) two_sum( Q, e[i++], Qnew, hh );
+        else              two_sum( Q, f[j++], Qnew, hh );
+        Q = Qnew;
+        if( hh != 0 ) h[k++] = hh;
+    }
+    if( Q != 0 || k == 0 ) h[k++] = Q;
+    return k;
+}
+
+// h = b*e; h has room for 2*ne components
+inline int scale_expansion( const double *e, int ne, double b, double *h )
+{
+    double Q, hh, p1, p0, sum;
+    int    k = 0;
+
+    two_product( e[0], b, Q, hh );
+    if( hh != 0 ) h[k++] = hh;
+    for( int i = 1; i < ne; i++) {
+        two_product( e[i], b, p1, p0 );
+        two_sum( Q, p0, sum, hh );
+        if( hh != 0 ) h[k++] = hh;
+        fast_two_sum( p1, sum, Q, hh );
+        if( hh != 0 ) h[k++] = hh;
+    }
+    if( Q != 0 || k == 0 ) h[k++] = Q;
+    return k;
+}
+
+// Fixed-capacity expansion; N bounds the number of components
+template<int N>
+struct Expansion
+{
+    double e[N];
+    int    n = 0;
+
+    // Approximate value, with the sign of the exact one
+    double estimate() const
+    {
+        double sum = 0;
+        for( int i = 0; i < n; i++) sum += e[i];
+        return sum;
+    }
+};
+
+inline Expansion<2> product( double a, double b )
+{
+    Expansion<2> r;
+    double x, y;
+    two_product( a, b, x, y );
+    if( y != 0 ) r.e[r.n++] = y;
+    r.e[r.n++] = x;
+    return r;
+}
+
+inline Expansion<2> difference( double a, double b )
+{
+    Expansion<2> r;
+    double x, y;
+    two_diff( a, b, x, y );
+    if( y != 0 ) r.e[r.n++] = y;
+    r.e[r.n++] = x;
+    return r;
+}
+
+template<int A, int B>
+inline Expansion<A+B> operator+( const Expansion<A> &a, const Expansion<B> &b )
+{
+    Expansion<A+B> r;
+    r.n = expansion_sum( a.e, a.n, b.e, b.n, r.e );
+    return r;
+}
+
+template<int A, int B>
+inline Expansion<A+B> operator-( const Expansion<A> &a, const Expansion<B> &b )
+{
+    double nb[B] = {};
+    for( int i = 0; i < b.n; i++) nb[i] = -b.e[i];
+    Expansion<A+B> r;
+    r.n = expansion_sum( a.e, a.n, nb, b.n, r.e );
+    return r;
+}
+
+template<int A>
+inline Expansion<2*A> operator*( const Expansion<A> &a, double b )
+{
+    Expansion<2*A> r;
+    r.n = scale_expansion( a.e, a.n, b, r.e );
+    return r;
+}
+
+template<int A, int B>
+inline Expansion<2*A*B> operator*( const Expansion<A> &a, const Expansion<B> &b )
+{
+    Expansion<2*A*B> r;
+    double s[2*A*B], t[2*A];
+    double *cur = r.e, *next = s;
+    int     n   = scale_expansion( a.e, a.n, b.e[0], cur );
+    for( int i = 1; i < b.n; i++) {
+        int m = scale_expansion( a.e, a.n, b.e[i], t );
+        n = expansion_sum( cur, n, t, m, next );
+        std::swap( cur, next );
+    }
+    if( cur != r.e ) std::copy( cur, cur + n, r.e );
+    r.n = n;
+    return r;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Stage D: every difference as an exact two-term expansion
+inline double orient2d_exact( double ax, double ay, double bx, double by, double cx, double cy )
+{
+    auto acx = difference(ax, cx), acy = difference(ay, cy);
+    auto bcx = difference(bx, cx), bcy = difference(by, cy);
+    return (acx*bcy - acy*bcx).estimate();
+}
+
+inline double orient2d( double ax, double ay, double bx, double by, double cx, double cy )
+{
+    double acx = ax - cx, bcx = bx - cx;
+    double acy = ay - cy, bcy = by - cy;
+
+    double detleft  = acx*bcy;
+    double detright = acy*bcx;
+    double det      = detleft - detright;
+
+    // Shewchuk returns early when the two products differ in sign; the bound
+    // below is then met anyway, and testing it alone avoids a hard-to-predict
+    // branch on the sign of detleft
+    double detsum   = std::fabs(detleft) + std::fabs(detright);
+    double errbound = CCW_BOUND_A*detsum;
+    if( det >= errbound || -det >= errbound ) return det;
+
+    det      = (product(acx, bcy) - product(acy, bcx)).estimate();
+    errbound = CCW_BOUND_B*detsum;
+    if( det >= errbound || -det >= errbound ) return det;
+
+    double acxtail = diff_tail(ax, cx, acx), bcxtail = diff_tail(bx, cx, bcx);
+    double acytail = diff_tail(ay, cy, acy), bcytail = diff_tail(by, cy, bcy);
+    if( acxtail == 0 && acytail == 0 && bcxtail == 0 && bcytail == 0 ) return det;
+
+    errbound = CCW_BOUND_C*detsum + RESULT_BOUND*std::fabs(det);
+    det     += (acx*bcytail + bcy*acxtail) - (acy*bcxtail + bcx*acytail);
+    if( det >= errbound || -det >= errbound ) return det;
+
+    return orient2d_exact( ax, ay, bx, by, cx, cy );
+}
+
+inline double orient3d_exact( const double *pa, const double *pb, const double *pc, const double *pd )
+{
+    auto adx = difference(pa[0], pd[0]), ady = difference(pa[1], pd[1]), adz = difference(pa[2], pd[2]);
+    auto bdx = difference(pb[0], pd[0]), bdy = difference(pb[1], pd[1]), bdz = difference(pb[2], pd[2]);
+    auto cdx = difference(pc[0], pd[0]), cdy = difference(pc[1], pd[1]), cdz = difference(pc[2], pd[2]);
+
+    auto bc = bdx*cdy - cdx*bdy;
+    auto ca = cdx*ady - adx*cdy;
+    auto ab = adx*bdy - bdx*ady;
+    return (adz*bc + bdz*ca + cdz*ab).estimate();
+}
+
+inline double orient3d( const double *pa, const double *pb, const double *pc, const double *pd )
+{
+    double adx = pa[0] - pd[0], ady = pa[1] - pd[1], adz = pa[2] - pd[2];
+    double bdx = pb[0] - pd[0], bdy = pb[1] - pd[1], bdz = pb[2] - pd[2];
+    double cdx = pc[0] - pd[0], cdy = pc[1] - pd[1], cdz = pc[2] - pd[2];
+
+    double bdxcdy = bdx*cdy, cdxbdy = cdx*bdy;
+    double cdxady = cdx*ady, adxcdy = adx*cdy;
+    double adxbdy = adx*bdy, bdxady = bdx*ady;
+
+    double det = adz*(bdxcdy - cdxbdy) + bdz*(cdxady - adxcdy) + cdz*(adxbdy - bdxady);
+
+    double permanent = (std::fabs(bdxcdy) + std::fabs(cdxbdy))*std::fabs(adz)
+                     + (std::fabs(cdxady) + std::fabs(adxcdy))*std::fabs(bdz)
+                     + (std::fabs(adxbdy) + std::fabs(bdxady))*std::fabs(cdz);
+    double errbound = O3D_BOUND_A*permanent;
+    if( det > errbound || -det > errbound ) return det;
+
+    auto bc = product(bdx, cdy) - product(cdx, bdy);
+    auto ca = product(cdx, ady) - product(adx, cdy);
+    auto ab = product(adx, bdy) - product(bdx, ady);
+    det      = (bc*adz + ca*bdz + ab*cdz).estimate();
+    errbound = O3D_BOUND_B*permanent;
+    if( det >= errbound || -det >= errbound ) return det;
+
+    double adxtail = diff_tail(pa[0], pd[0], adx), adytail = diff_tail(pa[1], pd[1], ady),
+           adztail = diff_tail(pa[2], pd[2], adz);
+    double bdxtail = diff_tail(pb[0], pd[0], bdx), bdytail = diff_tail(pb[1], pd[1], bdy),
+           bdztail = diff_tail(pb[2], pd[2], bdz);
+    double cdxtail = diff_tail(pc[0], pd[0], cdx), cdytail = diff_tail(pc[1], pd[1], cdy),
+           cdztail = diff_tail(pc[2], pd[2], cdz);
+    if( adxtail == 0 && adytail == 0 && adztail == 0 && bdxtail == 0 && bdytail == 0 &&
+        bdztail == 0 && cdxtail == 0 && cdytail == 0 && cdztail == 0 ) return det;
+
+    errbound = O3D_BOUND_C*permanent + RESULT_BOUND*std::fabs(det);
+    det += (adz*((bdx*cdytail + cdy*bdxtail) - (bdy*cdxtail + cdx*bdytail))
+            + adztail*(bdx*cdy - bdy*cdx))
+         + (bdz*((cdx*adytail + ady*cdxtail) - (cdy*adxtail + adx*cdytail))
+            + bdztail*(cdx*ady - cdy*adx))
+         + (cdz*((adx*bdytail + bdy*adxtail) - (ady*bdxtail + bdx*adytail))
+            + cdztail*(adx*bdy - ady*bdx));
+    if( det >= errbound || -det >= errbound ) return det;
+
+    return orient3d_exact( pa, pb, pc, pd );
+}
+
+inline double incircle_exact( const double *pa, const double *pb, const double *pc, const double *pd )
+{
+    auto adx = difference(pa[0], pd[0]), ady = difference(pa[1], pd[1]);
+    auto bdx = difference(pb[0], pd[0]), bdy = difference(pb[1], pd[1]);
+    auto cdx = difference(pc[0], pd[0]), cdy = difference(pc[1], pd[1]);
+
+    auto alift = adx*adx + ady*ady;
+    auto blift = bdx*bdx + bdy*bdy;
+    auto clift = cdx*cdx + cdy*cdy;
+
+    auto bc = bdx*cdy - cdx*bdy;
+    auto ca = cdx*ady - adx*cdy;
+    auto ab = adx*bdy - bdx*ady;
+    return (alift*bc + blift*ca + clift*ab).estimate();
+}
+
+inline double incircle( const double *pa, const double *pb, const double *pc, const double *pd )
+{
+    double adx = pa[0] - pd[0], ady = pa[1] - pd[1];
+    double bdx = pb[0] - pd[0], bdy = pb[1] - pd[1];
+    double cdx = pc[0] - pd[0], cdy = pc[1] - pd[1];
+
+    double bdxcdy = bdx*cdy, cdxbdy = cdx*bdy;
+    double cdxady = cdx*ady, adxcdy = adx*cdy;
+    double adxbdy = adx*bdy, bdxady = bdx*ady;
+
+    double alift = adx*adx + ady*ady;
+    double blift = bdx*bdx + bdy*bdy;
+    double clift = cdx*cdx + cdy*cdy;
+
+    double det = alift*(bdxcdy - cdxbdy) + blift*(cdxady - adxcdy) + clift*(adxbdy - bdxady);
+
+    double permanent = (std::fabs(bdxcdy) + std::fabs(cdxbdy))*alift
+                     + (std::fabs(cdxady) + std::fabs(adxcdy))*blift
+                     + (std::fabs(adxbdy) + std::fabs(bdxady))*clift;
+    double errbound = ICC_BOUND_A*permanent;
+    if( det > errbound || -det > errbound ) return det;
+
+    auto bc = product(bdx, cdy) - product(cdx, bdy);
+    auto ca = product(cdx, ady) - product(adx, cdy);
+    auto ab = product(adx, bdy) - product(bdx, ady);
+    det = ((bc*adx)*adx + (bc*ady)*ady
+         + (ca*bdx)*bdx + (ca*bdy)*bdy
+         + (ab*cdx)*cdx + (ab*cdy)*cdy).estimate();
+    errbound = ICC_BOUND_B*permanent;
+    if( det >= errbound || -det >= errbound ) return det;
+
+    double adxtail = diff_tail(pa[0], pd[0], adx), adytail = diff_tail(pa[1], pd[1], ady);
+    double bdxtail = diff_tail(pb[0], pd[0], bdx), bdytail = diff_tail(pb[1], pd[1], bdy);
+    double cdxtail = diff_tail(pc[0], pd[0], cdx), cdytail = diff_tail(pc[1], pd[1], cdy);
+    if( adxtail == 0 && adytail == 0 && bdxtail == 0 && bdytail == 0 &&
+        cdxtail == 0 && cdytail == 0 ) return det;
+
+    errbound = ICC_BOUND_C*permanent + RESULT_BOUND*std::fabs(det);
+    det += ((adx*adx + ady*ady)*((bdx*cdytail + cdy*bdxtail) - (bdy*cdxtail + cdx*bdytail))
+            + 2*(adx*adxtail + ady*adytail)*(bdx*cdy - bdy*cdx))
+         + ((bdx*bdx + bdy*bdy)*((cdx*adytail + ady*cdxtail) - (cdy*adxtail + adx*cdytail))
+            + 2*(bdx*bdxtail + bdy*bdytail)*(cdx*ady - cdy*adx))
+         + ((cdx*cdx + cdy*cdy)*((adx*bdytail + bdy*adxtail) - (ady*bdxtail + bdx*adytail))
+            + 2*(cdx*cdxtail + cdy*cdytail)*(adx*bdy - ady*bdx));
+    if( det >= errbound || -det >= errbound ) return det;
+
+    return incircle_exact( pa, pb, pc, pd );
+}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+// > 0 if pa, pb, pc turn counterclockwise in the (x, y) plane, < 0 if
+// clockwise, 0 if collinear. Only the first two coordinates are read.
+template<class P>
+inline double orient2d( const P &pa,
+                        const P &pb,
+                        const P &pc)
+{
+    return TriExact::orient2d( (double)pa[0], (double)pa[1], (double)pb[0], (double)pb[1],
+                               (double)pc[0], (double)pc[1] );
+}
+
+// > 0 if pd lies below the plane through pa, pb, pc, taking "above" as the
+// side from which they appear counterclockwise; 0 if the four are coplanar
+template<class P>
+inline double orient3d( const P &pa,
+                        const P &pb,
+                        const P &pc,
+                        const P &pd)
+{
+    const double a[3] = { (double)pa[0], (double)pa[1], (double)pa[2] };
+    const double b[3] = { (double)pb[0], (double)pb[1], (double)pb[2] };
+    const double c[3] = { (double)pc[0], (double)pc[1], (double)pc[2] };
+    const double d[3] = { (double)pd[0], (double)pd[1], (double)pd[2] };
+    return TriExact::orient3d( a, b, c, d );
+}
+
+// > 0 if pd lies inside the circle through pa, pb, pc, < 0 outside, 0 on it,
+// for pa, pb, pc in counterclockwise order (the sign flips otherwise). Only
+// the first two coordinates are read.
+template<class P>
+inline double incircle( const P &pa,
+                        const P &pb,
+                        const P &pc,
+                        const P &pd)
+{
+    const double a[2] = { (double)pa[0], (double)pa[1] };
+    const double b[2] = { (double)pb[0], (double)pb[1] };
+    const double c[2] = { (double)pc[0], (double)pc[1] };
+    const double d[2] = { (double)pd[0], (double)pd[1] };
+    return TriExact::incircle( a, b, c, d );
+}
+
+// Exact degeneracy test: true if the three corners are collinear (or
+// coincide), i.e. the cross product of the edges is exactly zero. Each of
+// its components is an orient2d of a coordinate-plane projection.
+template<class P, class T = point3_t<P>>
+inline bool isCollinear( const P &pa,
+                         const P &pb,
+                         const P &pc)
+{
+    const double a[3] = { (double)pa[0], (double)pa[1], (double)pa[2] };
+    const double b[3] = { (double)pb[0], (double)pb[1], (double)pb[2] };
+    const double c[3] = { (double)pc[0], (double)pc[1], (double)pc[2] };
+    return TriExact::orient2d( a[0], a[1], b[0], b[1], c[0], c[1] ) == 0 &&
+           TriExact::orient2d( a[1], a[2], b[1], b[2], c[1], c[2] ) == 0 &&
+           TriExact::orient2d( a[2], a[0], b[2], b[0], c[2], c[0] ) == 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,200 @@
+#pragma once
+
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include "threadpool.hpp"
+#include "tribatch.hpp"
+#include "triclassify.hpp"
+#include "trimesh.hpp"
+#include "trimetrics.hpp"
+
+///////////////////////////////////////////////////////////////////////////////
+// Whole-mesh quality statistics computed in parallel.
+//
+// Faces are cut into fixed-size blocks that the thread pool works through in
+// any order. Every statistic except the total area is order-independent
+// (counts, histogram bins, and extrema whose ties go to the lower face id).
+// The area is summed serially inside each block and the block sums are then
+// added in block order, so a report is bit-identical for any thread count.
+//
+// Angles are in degrees. Degenerate faces are counted as isDegenerate does
+// (largest angle above 179.999, or coincident vertices); angles left
+// undefined by coincident vertices are kept out of the extrema and the
+// histogram, and degenerate faces out of the radius ratio.
+//
+// fold() adds a piece of a mesh to a running report, which lets meshes be
+// analyzed chunk by chunk (see tristream.hpp) with the same result as a
+// single analyze() call.
+///////////////////////////////////////////////////////////////////////////////
+
+struct MeshQualityReport
+{
+    static constexpr size_t npos = size_t(-1);
+
+    explicit MeshQualityReport( int nbins = 18 ) : histogram(nbins, 0) {}
+
+    size_t nfaces        = 0;
+    size_t ndegenerate   = 0;
+    double total_area    = 0;
+
+    double minangle      = std::numeric_limits<double>::infinity();
+    size_t minangle_face = npos;
+    double maxangle      = -std::numeric_limits<double>::infinity();
+    size_t maxangle_face = npos;
+
+    // Largest circumradius/inradius ratio (2 for an equilateral triangle)
+    double max_radius_ratio      = 0;
+    size_t max_radius_ratio_face = npos;
+
+    // Count of face angles per bin; bin i covers [i, i+1)*bin_width() degrees
+    std::vector<size_t> histogram;
+
+    double bin_width() const { return 180.0/histogram.size(); }
+
+    void add_angle( double a, size_t face )
+    {
+        if( a < minangle || (a == minangle && face < minangle_face) ) {
+            minangle      = a;
+            minangle_face = face;
+        }
+        if( a > maxangle || (a == maxangle && face < maxangle_face) ) {
+            maxangle      = a;
+            maxangle_face = face;
+        }
+        size_t bin = a/bin_width();
+        histogram[ std::min(bin, histogram.size() - 1) ]++;
+    }
+
+    void add_radius_ratio( double r, size_t face )
+    {
+        if( r > max_radius_ratio || (r == max_radius_ratio && face < max_radius_ratio_face) ) {
+            max_radius_ratio      = r;
+            max_radius_ratio_face = face;
+        }
+    }
+
+    // Folds in another report over the same number of bins. total_area is
+    // simply added, so callers wanting reproducible sums merge in a fixed order.
+    void merge( const MeshQualityReport &other )
+    {
+        nfaces      += other.nfaces;
+        ndegenerate += other.ndegenerate;
+        total_area  += other.total_area;
+
+        if( other.minangle < minangle ||
+            (other.minangle == minangle && other.minangle_face < minangle_face) ) {
+            minangle      = other.minangle;
+            minangle_face = other.minangle_face;
+        }
+        if( other.maxangle > maxangle ||
+            (other.maxangle == maxangle && other.maxangle_face < maxangle_face) ) {
+            maxangle      = other.maxangle;
+            maxangle_face = other.maxangle_face;
+        }
+        if( other.max_radius_ratio_face != npos )
+            add_radius_ratio( other.max_radius_ratio, other.max_radius_ratio_face );
+        for( size_t i = 0; i < histogram.size(); i++)
+            histogram[i] += other.histogram[i];
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+class MeshQualityAnalyzer
+{
+public:
+    // nthreads == 0 uses every hardware thread. accuracy selects the acos
+    // behind the angles (fastmath.hpp); TRIG_COARSE keeps them within 4e-5
+    // rad, which is well inside a histogram bin.
+    explicit MeshQualityAnalyzer( size_t nthreads = 0, size_t block_size = 4096, int nbins = 18,
+                                  TrigAccuracy accuracy = TRIG_EXACT )
+        : pool(nthreads), block(block_size ? block_size : 1), nbins(nbins), trig(accuracy) {}
+
+    size_t       nthreads()   const { return pool.size(); }
+    size_t       block_size() const { return block; }
+    int          bins()       const { return nbins; }
+    TrigAccuracy accuracy()   const { return trig; }
+
+    // Mesh is IndexedMeshView<T>, TriangleSoupView<T>, TriangleBatch<T>, or
+    // anything else with nfaces() and corner(face, k)
+    template<class Mesh>
+    MeshQualityReport analyze( const Mesh &mesh )
+    {
+        MeshQualityReport report(nbins);
+        fold( mesh, 0, report );
+        return report;
+    }
+
+    // Adds the faces of mesh, numbered from first_face on, to report. Folding
+    // consecutive pieces of a mesh gives the same report as analyzing it at
+    // once, provided every piece but the last holds a multiple of
+    // block_size() faces.
+    template<class Mesh>
+    void fold( const Mesh &mesh, size_t first_face, MeshQualityReport &report )
+    {
+        if( first_face % block )
+            throw std::invalid_argument( "MeshQualityAnalyzer::fold: first_face is not a multiple of block_size()" );
+
+        const size_t n       = mesh.nfaces();
+        const size_t nblocks = (n + block - 1)/block;
+
+        std::vector<MeshQualityReport> partial( pool.size(), MeshQualityReport(nbins) );
+        std::vector<double>            block_area( nblocks );
+
+        with_trig( trig, [&]( auto t ) {
+            typedef decltype(t) Trig;
+            pool.parallel_for( nblocks, [&]( size_t b, size_t thread ) {
+                size_t begin = b*block;
+                block_area[b] = accumulate<Trig>( mesh, begin, std::min(n, begin + block),
+                                                  partial[thread], first_face );
+            });
+        });
+
+        for( auto &p : partial ) report.merge(p);
+        for( double a : block_area ) report.total_area += a;
+    }
+
+    // Adds faces [begin, end) to report, under ids first_face + f, except for
+    // their area, whose sum (accumulated in face order) is returned instead.
+    template<class Trig = TrigExact, class Mesh>
+    static double accumulate( const Mesh &mesh, size_t begin, size_t end,
+                              MeshQualityReport &report, size_t first_face = 0 )
+    {
+        typedef JMath::point3_t< decltype(mesh.corner(0,0)) > T;
+
+        TriangleMetrics<T,Trig> m( METRIC_ANGLES | METRIC_AREA | METRIC_CIRCUMRADIUS | METRIC_INRADIUS,
+                                   ANGLE_IN_DEGREES );
+        TriangleClassifier classifier;
+        double area = 0.0;
+        for( size_t f = begin; f < end; f++) {
+            m.compute( mesh.corner(f,0), mesh.corner(f,1), mesh.corner(f,2) );
+            // Rounding can drive Heron's radicand of a (near-)collinear face
+            // below zero; its area is zero, not NaN
+            if( m.area > 0 ) area += m.area;
+
+            const size_t id = first_face + f;
+            uint8_t cls = classifier.classify_lengths2( m.lengths2[0], m.lengths2[1], m.lengths2[2] );
+            if( cls & TRI_DEGENERATE )
+                report.ndegenerate++;
+            else
+                report.add_radius_ratio( (double)m.circumradius/m.inradius, id );
+
+            bool undefined = std::isnan(m.angles[0]) || std::isnan(m.angles[1]) ||
+                             std::isnan(m.angles[2]);
+            if( !undefined )
+                for( int k = 0; k < 3; k++) report.add_angle( m.angles[k], id );
+        }
+        report.nfaces += end - begin;
+        return area;
+    }
+
+private:
+    JMath::ThreadPool pool;
+    size_t            block;
+    int               nbins;
+    TrigAccuracy      trig;
+};
+
+///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,183 @@
+#pragma once
+
+#include <limits>
+
+#include "tribatch.hpp"
+
+///////////////////////////////////////////////////////////////////////////////
+// Ray-triangle intersection (Moller-Trumbore).
+//
+// A hit is reported for tmin <= t <= tmax with barycentrics (1-u-v, u, v)
+// relative to (pa, pb, pc), edges included. Rays parallel to the plane of the
+// triangle, and degenerate triangles, never hit.
+//
+// The batched forms test one ray against every triangle of a TriangleBatch,
+// or every ray of a RayBatch against one triangle, and write t = +inf and
+// u = v = 0 for misses. TriSIMD::intersect (trisimd.hpp) takes the same
+// arguments and returns identical results.
+///////////////////////////////////////////////////////////////////////////////
+
+template<class T>
+struct Ray
+{
+    std::array<T,3> origin = {0, 0, 0};
+    std::array<T,3> dir    = {0, 0, 1};
+    T               tmin   = 0;
+    T               tmax   = std::numeric_limits<T>::infinity();
+};
+
+template<class T>
+struct RayHit
+{
+    int face = -1;
+    T   t    = std::numeric_limits<T>::infinity();
+    T   u    = 0;
+    T   v    = 0;
+
+    std::array<T,3> bary() const { return { 1 - u - v, u, v }; }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+template<class P, class T = point3_t<P>>
+inline bool intersect( const Ray<T> &ray,
+                       const P &pa,
+                       const P &pb,
+                       const P &pc,
+                       T &t, T &u, T &v)
+{
+    T e1[3], e2[3], s[3];
+    for( int j = 0; j < 3; j++) {
+        e1[j] = pb[j] - pa[j];
+        e2[j] = pc[j] - pa[j];
+        s[j]  = ray.origin[j] - pa[j];
+    }
+    const T *d = ray.dir.data();
+
+    T p[3] = { d[1]*e2[2] - d[2]*e2[1], d[2]*e2[0] - d[0]*e2[2], d[0]*e2[1] - d[1]*e2[0] };
+    T det  = e1[0]*p[0] + e1[1]*p[1] + e1[2]*p[2];
+    if( det == 0 ) return false;
+    T inv  = 1/det;
+
+    u = (s[0]*p[0] + s[1]*p[1] + s[2]*p[2])*inv;
+    if( !(u >= 0 && u <= 1) ) return false;
+
+    T q[3] = { s[1]*e1[2] - s[2]*e1[1], s[2]*e1[0] - s[0]*e1[2], s[0]*e1[1] - s[1]*e1[0] };
+    v = (d[0]*q[0] + d[1]*q[1] + d[2]*q[2])*inv;
+    if( !(v >= 0 && u + v <= 1) ) return false;
+
+    t = (e2[0]*q[0] + e2[1]*q[1] + e2[2]*q[2])*inv;
+    return t >= ray.tmin && t <= ray.tmax;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Rays stored as eight streams (origin, direction, tmin, tmax), like
+// TriangleBatch stores corners.
+
+template<class T>
+class RayBatch
+{
+public:
+    RayBatch() = default;
+    explicit RayBatch( size_t n ) { resize(n); }
+
+    size_t size()  const { return lo.size(); }
+    bool   empty() const { return lo.empty(); }
+
+    void resize( size_t n )
+    {
+        for( int j = 0; j < 3; j++) {
+            o[j].resize(n);
+            d[j].resize(n);
+        }
+        lo.resize(n);
+        hi.resize(n);
+    }
+
+    void reserve( size_t n )
+    {
+        for( int j = 0; j < 3; j++) {
+            o[j].reserve(n);
+            d[j].reserve(n);
+        }
+        lo.reserve(n);
+        hi.reserve(n);
+    }
+
+    void clear() { resize(0); }
+
+    void push_back( const Ray<T> &ray )
+    {
+        resize( size() + 1 );
+        set( size() - 1, ray );
+    }
+
+    void set( size_t i, const Ray<T> &ray )
+    {
+        for( int j = 0; j < 3; j++) {
+            o[j][i] = ray.origin[j];
+            d[j][i] = ray.dir[j];
+        }
+        lo[i] = ray.tmin;
+        hi[i] = ray.tmax;
+    }
+
+    Ray<T> ray( size_t i ) const
+    {
+        Ray<T> r;
+        for( int j = 0; j < 3; j++) {
+            r.origin[j] = o[j][i];
+            r.dir[j]    = d[j][i];
+        }
+        r.tmin = lo[i];
+        r.tmax = hi[i];
+        return r;
+    }
+
+    const T *origin( int j ) const { return o[j].data(); }
+    const T *dir( int j )    const { return d[j].data(); }
+    const T *tmin()          const { return lo.data(); }
+    const T *tmax()          const { return hi.data(); }
+    T       *origin( int j )       { return o[j].data(); }
+    T       *dir( int j )          { return d[j].data(); }
+    T       *tmin()                { return lo.data(); }
+    T       *tmax()                { return hi.data(); }
+
+private:
+    std::array<std::vector<T>,3> o, d;
+    std::vector<T>               lo, hi;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+// One ray against every triangle of a batch
+template<class T>
+inline void intersect( const Ray<T> &ray, const TriangleBatch<T> &batch, T *t, T *u, T *v)
+{
+    const size_t n = batch.size();
+    for( size_t i = 0; i < n; i++) {
+        if( !intersect( ray, batch.vertex(i,0), batch.vertex(i,1), batch.vertex(i,2), t[i], u[i], v[i]) ) {
+            t[i] = std::numeric_limits<T>::infinity();
+            u[i] = v[i] = 0;
+        }
+    }
+}
+
+// Every ray of a batch against one triangle
+template<class P, class T = point3_t<P>>
+inline void intersect( const RayBatch<T> &rays,
+                       const P &pa,
+                       const P &pb,
+                       const P &pc,
+                       T *t, T *u, T *v)
+{
+    const size_t n = rays.size();
+    for( size_t i = 0; i < n; i++) {
+        if( !intersect( rays.ray(i), pa, pb, pc, t[i], u[i], v[i]) ) {
+            t[i] = std::numeric_limits<T>::infinity();
+            u[i] = v[i] = 0;
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
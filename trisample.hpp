@@ -0,0 +1,353 @@
+#pragma once
+
+#include <assert.h>
+#include <stdint.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "tribatch.hpp"
+#include "trisimd.hpp"
+#include "random.hpp"
+#include "threadpool.hpp"
+
+///////////////////////////////////////////////////////////////////////////////
+// Bulk random geometry straight into structure-of-arrays buffers.
+//
+// Each function draws from a JMath::RandomStream, filling one coordinate
+// stream at a time with TriSIMD::fill_uniform() (the values of
+// RandomStream::fill_uniform(), 4-16 Philox blocks per instruction). Points
+// inside a triangle take two uniforms u, v and fold them into the lower half
+// of the unit square (u + v > 1 maps to 1 - u, 1 - v), which is uniform over
+// the triangle and needs no sqrt:
+//
+//   q = pa + u (pb - pa) + v (pc - pa)
+//
+// The ThreadPool overloads take a seed instead of a stream and give chunk c
+// of SAMPLE_CHUNK items the stream RandomStream(seed, c), so their output
+// depends on the seed only, never on the number of threads.
+//
+// SurfaceSampler draws points uniformly over the whole surface of a mesh:
+// faces are picked in proportion to their area from a Walker alias table
+// (Vose's construction), one table column and one coin per sample, then a
+// point is placed inside the face as above.
+///////////////////////////////////////////////////////////////////////////////
+
+const size_t SAMPLE_CHUNK = 1 << 14;
+
+// Maps (u, v) in the unit square to the triangle u, v >= 0, u + v <= 1
+template<class T>
+inline void fold_to_triangle( T &u, T &v )
+{
+    if( u + v > 1 ) {
+        u = 1 - u;
+        v = 1 - v;
+    }
+}
+
+// Calls f(rng, first, last) for every chunk with that chunk's stream
+template<class F>
+inline void sample_chunks( JMath::ThreadPool &pool, uint64_t seed, size_t n, F f )
+{
+    size_t nchunks = (n + SAMPLE_CHUNK - 1)/SAMPLE_CHUNK;
+    pool.parallel_for( nchunks, [&]( size_t c, size_t ) {
+        JMath::RandomStream rng( seed, c );
+        f( rng, c*SAMPLE_CHUNK, std::min((c + 1)*SAMPLE_CHUNK, n) );
+    });
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+// n points uniform in the cube [lo, hi)^3
+template<class T>
+inline void random_points( JMath::RandomStream &rng, size_t n, T *x, T *y, T *z, T lo, T hi )
+{
+    TriSIMD::fill_uniform( rng, x, n, lo, hi );
+    TriSIMD::fill_uniform( rng, y, n, lo, hi );
+    TriSIMD::fill_uniform( rng, z, n, lo, hi );
+}
+
+template<class T>
+inline void random_points( JMath::ThreadPool &pool, uint64_t seed, size_t n, T *x, T *y, T *z, T lo, T hi )
+{
+    sample_chunks( pool, seed, n, [&]( JMath::RandomStream &rng, size_t first, size_t last ) {
+        random_points( rng, last - first, x + first, y + first, z + first, lo, hi );
+    });
+}
+
+// Resizes batch to n triangles with corners uniform in [lo, hi)^3
+template<class T>
+inline void random_triangles( JMath::RandomStream &rng, size_t n, TriangleBatch<T> &batch, T lo, T hi )
+{
+    batch.resize( n );
+    for( int k = 0; k < 3; k++)
+        random_points( rng, n, batch.x(k), batch.y(k), batch.z(k), lo, hi );
+}
+
+template<class T>
+inline void random_triangles( JMath::ThreadPool &pool, uint64_t seed, size_t n, TriangleBatch<T> &batch, T lo, T hi )
+{
+    batch.resize( n );
+    sample_chunks( pool, seed, n, [&]( JMath::RandomStream &rng, size_t first, size_t last ) {
+        for( int k = 0; k < 3; k++)
+            random_points( rng, last - first, batch.x(k) + first, batch.y(k) + first, batch.z(k) + first, lo, hi );
+    });
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+// One uniform point inside each of the triangles [first, last) of batch,
+// written to x, y, z at the same indices
+template<class T>
+inline void sample_range( JMath::RandomStream &rng, const TriangleBatch<T> &batch,
+                          size_t first, size_t last, T *x, T *y, T *z )
+{
+    const T *x0 = batch.x(0), *y0 = batch.y(0), *z0 = batch.z(0);
+    const T *x1 = batch.x(1), *y1 = batch.y(1), *z1 = batch.z(1);
+    const T *x2 = batch.x(2), *y2 = batch.y(2), *z2 = batch.z(2);
+
+    const size_t B = 256;
+    T u[B], v[B];
+    for( size_t i0 = first; i0 < last; i0 += B) {
+        size_t m = std::min(B, last - i0);
+        TriSIMD::fill_uniform( rng, u, m, (T)0, (T)1 );
+        TriSIMD::fill_uniform( rng, v, m, (T)0, (T)1 );
+        for( size_t j = 0; j < m; j++) {
+            size_t i = i0 + j;
+            T      a = u[j], b = v[j];
+            fold_to_triangle( a, b );
+            x[i] = x0[i] + a*(x1[i] - x0[i]) + b*(x2[i] - x0[i]);
+            y[i] = y0[i] + a*(y1[i] - y0[i]) + b*(y2[i] - y0[i]);
+            z[i] = z0[i] + a*(z1[i] - z0[i]) + b*(z2[i] - z0[i]);
+        }
+    }
+}
+
+template<class T>
+inline void sample_triangles( JMath::RandomStream &rng, const TriangleBatch<T> &batch, T *x, T *y, T *z )
+{
+    sample_range( rng, batch, 0, batch.size(), x, y, z );
+}
+
+template<class T>
+inline void sample_triangles( JMath::ThreadPool &pool, uint64_t seed, const TriangleBatch<T> &batch, T *x, T *y, T *z )
+{
+    sample_chunks( pool, seed, batch.size(), [&]( JMath::RandomStream &rng, size_t first, size_t last ) {
+        sample_range( rng, batch, first, last, x, y, z );
+    });
+}
+
+// n uniform points inside one triangle
+template<class P, class T>
+inline void sample_triangle( JMath::RandomStream &rng, const P &pa, const P &pb, const P &pc,
+                             size_t n, T *x, T *y, T *z )
+{
+    const size_t B = 256;
+    T u[B], v[B];
+    const T e1[3] = { (T)(pb[0] - pa[0]), (T)(pb[1] - pa[1]), (T)(pb[2] - pa[2]) };
+    const T e2[3] = { (T)(pc[0] - pa[0]), (T)(pc[1] - pa[1]), (T)(pc[2] - pa[2]) };
+    for( size_t i0 = 0; i0 < n; i0 += B) {
+        size_t m = std::min(B, n - i0);
+        TriSIMD::fill_uniform( rng, u, m, (T)0, (T)1 );
+        TriSIMD::fill_uniform( rng, v, m, (T)0, (T)1 );
+        for( size_t j = 0; j < m; j++) {
+            T a = u[j], b = v[j];
+            fold_to_triangle( a, b );
+            x[i0 + j] = pa[0] + a*e1[0] + b*e2[0];
+            y[i0 + j] = pa[1] + a*e1[1] + b*e2[1];
+            z[i0 + j] = pa[2] + a*e1[2] + b*e2[2];
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Area-weighted sampling of a whole mesh.
+//
+// build() computes the face areas (in parallel with a ThreadPool) and the
+// alias table: column i keeps face i with probability threshold[i]/2^32 and
+// gives face alias[i] otherwise, so picking a face costs one multiply, one
+// compare and at most two loads whatever the face count. Zero-area faces are
+// never picked.
+//
+// A sample takes two words (column, coin) and two uniforms (u, v); they are
+// drawn a block of 256 samples at a time, so the output for a given stream
+// does not change when a run is split into calls of multiples of 256.
+// Sample i is returned as its face and its barycentric weights l0, l1, l2
+// (l0 = 1 - l1 - l2), and optionally as the point l0 pa + l1 pb + l2 pc.
+
+template<class T>
+class SurfaceSampler
+{
+public:
+    SurfaceSampler() = default;
+
+    // Mesh is TriangleBatch<T>, IndexedMeshView<T>, TriangleSoupView<T>, or
+    // anything else with nfaces() and corner(face, k)
+    template<class Mesh>
+    explicit SurfaceSampler( const Mesh &mesh ) { build(mesh); }
+
+    template<class Mesh>
+    SurfaceSampler( JMath::ThreadPool &pool, const Mesh &mesh ) { build(pool, mesh); }
+
+    template<class Mesh>
+    void build( const Mesh &mesh )
+    {
+        areas.resize( mesh.nfaces() );
+        face_areas( mesh, 0, areas.size() );
+        build_table();
+    }
+
+    template<class Mesh>
+    void build( JMath::ThreadPool &pool, const Mesh &mesh )
+    {
+        const size_t n       = mesh.nfaces();
+        const size_t block   = 4096;
+        const size_t nblocks = (n + block - 1)/block;
+        areas.resize( n );
+        pool.parallel_for( nblocks, [&]( size_t b, size_t ) {
+            face_areas( mesh, b*block, std::min(n, (b + 1)*block) );
+        });
+        build_table();
+    }
+
+    size_t nfaces()     const { return areas.size(); }
+    double area( size_t f ) const { return areas[f]; }
+    double total_area() const { return total; }
+
+    // False when the mesh has no face of positive area to sample
+    bool   valid()      const { return total > 0; }
+
+    // Probability that a sample lands on face f, as encoded in the table;
+    // scans the whole table, for testing
+    double probability( size_t f ) const
+    {
+        const double n = (double)nfaces();
+        double p = threshold[f]/4294967296.0;
+        for( size_t i = 0; i < nfaces(); i++)
+            if( alias[i] == (int)f && (size_t)alias[i] != i ) p += 1 - threshold[i]/4294967296.0;
+        return p/n;
+    }
+
+    // Face for one pair of random words
+    int pick( uint32_t column, uint32_t coin ) const
+    {
+        size_t i = (size_t)(((uint64_t)column*nfaces()) >> 32);
+        return coin < threshold[i] ? (int)i : alias[i];
+    }
+
+    // n faces and barycentric weights
+    void sample( JMath::RandomStream &rng, size_t n, int *face, T *l0, T *l1, T *l2 ) const
+    {
+        assert( valid() );
+        const size_t B = 256;
+        uint32_t w[2*B];
+        T u[B], v[B];
+        for( size_t i0 = 0; i0 < n; i0 += B) {
+            size_t m = std::min(B, n - i0);
+            TriSIMD::fill( rng, w, 2*m );
+            TriSIMD::fill_uniform( rng, u, m, (T)0, (T)1 );
+            TriSIMD::fill_uniform( rng, v, m, (T)0, (T)1 );
+            for( size_t j = 0; j < m; j++) {
+                T a = u[j], b = v[j];
+                fold_to_triangle( a, b );
+                face[i0 + j] = pick( w[2*j], w[2*j + 1] );
+                l0[i0 + j]   = 1 - a - b;
+                l1[i0 + j]   = a;
+                l2[i0 + j]   = b;
+            }
+        }
+    }
+
+    // The same samples as points of mesh (the mesh the table was built from)
+    template<class Mesh>
+    void sample( JMath::RandomStream &rng, const Mesh &mesh, size_t n, T *x, T *y, T *z,
+                 int *face, T *l0, T *l1, T *l2 ) const
+    {
+        sample( rng, n, face, l0, l1, l2 );
+        points( mesh, n, face, l1, l2, x, y, z );
+    }
+
+    void sample( JMath::ThreadPool &pool, uint64_t seed, size_t n, int *face, T *l0, T *l1, T *l2 ) const
+    {
+        sample_chunks( pool, seed, n, [&]( JMath::RandomStream &rng, size_t first, size_t last ) {
+            sample( rng, last - first, face + first, l0 + first, l1 + first, l2 + first );
+        });
+    }
+
+    template<class Mesh>
+    void sample( JMath::ThreadPool &pool, uint64_t seed, const Mesh &mesh, size_t n, T *x, T *y, T *z,
+                 int *face, T *l0, T *l1, T *l2 ) const
+    {
+        sample_chunks( pool, seed, n, [&]( JMath::RandomStream &rng, size_t first, size_t last ) {
+            sample( rng, mesh, last - first, x + first, y + first, z + first,
+                    face + first, l0 + first, l1 + first, l2 + first );
+        });
+    }
+
+    // Point i = corner 0 + l1[i] (corner 1 - corner 0) + l2[i] (corner 2 - corner 0)
+    // of face[i]
+    template<class Mesh>
+    static void points( const Mesh &mesh, size_t n, const int *face, const T *l1, const T *l2,
+                        T *x, T *y, T *z )
+    {
+        for( size_t i = 0; i < n; i++) {
+            auto pa = mesh.corner(face[i], 0), pb = mesh.corner(face[i], 1), pc = mesh.corner(face[i], 2);
+            x[i] = pa[0] + l1[i]*(pb[0] - pa[0]) + l2[i]*(pc[0] - pa[0]);
+            y[i] = pa[1] + l1[i]*(pb[1] - pa[1]) + l2[i]*(pc[1] - pa[1]);
+            z[i] = pa[2] + l1[i]*(pb[2] - pa[2]) + l2[i]*(pc[2] - pa[2]);
+        }
+    }
+
+private:
+    std::vector<double>   areas;
+    std::vector<uint32_t> threshold;
+    std::vector<int>      alias;
+    double                total = 0;
+
+    // Half the cross product of the edges: no cancellation inside a sqrt as
+    // with Heron's formula, so degenerate faces come out as 0, never NaN
+    template<class Mesh>
+    void face_areas( const Mesh &mesh, size_t first, size_t last )
+    {
+        for( size_t f = first; f < last; f++) {
+            auto pa = mesh.corner(f, 0), pb = mesh.corner(f, 1), pc = mesh.corner(f, 2);
+            double ux = (double)pb[0] - pa[0], uy = (double)pb[1] - pa[1], uz = (double)pb[2] - pa[2];
+            double vx = (double)pc[0] - pa[0], vy = (double)pc[1] - pa[1], vz = (double)pc[2] - pa[2];
+            double cx = uy*vz - uz*vy, cy = uz*vx - ux*vz, cz = ux*vy - uy*vx;
+            double a  = 0.5*std::sqrt(cx*cx + cy*cy + cz*cz);
+            areas[f]  = std::isfinite(a) ? a : 0.0;
+        }
+    }
+
+    // Vose: columns under the mean weight are topped up from one over it
+    void build_table()
+    {
+        const size_t n = areas.size();
+        total = 0;
+        for( double a : areas ) total += a;
+
+        threshold.assign( n, UINT32_MAX );
+        alias.resize( n );
+        for( size_t i = 0; i < n; i++) alias[i] = (int)i;
+        if( !valid() ) return;
+
+        std::vector<double> p(n);
+        std::vector<int>    small, large;
+        for( size_t i = 0; i < n; i++) {
+            p[i] = areas[i]*(double)n/total;
+            (p[i] < 1 ? small : large).push_back( (int)i );
+        }
+        while( !small.empty() && !large.empty() ) {
+            int s = small.back(), l = large.back();
+            small.pop_back();
+            threshold[s] = (uint32_t)std::min(p[s]*4294967296.0, 4294967295.0);
+            alias[s]     = l;
+            p[l]        -= 1 - p[s];
+            if( p[l] < 1 ) {
+                large.pop_back();
+                small.push_back( l );
+            }
+        }
+        // Whatever is left is 1 up to roundoff and keeps its whole column
+    }
+};
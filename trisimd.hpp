@@ -0,0 +1,766 @@
+#pragma once
+
+#include "tribatch.hpp"
+#include "triclosest.hpp"
+#include "triray.hpp"
+
+#include <type_traits>
+
+///////////////////////////////////////////////////////////////////////////////
+// Hand-vectorized batch kernels with runtime ISA dispatch.
+//
+// TriSIMD::area, TriSIMD::normal and TriSIMD::angles take the same arguments
+// as the TriangleBatch kernels in tribatch.hpp, and TriSIMD::intersect and
+// TriSIMD::closest_point the same as the batched forms in triray.hpp and
+// triclosest.hpp. Each has one code path per instruction set (SSE4.2, AVX2,
+// AVX-512F), all compiled into the same binary through target pragmas; the
+// widest path supported by the CPU is chosen on first use. set_isa() forces a
+// narrower path, e.g. for tests.
+//
+// Accuracy: every path performs the same IEEE operations in the same order as
+// the scalar TriangleBatch kernels (which in turn match trilib.hpp), so
+// results are bit-identical to the scalar fallback for both float and double.
+// Float edge lengths are widened to double exactly like JMath::length. The
+// angle kernels vectorize everything up to the clamped cosines and evaluate
+// acos per lane with the C library, so they also match exactly; with
+// TRIG_FINE or TRIG_COARSE the polynomial acos of fastmath.hpp is vectorized
+// as well. The ray kernels evaluate every lane branch-free and blend the
+// misses to t = +inf, u = v = 0 under a comparison mask; the closest-point
+// kernels likewise blend in the Voronoi region of each lane. TriSIMD::fill
+// runs the Philox rounds of random.hpp in 32-bit integer lanes. FMA
+// contraction is disabled inside the vector kernels; the identity therefore
+// holds as long as the scalar code is not contracted either (i.e. unless
+// built with an FMA -march and -ffp-contract=fast).
+///////////////////////////////////////////////////////////////////////////////
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define TRISIMD_X86 1
+// GCC 12 can report -W(maybe-)uninitialized inside its own AVX-512 headers
+// (_mm512_undefined_pd); the suppression covers the header only.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+#include <immintrin.h>
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#endif
+
+namespace TriSIMD
+{
+enum ISA { ISA_SCALAR = 0, ISA_SSE4 = 1, ISA_AVX2 = 2, ISA_AVX512 = 3 };
+
+inline ISA detect_isa()
+{
+#ifdef TRISIMD_X86
+    __builtin_cpu_init();
+    if( __builtin_cpu_supports("avx512f") ) return ISA_AVX512;
+    if( __builtin_cpu_supports("avx2") )    return ISA_AVX2;
+    if( __builtin_cpu_supports("sse4.2") )  return ISA_SSE4;
+#endif
+    return ISA_SCALAR;
+}
+
+inline ISA &selected_isa()
+{
+    static ISA isa = detect_isa();
+    return isa;
+}
+
+inline ISA active_isa()
+{
+    return selected_isa();
+}
+
+// Select a code path; requests beyond what the CPU supports are clamped.
+inline void set_isa( ISA isa )
+{
+    selected_isa() = std::min( isa, detect_isa() );
+}
+
+inline const char *isa_name( ISA isa )
+{
+    switch( isa ) {
+    case ISA_SSE4:   return "sse4.2";
+    case ISA_AVX2:   return "avx2";
+    case ISA_AVX512: return "avx512f";
+    default:         return "scalar";
+    }
+}
+
+// Corner streams of a batch in the order x0,y0,z0,x1,y1,z1,x2,y2,z2
+template<class T>
+inline void streams( const TriangleBatch<T> &batch, const T *p[9])
+{
+    for( int k = 0; k < 3; k++) {
+        p[3*k+0] = batch.x(k);
+        p[3*k+1] = batch.y(k);
+        p[3*k+2] = batch.z(k);
+    }
+}
+
+// Ray streams of a batch in the order ox,oy,oz,dx,dy,dz,tmin,tmax
+template<class T>
+inline void streams( const RayBatch<T> &rays, const T *p[8])
+{
+    for( int j = 0; j < 3; j++) {
+        p[j]   = rays.origin(j);
+        p[3+j] = rays.dir(j);
+    }
+    p[6] = rays.tmin();
+    p[7] = rays.tmax();
+}
+
+// The last (n < W) entries of N streams (9 for triangles, 8 for rays, 3 for
+// points), padded to a full vector by repeating the first of them, so tails
+// run through the vector code too.
+template<class T, int W, int N = 9>
+struct TailBlock
+{
+    TailBlock( const T *const *src, size_t first, size_t n)
+    {
+        for( int c = 0; c < N; c++) {
+            for( int j = 0; j < W; j++)
+                buf[c][j] = src[c][first + ((size_t)j < n ? j : 0)];
+            ptr[c] = buf[c];
+        }
+    }
+    T        buf[N][W];
+    const T *ptr[N];
+};
+}
+
+#ifdef TRISIMD_X86
+
+///////////////////////////////////////////////////////////////////////////////
+// SSE4.2
+///////////////////////////////////////////////////////////////////////////////
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("sse4.2"))), apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("sse4.2")
+#pragma GCC optimize("fp-contract=off")
+#endif
+
+namespace TriSIMD
+{
+namespace sse4
+{
+struct VecD
+{
+    typedef __m128d reg;
+    typedef double  value_type;
+    typedef VecD    D;
+    static const int width = 2;
+
+    static reg  load( const double *p )  { return _mm_loadu_pd(p); }
+    static reg  load( const float *p )   { return _mm_cvtps_pd( _mm_castsi128_ps( _mm_loadl_epi64((const __m128i*)p))); }
+    static void store( double *p, reg v) { _mm_storeu_pd(p, v); }
+    static reg  set1( double v )         { return _mm_set1_pd(v); }
+    static reg  add( reg a, reg b)       { return _mm_add_pd(a, b); }
+    static reg  sub( reg a, reg b)       { return _mm_sub_pd(a, b); }
+    static reg  mul( reg a, reg b)       { return _mm_mul_pd(a, b); }
+    static reg  div( reg a, reg b)       { return _mm_div_pd(a, b); }
+    static reg  min( reg a, reg b)       { return _mm_min_pd(a, b); }
+    static reg  max( reg a, reg b)       { return _mm_max_pd(a, b); }
+    static reg  sqrt( reg a )            { return _mm_sqrt_pd(a); }
+
+    typedef __m128d mask;
+    static mask cmpge( reg a, reg b)          { return _mm_cmpge_pd(a, b); }
+    static mask cmple( reg a, reg b)          { return _mm_cmple_pd(a, b); }
+    static mask cmpneq( reg a, reg b)         { return _mm_cmpneq_pd(a, b); }
+    static mask mask_and( mask a, mask b)     { return _mm_and_pd(a, b); }
+    static reg  select( mask m, reg a, reg b) { return _mm_blendv_pd(b, a, m); }
+
+    static reg length2( reg dx, reg dy, reg dz)
+    {
+        return add( add( mul(dx,dx), mul(dy,dy)), mul(dz,dz));
+    }
+    static reg length( reg dx, reg dy, reg dz) { return sqrt( length2(dx,dy,dz) ); }
+};
+
+struct VecF
+{
+    typedef __m128 reg;
+    typedef float  value_type;
+    typedef VecD   D;
+    static const int width = 4;
+
+    static reg  load( const float *p )  { return _mm_loadu_ps(p); }
+    static void store( float *p, reg v) { _mm_storeu_ps(p, v); }
+    static reg  set1( float v )         { return _mm_set1_ps(v); }
+    static reg  add( reg a, reg b)      { return _mm_add_ps(a, b); }
+    static reg  sub( reg a, reg b)      { return _mm_sub_ps(a, b); }
+    static reg  mul( reg a, reg b)      { return _mm_mul_ps(a, b); }
+    static reg  div( reg a, reg b)      { return _mm_div_ps(a, b); }
+    static reg  sqrt( reg a )           { return _mm_sqrt_ps(a); }
+
+    typedef __m128 mask;
+    static mask cmpge( reg a, reg b)          { return _mm_cmpge_ps(a, b); }
+    static mask cmple( reg a, reg b)          { return _mm_cmple_ps(a, b); }
+    static mask cmpneq( reg a, reg b)         { return _mm_cmpneq_ps(a, b); }
+    static mask mask_and( mask a, mask b)     { return _mm_and_ps(a, b); }
+    static reg  select( mask m, reg a, reg b) { return _mm_blendv_ps(b, a, m); }
+
+    // Squared and plain edge lengths are accumulated in double, as in
+    // JMath::length2/length, and rounded back to float.
+    static reg length2( reg dx, reg dy, reg dz)
+    {
+        __m128d lo = D::length2( _mm_cvtps_pd(dx), _mm_cvtps_pd(dy), _mm_cvtps_pd(dz));
+        __m128d hi = D::length2( _mm_cvtps_pd( _mm_movehl_ps(dx,dx)),
+                                 _mm_cvtps_pd( _mm_movehl_ps(dy,dy)),
+                                 _mm_cvtps_pd( _mm_movehl_ps(dz,dz)));
+        return _mm_movelh_ps( _mm_cvtpd_ps(lo), _mm_cvtpd_ps(hi));
+    }
+    static reg length( reg dx, reg dy, reg dz)
+    {
+        __m128d lo = D::length( _mm_cvtps_pd(dx), _mm_cvtps_pd(dy), _mm_cvtps_pd(dz));
+        __m128d hi = D::length( _mm_cvtps_pd( _mm_movehl_ps(dx,dx)),
+                                _mm_cvtps_pd( _mm_movehl_ps(dy,dy)),
+                                _mm_cvtps_pd( _mm_movehl_ps(dz,dz)));
+        return _mm_movelh_ps( _mm_cvtpd_ps(lo), _mm_cvtpd_ps(hi));
+    }
+};
+// Unsigned 32-bit lanes, for the Philox kernel
+struct VecU
+{
+    typedef __m128i reg;
+    static const int width = 4;
+
+    static reg  load( const uint32_t *p )  { return _mm_loadu_si128( (const __m128i*)p ); }
+    static void store( uint32_t *p, reg v) { _mm_storeu_si128( (__m128i*)p, v ); }
+    static reg  set1( uint32_t v )         { return _mm_set1_epi32( (int)v ); }
+    static reg  iota( uint32_t v )         { return _mm_add_epi32( set1(v), _mm_setr_epi32(0, 1, 2, 3)); }
+    static reg  bxor( reg a, reg b)        { return _mm_xor_si128(a, b); }
+
+    // High and low halves of the 64-bit products a*m, lane by lane (m is a
+    // broadcast): even lanes from one mul_epu32, odd lanes from another
+    static void mulhilo( reg a, reg m, reg &hi, reg &lo)
+    {
+        reg pe = _mm_mul_epu32( a, m );
+        reg po = _mm_mul_epu32( _mm_srli_epi64(a, 32), m );
+        lo = _mm_blend_epi16( pe, _mm_slli_epi64(po, 32), 0xCC );
+        hi = _mm_blend_epi16( _mm_srli_epi64(pe, 32), po, 0xCC );
+    }
+
+    // Interleaves four registers: lane j of c0..c3 goes to words 4j..4j+3
+    // of r[0..3] taken as one array
+    static void interleave4( reg c0, reg c1, reg c2, reg c3, reg r[4])
+    {
+        reg t0 = _mm_unpacklo_epi32(c0, c1), t1 = _mm_unpacklo_epi32(c2, c3);
+        reg t2 = _mm_unpackhi_epi32(c0, c1), t3 = _mm_unpackhi_epi32(c2, c3);
+        r[0] = _mm_unpacklo_epi64(t0, t1);
+        r[1] = _mm_unpackhi_epi64(t0, t1);
+        r[2] = _mm_unpacklo_epi64(t2, t3);
+        r[3] = _mm_unpackhi_epi64(t2, t3);
+    }
+
+    // JMath::uniform_float lane by lane
+    static VecF::reg unit_float( reg w )
+    {
+        return _mm_mul_ps( _mm_cvtepi32_ps( _mm_srli_epi32(w, 8)), _mm_set1_ps(1.0f/16777216.0f));
+    }
+};
+}
+}
+
+#define TRISIMD_NS sse4
+#include "trisimd_kernels.inl"
+#undef TRISIMD_NS
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+// AVX2
+///////////////////////////////////////////////////////////////////////////////
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("avx2"))), apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#pragma GCC optimize("fp-contract=off")
+#endif
+
+namespace TriSIMD
+{
+namespace avx2
+{
+struct VecD
+{
+    typedef __m256d reg;
+    typedef double  value_type;
+    typedef VecD    D;
+    static const int width = 4;
+
+    static reg  load( const double *p )  { return _mm256_loadu_pd(p); }
+    static reg  load( const float *p )   { return _mm256_cvtps_pd( _mm_loadu_ps(p)); }
+    static void store( double *p, reg v) { _mm256_storeu_pd(p, v); }
+    static reg  set1( double v )         { return _mm256_set1_pd(v); }
+    static reg  add( reg a, reg b)       { return _mm256_add_pd(a, b); }
+    static reg  sub( reg a, reg b)       { return _mm256_sub_pd(a, b); }
+    static reg  mul( reg a, reg b)       { return _mm256_mul_pd(a, b); }
+    static reg  div( reg a, reg b)       { return _mm256_div_pd(a, b); }
+    static reg  min( reg a, reg b)       { return _mm256_min_pd(a, b); }
+    static reg  max( reg a, reg b)       { return _mm256_max_pd(a, b); }
+    static reg  sqrt( reg a )            { return _mm256_sqrt_pd(a); }
+
+    typedef __m256d mask;
+    static mask cmpge( reg a, reg b)          { return _mm256_cmp_pd(a, b, _CMP_GE_OQ); }
+    static mask cmple( reg a, reg b)          { return _mm256_cmp_pd(a, b, _CMP_LE_OQ); }
+    static mask cmpneq( reg a, reg b)         { return _mm256_cmp_pd(a, b, _CMP_NEQ_UQ); }
+    static mask mask_and( mask a, mask b)     { return _mm256_and_pd(a, b); }
+    static reg  select( mask m, reg a, reg b) { return _mm256_blendv_pd(b, a, m); }
+
+    static reg length2( reg dx, reg dy, reg dz)
+    {
+        return add( add( mul(dx,dx), mul(dy,dy)), mul(dz,dz));
+    }
+    static reg length( reg dx, reg dy, reg dz) { return sqrt( length2(dx,dy,dz) ); }
+};
+
+struct VecF
+{
+    typedef __m256 reg;
+    typedef float  value_type;
+    typedef VecD   D;
+    static const int width = 8;
+
+    static reg  load( const float *p )  { return _mm256_loadu_ps(p); }
+    static void store( float *p, reg v) { _mm256_storeu_ps(p, v); }
+    static reg  set1( float v )         { return _mm256_set1_ps(v); }
+    static reg  add( reg a, reg b)      { return _mm256_add_ps(a, b); }
+    static reg  sub( reg a, reg b)      { return _mm256_sub_ps(a, b); }
+    static reg  mul( reg a, reg b)      { return _mm256_mul_ps(a, b); }
+    static reg  div( reg a, reg b)      { return _mm256_div_ps(a, b); }
+    static reg  sqrt( reg a )           { return _mm256_sqrt_ps(a); }
+
+    typedef __m256 mask;
+    static mask cmpge( reg a, reg b)          { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+    static mask cmple( reg a, reg b)          { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+    static mask cmpneq( reg a, reg b)         { return _mm256_cmp_ps(a, b, _CMP_NEQ_UQ); }
+    static mask mask_and( mask a, mask b)     { return _mm256_and_ps(a, b); }
+    static reg  select( mask m, reg a, reg b) { return _mm256_blendv_ps(b, a, m); }
+
+    static __m256d lo( reg v ) { return _mm256_cvtps_pd( _mm256_castps256_ps128(v)); }
+    static __m256d hi( reg v ) { return _mm256_cvtps_pd( _mm256_extractf128_ps(v, 1)); }
+    static reg join( __m256d l, __m256d h)
+    {
+        return _mm256_insertf128_ps( _mm256_castps128_ps256( _mm256_cvtpd_ps(l)), _mm256_cvtpd_ps(h), 1);
+    }
+
+    static reg length2( reg dx, reg dy, reg dz)
+    {
+        return join( D::length2( lo(dx), lo(dy), lo(dz)), D::length2( hi(dx), hi(dy), hi(dz)));
+    }
+    static reg length( reg dx, reg dy, reg dz)
+    {
+        return join( D::length( lo(dx), lo(dy), lo(dz)), D::length( hi(dx), hi(dy), hi(dz)));
+    }
+};
+struct VecU
+{
+    typedef __m256i reg;
+    static const int width = 8;
+
+    static reg  load( const uint32_t *p )  { return _mm256_loadu_si256( (const __m256i*)p ); }
+    static void store( uint32_t *p, reg v) { _mm256_storeu_si256( (__m256i*)p, v ); }
+    static reg  set1( uint32_t v )         { return _mm256_set1_epi32( (int)v ); }
+    static reg  iota( uint32_t v )         { return _mm256_add_epi32( set1(v), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7)); }
+    static reg  bxor( reg a, reg b)        { return _mm256_xor_si256(a, b); }
+
+    static void mulhilo( reg a, reg m, reg &hi, reg &lo)
+    {
+        reg pe = _mm256_mul_epu32( a, m );
+        reg po = _mm256_mul_epu32( _mm256_srli_epi64(a, 32), m );
+        lo = _mm256_blend_epi32( pe, _mm256_slli_epi64(po, 32), 0xAA );
+        hi = _mm256_blend_epi32( _mm256_srli_epi64(pe, 32), po, 0xAA );
+    }
+
+    static void interleave4( reg c0, reg c1, reg c2, reg c3, reg r[4])
+    {
+        reg t0 = _mm256_unpacklo_epi32(c0, c1), t1 = _mm256_unpacklo_epi32(c2, c3);
+        reg t2 = _mm256_unpackhi_epi32(c0, c1), t3 = _mm256_unpackhi_epi32(c2, c3);
+        reg r0 = _mm256_unpacklo_epi64(t0, t1), r1 = _mm256_unpackhi_epi64(t0, t1);
+        reg r2 = _mm256_unpacklo_epi64(t2, t3), r3 = _mm256_unpackhi_epi64(t2, t3);
+        // rk holds the words of lanes k and 4+k
+        r[0] = _mm256_permute2x128_si256(r0, r1, 0x20);
+        r[1] = _mm256_permute2x128_si256(r2, r3, 0x20);
+        r[2] = _mm256_permute2x128_si256(r0, r1, 0x31);
+        r[3] = _mm256_permute2x128_si256(r2, r3, 0x31);
+    }
+
+    static VecF::reg unit_float( reg w )
+    {
+        return _mm256_mul_ps( _mm256_cvtepi32_ps( _mm256_srli_epi32(w, 8)), _mm256_set1_ps(1.0f/16777216.0f));
+    }
+};
+}
+}
+
+#define TRISIMD_NS avx2
+#include "trisimd_kernels.inl"
+#undef TRISIMD_NS
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+// AVX-512F
+///////////////////////////////////////////////////////////////////////////////
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("avx512f"))), apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("avx512f")
+#pragma GCC optimize("fp-contract=off")
+#endif
+
+namespace TriSIMD
+{
+namespace avx512
+{
+struct VecD
+{
+    typedef __m512d reg;
+    typedef double  value_type;
+    typedef VecD    D;
+    static const int width = 8;
+
+    static reg  load( const double *p )  { return _mm512_loadu_pd(p); }
+    static reg  load( const float *p )   { return _mm512_cvtps_pd( _mm256_loadu_ps(p)); }
+    static void store( double *p, reg v) { _mm512_storeu_pd(p, v); }
+    static reg  set1( double v )         { return _mm512_set1_pd(v); }
+    static reg  add( reg a, reg b)       { return _mm512_add_pd(a, b); }
+    static reg  sub( reg a, reg b)       { return _mm512_sub_pd(a, b); }
+    static reg  mul( reg a, reg b)       { return _mm512_mul_pd(a, b); }
+    static reg  div( reg a, reg b)       { return _mm512_div_pd(a, b); }
+    static reg  min( reg a, reg b)       { return _mm512_min_pd(a, b); }
+    static reg  max( reg a, reg b)       { return _mm512_max_pd(a, b); }
+    static reg  sqrt( reg a )            { return _mm512_sqrt_pd(a); }
+
+    typedef __mmask8 mask;
+    static mask cmpge( reg a, reg b)          { return _mm512_cmp_pd_mask(a, b, _CMP_GE_OQ); }
+    static mask cmple( reg a, reg b)          { return _mm512_cmp_pd_mask(a, b, _CMP_LE_OQ); }
+    static mask cmpneq( reg a, reg b)         { return _mm512_cmp_pd_mask(a, b, _CMP_NEQ_UQ); }
+    static mask mask_and( mask a, mask b)     { return a & b; }
+    static reg  select( mask m, reg a, reg b) { return _mm512_mask_blend_pd(m, b, a); }
+
+    static reg length2( reg dx, reg dy, reg dz)
+    {
+        return add( add( mul(dx,dx), mul(dy,dy)), mul(dz,dz));
+    }
+    static reg length( reg dx, reg dy, reg dz) { return sqrt( length2(dx,dy,dz) ); }
+};
+
+struct VecF
+{
+    typedef __m512 reg;
+    typedef float  value_type;
+    typedef VecD   D;
+    static const int width = 16;
+
+    static reg  load( const float *p )  { return _mm512_loadu_ps(p); }
+    static void store( float *p, reg v) { _mm512_storeu_ps(p, v); }
+    static reg  set1( float v )         { return _mm512_set1_ps(v); }
+    static reg  add( reg a, reg b)      { return _mm512_add_ps(a, b); }
+    static reg  sub( reg a, reg b)      { return _mm512_sub_ps(a, b); }
+    static reg  mul( reg a, reg b)      { return _mm512_mul_ps(a, b); }
+    static reg  div( reg a, reg b)      { return _mm512_div_ps(a, b); }
+    static reg  sqrt( reg a )           { return _mm512_sqrt_ps(a); }
+
+    typedef __mmask16 mask;
+    static mask cmpge( reg a, reg b)          { return _mm512_cmp_ps_mask(a, b, _CMP_GE_OQ); }
+    static mask cmple( reg a, reg b)          { return _mm512_cmp_ps_mask(a, b, _CMP_LE_OQ); }
+    static mask cmpneq( reg a, reg b)         { return _mm512_cmp_ps_mask(a, b, _CMP_NEQ_UQ); }
+    static mask mask_and( mask a, mask b)     { return a & b; }
+    static reg  select( mask m, reg a, reg b) { return _mm512_mask_blend_ps(m, b, a); }
+
+    static __m512d lo( reg v ) { return _mm512_cvtps_pd( _mm512_castps512_ps256(v)); }
+    static __m512d hi( reg v )
+    {
+        return _mm512_cvtps_pd( _mm256_castpd_ps( _mm512_extractf64x4_pd( _mm512_castps_pd(v), 1)));
+    }
+    static reg join( __m512d l, __m512d h)
+    {
+        __m512d v = _mm512_castps_pd( _mm512_castps256_ps512( _mm512_cvtpd_ps(l)));
+        return _mm512_castpd_ps( _mm512_insertf64x4( v, _mm256_castps_pd( _mm512_cvtpd_ps(h)), 1));
+    }
+
+    static reg length2( reg dx, reg dy, reg dz)
+    {
+        return join( D::length2( lo(dx), lo(dy), lo(dz)), D::length2( hi(dx), hi(dy), hi(dz)));
+    }
+    static reg length( reg dx, reg dy, reg dz)
+    {
+        return join( D::length( lo(dx), lo(dy), lo(dz)), D::length( hi(dx), hi(dy), hi(dz)));
+    }
+};
+struct VecU
+{
+    typedef __m512i reg;
+    static const int width = 16;
+
+    static reg  load( const uint32_t *p )  { return _mm512_loadu_si512( p ); }
+    static void store( uint32_t *p, reg v) { _mm512_storeu_si512( p, v ); }
+    static reg  set1( uint32_t v )         { return _mm512_set1_epi32( (int)v ); }
+    static reg  iota( uint32_t v )
+    {
+        return _mm512_add_epi32( set1(v), _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+    }
+    static reg  bxor( reg a, reg b)        { return _mm512_xor_si512(a, b); }
+
+    static void mulhilo( reg a, reg m, reg &hi, reg &lo)
+    {
+        reg pe = _mm512_mul_epu32( a, m );
+        reg po = _mm512_mul_epu32( _mm512_srli_epi64(a, 32), m );
+        lo = _mm512_mask_blend_epi32( 0xAAAA, pe, _mm512_slli_epi64(po, 32) );
+        hi = _mm512_mask_blend_epi32( 0xAAAA, _mm512_srli_epi64(pe, 32), po );
+    }
+
+    static void interleave4( reg c0, reg c1, reg c2, reg c3, reg r[4])
+    {
+        reg t0 = _mm512_unpacklo_epi32(c0, c1), t1 = _mm512_unpacklo_epi32(c2, c3);
+        reg t2 = _mm512_unpackhi_epi32(c0, c1), t3 = _mm512_unpackhi_epi32(c2, c3);
+        reg r0 = _mm512_unpacklo_epi64(t0, t1), r1 = _mm512_unpackhi_epi64(t0, t1);
+        reg r2 = _mm512_unpacklo_epi64(t2, t3), r3 = _mm512_unpackhi_epi64(t2, t3);
+        // rk holds the words of lanes k, 4+k, 8+k and 12+k
+        reg a = _mm512_shuffle_i32x4(r0, r1, 0x44), b = _mm512_shuffle_i32x4(r2, r3, 0x44);
+        reg c = _mm512_shuffle_i32x4(r0, r1, 0xEE), d = _mm512_shuffle_i32x4(r2, r3, 0xEE);
+        r[0] = _mm512_shuffle_i32x4(a, b, 0x88);
+        r[1] = _mm512_shuffle_i32x4(a, b, 0xDD);
+        r[2] = _mm512_shuffle_i32x4(c, d, 0x88);
+        r[3] = _mm512_shuffle_i32x4(c, d, 0xDD);
+    }
+
+    static VecF::reg unit_float( reg w )
+    {
+        return _mm512_mul_ps( _mm512_cvtepi32_ps( _mm512_srli_epi32(w, 8)), _mm512_set1_ps(1.0f/16777216.0f));
+    }
+};
+}
+}
+
+#define TRISIMD_NS avx512
+#include "trisimd_kernels.inl"
+#undef TRISIMD_NS
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+
+#endif // TRISIMD_X86
+
+///////////////////////////////////////////////////////////////////////////////
+// Dispatching entry points
+///////////////////////////////////////////////////////////////////////////////
+
+namespace TriSIMD
+{
+template<class T>
+struct is_simd_type : std::integral_constant<bool, std::is_same<T,float>::value ||
+                                                   std::is_same<T,double>::value> {};
+
+template<class T>
+inline void area( const TriangleBatch<T> &batch, T *out)
+{
+#ifdef TRISIMD_X86
+    if constexpr ( is_simd_type<T>::value ) {
+        switch( active_isa() ) {
+        case ISA_AVX512: avx512::area_kernel(batch, out); return;
+        case ISA_AVX2:   avx2::area_kernel(batch, out);   return;
+        case ISA_SSE4:   sse4::area_kernel(batch, out);   return;
+        default: break;
+        }
+    }
+#endif
+    ::area(batch, out);
+}
+
+template<class T>
+inline void normal( const TriangleBatch<T> &batch, T *nx, T *ny, T *nz)
+{
+#ifdef TRISIMD_X86
+    if constexpr ( is_simd_type<T>::value ) {
+        switch( active_isa() ) {
+        case ISA_AVX512: avx512::normal_kernel(batch, nx, ny, nz); return;
+        case ISA_AVX2:   avx2::normal_kernel(batch, nx, ny, nz);   return;
+        case ISA_SSE4:   sse4::normal_kernel(batch, nx, ny, nz);   return;
+        default: break;
+        }
+    }
+#endif
+    ::normal(batch, nx, ny, nz);
+}
+
+template<class T>
+inline void angles( const TriangleBatch<T> &batch, T *a0, T *a1, T *a2,
+                    int measure = ANGLE_IN_DEGREES, TrigAccuracy accuracy = TRIG_EXACT)
+{
+#ifdef TRISIMD_X86
+    if constexpr ( is_simd_type<T>::value ) {
+        switch( active_isa() ) {
+        case ISA_AVX512:
+            with_trig( accuracy, [&]( auto trig ) { avx512::angles_kernel(batch, a0, a1, a2, measure, trig); });
+            return;
+        case ISA_AVX2:
+            with_trig( accuracy, [&]( auto trig ) { avx2::angles_kernel(batch, a0, a1, a2, measure, trig); });
+            return;
+        case ISA_SSE4:
+            with_trig( accuracy, [&]( auto trig ) { sse4::angles_kernel(batch, a0, a1, a2, measure, trig); });
+            return;
+        default: break;
+        }
+    }
+#endif
+    ::angles(batch, a0, a1, a2, measure, accuracy);
+}
+
+// One ray against every triangle of a batch
+template<class T>
+inline void intersect( const Ray<T> &ray, const TriangleBatch<T> &batch, T *t, T *u, T *v)
+{
+#ifdef TRISIMD_X86
+    if constexpr ( is_simd_type<T>::value ) {
+        switch( active_isa() ) {
+        case ISA_AVX512: avx512::ray_kernel(ray, batch, t, u, v); return;
+        case ISA_AVX2:   avx2::ray_kernel(ray, batch, t, u, v);   return;
+        case ISA_SSE4:   sse4::ray_kernel(ray, batch, t, u, v);   return;
+        default: break;
+        }
+    }
+#endif
+    ::intersect(ray, batch, t, u, v);
+}
+
+// Every ray of a batch against one triangle
+template<class P, class T = JMath::point3_t<P>>
+inline void intersect( const RayBatch<T> &rays, const P &pa, const P &pb, const P &pc,
+                       T *t, T *u, T *v)
+{
+#ifdef TRISIMD_X86
+    if constexpr ( is_simd_type<T>::value ) {
+        const T tri[9] = { (T)pa[0], (T)pa[1], (T)pa[2], (T)pb[0], (T)pb[1], (T)pb[2],
+                           (T)pc[0], (T)pc[1], (T)pc[2] };
+        switch( active_isa() ) {
+        case ISA_AVX512: avx512::packet_kernel(rays, tri, t, u, v); return;
+        case ISA_AVX2:   avx2::packet_kernel(rays, tri, t, u, v);   return;
+        case ISA_SSE4:   sse4::packet_kernel(rays, tri, t, u, v);   return;
+        default: break;
+        }
+    }
+#endif
+    ::intersect(rays, pa, pb, pc, t, u, v);
+}
+
+// Point i against triangle i of a batch; px, py, pz and feature may be null
+template<class T>
+inline void closest_point( const TriangleBatch<T> &batch, const T *qx, const T *qy, const T *qz,
+                           T *dist2, typename TriangleBatch<T>::value_type *px,
+                           typename TriangleBatch<T>::value_type *py,
+                           typename TriangleBatch<T>::value_type *pz, uint8_t *feature)
+{
+#ifdef TRISIMD_X86
+    if constexpr ( is_simd_type<T>::value ) {
+        switch( active_isa() ) {
+        case ISA_AVX512: avx512::closest_kernel(batch, qx, qy, qz, dist2, px, py, pz, feature); return;
+        case ISA_AVX2:   avx2::closest_kernel(batch, qx, qy, qz, dist2, px, py, pz, feature);   return;
+        case ISA_SSE4:   sse4::closest_kernel(batch, qx, qy, qz, dist2, px, py, pz, feature);   return;
+        default: break;
+        }
+    }
+#endif
+    ::closest_point(batch, qx, qy, qz, dist2, px, py, pz, feature);
+}
+
+// n points against one triangle; px, py, pz and feature may be null
+template<class P, class T = JMath::point3_t<P>>
+inline void closest_point( const P &pa, const P &pb, const P &pc,
+                           size_t n, const T *qx, const T *qy, const T *qz, T *dist2,
+                           JMath::point3_t<P> *px, JMath::point3_t<P> *py,
+                           JMath::point3_t<P> *pz, uint8_t *feature)
+{
+#ifdef TRISIMD_X86
+    if constexpr ( is_simd_type<T>::value ) {
+        const T tri[9] = { (T)pa[0], (T)pa[1], (T)pa[2], (T)pb[0], (T)pb[1], (T)pb[2],
+                           (T)pc[0], (T)pc[1], (T)pc[2] };
+        switch( active_isa() ) {
+        case ISA_AVX512: avx512::closest_packet_kernel(tri, n, qx, qy, qz, dist2, px, py, pz, feature); return;
+        case ISA_AVX2:   avx2::closest_packet_kernel(tri, n, qx, qy, qz, dist2, px, py, pz, feature);   return;
+        case ISA_SSE4:   sse4::closest_packet_kernel(tri, n, qx, qy, qz, dist2, px, py, pz, feature);   return;
+        default: break;
+        }
+    }
+#endif
+    ::closest_point(pa, pb, pc, n, qx, qy, qz, dist2, px, py, pz, feature);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+// RandomStream::fill() and fill_uniform() (random.hpp): the same words and
+// values, leaving the stream at the same position, with the Philox rounds
+// of 4-16 blocks per instruction. Float values are converted in registers,
+// doubles from a buffer of words.
+inline void fill( JMath::RandomStream &rng, uint32_t *out, size_t n)
+{
+    size_t i = 0;
+    while( i < n && rng.position() % 4 ) out[i++] = rng.next_u32();
+
+#ifdef TRISIMD_X86
+    const size_t   nblocks = (n - i)/4;
+    const uint64_t block   = rng.position()/4;
+    size_t done = 0;
+    switch( active_isa() ) {
+    case ISA_AVX512: done = avx512::philox_kernel(block, rng.stream(), rng.seed(), nblocks, out + i); break;
+    case ISA_AVX2:   done = avx2::philox_kernel(block, rng.stream(), rng.seed(), nblocks, out + i);   break;
+    case ISA_SSE4:   done = sse4::philox_kernel(block, rng.stream(), rng.seed(), nblocks, out + i);   break;
+    default: break;
+    }
+    rng.skip( 4*done );
+    i += 4*done;
+#endif
+    rng.fill( out + i, n - i );
+}
+
+template<class T>
+inline void fill_uniform( JMath::RandomStream &rng, T *out, size_t n, T lo, T hi)
+{
+#ifdef TRISIMD_X86
+    if constexpr ( std::is_same<T,float>::value ) {
+        size_t i = 0;
+        while( i < n && rng.position() % 4 ) out[i++] = rng.uniform( lo, hi );
+
+        const size_t   nblocks = (n - i)/4;
+        const uint64_t block   = rng.position()/4;
+        size_t done = 0;
+        switch( active_isa() ) {
+        case ISA_AVX512: done = avx512::philox_kernel(block, rng.stream(), rng.seed(), nblocks, out + i, lo, hi); break;
+        case ISA_AVX2:   done = avx2::philox_kernel(block, rng.stream(), rng.seed(), nblocks, out + i, lo, hi);   break;
+        case ISA_SSE4:   done = sse4::philox_kernel(block, rng.stream(), rng.seed(), nblocks, out + i, lo, hi);   break;
+        default: break;
+        }
+        rng.skip( 4*done );
+        i += 4*done;
+        rng.fill_uniform( out + i, n - i, lo, hi );
+        return;
+    }
+#endif
+    JMath::uniform_fill( out, n, lo, hi, [&]( uint32_t *w, size_t m ) { fill( rng, w, m ); } );
+}
+}
+
+///////////////////////////////////////////////////////////////////////////////
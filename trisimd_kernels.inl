@@ -0,0 +1,587 @@
+// Vector kernels shared by every ISA in trisimd.hpp.
+//
+// This file is included once per instruction set, inside the matching target
+// pragma, with TRISIMD_NS naming the namespace that holds that ISA's VecD and
+// VecF register traits. It has no include guard on purpose.
+
+namespace TriSIMD
+{
+namespace TRISIMD_NS
+{
+template<class T> struct VecOf;
+template<> struct VecOf<double> { typedef VecD type; };
+template<> struct VecOf<float>  { typedef VecF type; };
+
+///////////////////////////////////////////////////////////////////////////////
+
+template<class V, class T>
+inline void area_block( const T *const *p, size_t i, T *out)
+{
+    typedef typename V::reg reg;
+    reg x0 = V::load(p[0]+i), y0 = V::load(p[1]+i), z0 = V::load(p[2]+i);
+    reg x1 = V::load(p[3]+i), y1 = V::load(p[4]+i), z1 = V::load(p[5]+i);
+    reg x2 = V::load(p[6]+i), y2 = V::load(p[7]+i), z2 = V::load(p[8]+i);
+
+    reg a = V::length( V::sub(x1,x2), V::sub(y1,y2), V::sub(z1,z2));
+    reg b = V::length( V::sub(x2,x0), V::sub(y2,y0), V::sub(z2,z0));
+    reg c = V::length( V::sub(x0,x1), V::sub(y0,y1), V::sub(z0,z1));
+
+    reg s = V::mul( V::set1(0.5), V::add( V::add(a,b), c));
+    reg h = V::mul( V::mul( V::mul( s, V::sub(s,a)), V::sub(s,b)), V::sub(s,c));
+    V::store( out+i, V::sqrt(h));
+}
+
+template<class T>
+inline void area_kernel( const TriangleBatch<T> &batch, T *out)
+{
+    typedef typename VecOf<T>::type V;
+    const int W = V::width;
+
+    const T *p[9];
+    streams(batch, p);
+
+    const size_t n = batch.size();
+    size_t i = 0;
+    for( ; i + W <= n; i += W)
+        area_block<V>(p, i, out);
+
+    if( i < n ) {
+        TailBlock<T,W> tail(p, i, n - i);
+        T tmp[W];
+        area_block<V>(tail.ptr, 0, tmp);
+        std::copy( tmp, tmp + (n - i), out + i);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template<class V, class T>
+inline void normal_block( const T *const *p, size_t i, T *nx, T *ny, T *nz)
+{
+    typedef typename V::reg reg;
+    reg x0 = V::load(p[0]+i), y0 = V::load(p[1]+i), z0 = V::load(p[2]+i);
+    reg x1 = V::load(p[3]+i), y1 = V::load(p[4]+i), z1 = V::load(p[5]+i);
+    reg x2 = V::load(p[6]+i), y2 = V::load(p[7]+i), z2 = V::load(p[8]+i);
+
+    reg ux = V::sub(x1,x0), uy = V::sub(y1,y0), uz = V::sub(z1,z0);
+    reg vx = V::sub(x2,x0), vy = V::sub(y2,y0), vz = V::sub(z2,z0);
+
+    reg cx = V::sub( V::mul(uy,vz), V::mul(uz,vy));
+    reg cy = V::sub( V::mul(uz,vx), V::mul(ux,vz));
+    reg cz = V::sub( V::mul(ux,vy), V::mul(uy,vx));
+
+    reg mag = V::sqrt( V::add( V::add( V::mul(cx,cx), V::mul(cy,cy)), V::mul(cz,cz)));
+    V::store( nx+i, V::div(cx, mag));
+    V::store( ny+i, V::div(cy, mag));
+    V::store( nz+i, V::div(cz, mag));
+}
+
+template<class T>
+inline void normal_kernel( const TriangleBatch<T> &batch, T *nx, T *ny, T *nz)
+{
+    typedef typename VecOf<T>::type V;
+    const int W = V::width;
+
+    const T *p[9];
+    streams(batch, p);
+
+    const size_t n = batch.size();
+    size_t i = 0;
+    for( ; i + W <= n; i += W)
+        normal_block<V>(p, i, nx, ny, nz);
+
+    if( i < n ) {
+        TailBlock<T,W> tail(p, i, n - i);
+        T tmp[3][W];
+        normal_block<V>(tail.ptr, 0, tmp[0], tmp[1], tmp[2]);
+        std::copy( tmp[0], tmp[0] + (n - i), nx + i);
+        std::copy( tmp[1], tmp[1] + (n - i), ny + i);
+        std::copy( tmp[2], tmp[2] + (n - i), nz + i);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+// poly_acos (fastmath.hpp) over a register, in the same operation order
+template<class D, int N>
+inline typename D::reg acos_lanes( const double (&c)[N], typename D::reg x )
+{
+    typedef typename D::reg dreg;
+    const dreg zero = D::set1(0.0);
+    const auto pos  = D::cmpge( x, zero );
+    const dreg ax   = D::select( pos, x, D::sub( zero, x ));
+
+    dreg p = D::set1( c[N-1] );
+    for( int k = N-2; k >= 0; k--) p = D::add( D::mul( p, ax ), D::set1( c[k] ));
+    const dreg r = D::mul( D::sqrt( D::sub( D::set1(1.0), ax )), p );
+    return D::select( pos, r, D::sub( D::set1(M_PI), r ));
+}
+
+// Edges, squared lengths and cosines are all formed in double, as trilib's
+// angles() does under its default DoublePrecision policy. The exact acos is
+// taken per lane, the polynomial tiers in registers.
+template<class V, class Trig, class T>
+inline void angles_block( const T *const *p, size_t i, double scale,
+                          T *a0, T *a1, T *a2)
+{
+    typedef typename V::D   D;
+    typedef typename D::reg dreg;
+    const int W  = V::width;
+    const int DW = D::width;
+
+    double cosang[3][W];
+    const dreg one = D::set1(1.0), minus_one = D::set1(-1.0), two = D::set1(2.0);
+    for( int j = 0; j < W; j += DW) {
+        dreg x0 = D::load(p[0]+i+j), y0 = D::load(p[1]+i+j), z0 = D::load(p[2]+i+j);
+        dreg x1 = D::load(p[3]+i+j), y1 = D::load(p[4]+i+j), z1 = D::load(p[5]+i+j);
+        dreg x2 = D::load(p[6]+i+j), y2 = D::load(p[7]+i+j), z2 = D::load(p[8]+i+j);
+        dreg la2 = D::length2( D::sub(x1,x2), D::sub(y1,y2), D::sub(z1,z2));
+        dreg lb2 = D::length2( D::sub(x2,x0), D::sub(y2,y0), D::sub(z2,z0));
+        dreg lc2 = D::length2( D::sub(x0,x1), D::sub(y0,y1), D::sub(z0,z1));
+        dreg cosA = D::div( D::sub( D::add(lb2,lc2), la2), D::mul( two, D::sqrt( D::mul(lb2,lc2))));
+        dreg cosB = D::div( D::sub( D::add(la2,lc2), lb2), D::mul( two, D::sqrt( D::mul(la2,lc2))));
+        dreg cosC = D::div( D::sub( D::add(la2,lb2), lc2), D::mul( two, D::sqrt( D::mul(la2,lb2))));
+        // max/min return their second operand for NaN, which keeps NaNs
+        cosA = D::min( one, D::max( minus_one, cosA));
+        cosB = D::min( one, D::max( minus_one, cosB));
+        cosC = D::min( one, D::max( minus_one, cosC));
+        if constexpr ( Trig::accuracy != JMath::TRIG_EXACT ) {
+            cosA = acos_lanes<D>( Trig::ACOS, cosA );
+            cosB = acos_lanes<D>( Trig::ACOS, cosB );
+            cosC = acos_lanes<D>( Trig::ACOS, cosC );
+        }
+        D::store( cosang[0]+j, cosA);
+        D::store( cosang[1]+j, cosB);
+        D::store( cosang[2]+j, cosC);
+    }
+
+    for( int j = 0; j < W; j++) {
+        if constexpr ( Trig::accuracy == JMath::TRIG_EXACT ) {
+            a0[i+j] = (T)acos(cosang[0][j])*scale;
+            a1[i+j] = (T)acos(cosang[1][j])*scale;
+            a2[i+j] = (T)acos(cosang[2][j])*scale;
+        } else {
+            a0[i+j] = (T)cosang[0][j]*scale;
+            a1[i+j] = (T)cosang[1][j]*scale;
+            a2[i+j] = (T)cosang[2][j]*scale;
+        }
+    }
+}
+
+template<class T, class Trig>
+inline void angles_kernel( const TriangleBatch<T> &batch, T *a0, T *a1, T *a2, int measure, Trig)
+{
+    typedef typename VecOf<T>::type V;
+    const int W = V::width;
+
+    const double scale = (measure == ANGLE_IN_DEGREES) ? 180/M_PI : 1.0;
+
+    const T *p[9];
+    streams(batch, p);
+
+    const size_t n = batch.size();
+    size_t i = 0;
+    for( ; i + W <= n; i += W)
+        angles_block<V,Trig>(p, i, scale, a0, a1, a2);
+
+    if( i < n ) {
+        TailBlock<T,W> tail(p, i, n - i);
+        T tmp[3][W];
+        angles_block<V,Trig>(tail.ptr, 0, scale, tmp[0], tmp[1], tmp[2]);
+        std::copy( tmp[0], tmp[0] + (n - i), a0 + i);
+        std::copy( tmp[1], tmp[1] + (n - i), a1 + i);
+        std::copy( tmp[2], tmp[2] + (n - i), a2 + i);
+    }
+}
+///////////////////////////////////////////////////////////////////////////////
+
+// Moller-Trumbore over W lanes, in the operation order of the scalar
+// intersect() in triray.hpp. Each lane holds its own ray and triangle
+// (either may be a broadcast); misses come out as t = +inf, u = v = 0.
+template<class V>
+inline void ray_lanes( typename V::reg ox, typename V::reg oy, typename V::reg oz,
+                       typename V::reg dx, typename V::reg dy, typename V::reg dz,
+                       typename V::reg tmin, typename V::reg tmax,
+                       typename V::reg x0, typename V::reg y0, typename V::reg z0,
+                       typename V::reg x1, typename V::reg y1, typename V::reg z1,
+                       typename V::reg x2, typename V::reg y2, typename V::reg z2,
+                       typename V::reg &t, typename V::reg &u, typename V::reg &v)
+{
+    typedef typename V::reg  reg;
+    typedef typename V::mask mask;
+
+    reg e1x = V::sub(x1,x0), e1y = V::sub(y1,y0), e1z = V::sub(z1,z0);
+    reg e2x = V::sub(x2,x0), e2y = V::sub(y2,y0), e2z = V::sub(z2,z0);
+    reg sx  = V::sub(ox,x0), sy  = V::sub(oy,y0), sz  = V::sub(oz,z0);
+
+    reg px  = V::sub( V::mul(dy,e2z), V::mul(dz,e2y));
+    reg py  = V::sub( V::mul(dz,e2x), V::mul(dx,e2z));
+    reg pz  = V::sub( V::mul(dx,e2y), V::mul(dy,e2x));
+    reg det = V::add( V::add( V::mul(e1x,px), V::mul(e1y,py)), V::mul(e1z,pz));
+    reg inv = V::div( V::set1(1), det);
+
+    reg uu = V::mul( V::add( V::add( V::mul(sx,px), V::mul(sy,py)), V::mul(sz,pz)), inv);
+
+    reg qx = V::sub( V::mul(sy,e1z), V::mul(sz,e1y));
+    reg qy = V::sub( V::mul(sz,e1x), V::mul(sx,e1z));
+    reg qz = V::sub( V::mul(sx,e1y), V::mul(sy,e1x));
+    reg vv = V::mul( V::add( V::add( V::mul(dx,qx), V::mul(dy,qy)), V::mul(dz,qz)), inv);
+    reg tt = V::mul( V::add( V::add( V::mul(e2x,qx), V::mul(e2y,qy)), V::mul(e2z,qz)), inv);
+
+    const reg zero = V::set1(0), one = V::set1(1);
+    mask hit = V::cmpneq(det, zero);
+    hit = V::mask_and( hit, V::mask_and( V::cmpge(uu, zero), V::cmple(uu, one)));
+    hit = V::mask_and( hit, V::mask_and( V::cmpge(vv, zero), V::cmple( V::add(uu,vv), one)));
+    hit = V::mask_and( hit, V::mask_and( V::cmpge(tt, tmin), V::cmple(tt, tmax)));
+
+    t = V::select( hit, tt, V::set1( std::numeric_limits<typename V::value_type>::infinity()));
+    u = V::select( hit, uu, zero);
+    v = V::select( hit, vv, zero);
+}
+
+// One ray, W triangles
+template<class V, class T>
+inline void ray_block( const Ray<T> &ray, const T *const *p, size_t i, T *t, T *u, T *v)
+{
+    typedef typename V::reg reg;
+    reg x0 = V::load(p[0]+i), y0 = V::load(p[1]+i), z0 = V::load(p[2]+i);
+    reg x1 = V::load(p[3]+i), y1 = V::load(p[4]+i), z1 = V::load(p[5]+i);
+    reg x2 = V::load(p[6]+i), y2 = V::load(p[7]+i), z2 = V::load(p[8]+i);
+
+    reg tt, uu, vv;
+    ray_lanes<V>( V::set1(ray.origin[0]), V::set1(ray.origin[1]), V::set1(ray.origin[2]),
+                  V::set1(ray.dir[0]),    V::set1(ray.dir[1]),    V::set1(ray.dir[2]),
+                  V::set1(ray.tmin),      V::set1(ray.tmax),
+                  x0, y0, z0, x1, y1, z1, x2, y2, z2, tt, uu, vv );
+    V::store( t+i, tt);
+    V::store( u+i, uu);
+    V::store( v+i, vv);
+}
+
+template<class T>
+inline void ray_kernel( const Ray<T> &ray, const TriangleBatch<T> &batch, T *t, T *u, T *v)
+{
+    typedef typename VecOf<T>::type V;
+    const int W = V::width;
+
+    const T *p[9];
+    streams(batch, p);
+
+    const size_t n = batch.size();
+    size_t i = 0;
+    for( ; i + W <= n; i += W)
+        ray_block<V>(ray, p, i, t, u, v);
+
+    if( i < n ) {
+        TailBlock<T,W> tail(p, i, n - i);
+        T tmp[3][W];
+        ray_block<V>(ray, tail.ptr, 0, tmp[0], tmp[1], tmp[2]);
+        std::copy( tmp[0], tmp[0] + (n - i), t + i);
+        std::copy( tmp[1], tmp[1] + (n - i), u + i);
+        std::copy( tmp[2], tmp[2] + (n - i), v + i);
+    }
+}
+
+// W rays, one triangle (tri holds its nine coordinates)
+template<class V, class T>
+inline void packet_block( const T *const *r, const T *tri, size_t i, T *t, T *u, T *v)
+{
+    typedef typename V::reg reg;
+    reg tt, uu, vv;
+    ray_lanes<V>( V::load(r[0]+i), V::load(r[1]+i), V::load(r[2]+i),
+                  V::load(r[3]+i), V::load(r[4]+i), V::load(r[5]+i),
+                  V::load(r[6]+i), V::load(r[7]+i),
+                  V::set1(tri[0]), V::set1(tri[1]), V::set1(tri[2]),
+                  V::set1(tri[3]), V::set1(tri[4]), V::set1(tri[5]),
+                  V::set1(tri[6]), V::set1(tri[7]), V::set1(tri[8]), tt, uu, vv );
+    V::store( t+i, tt);
+    V::store( u+i, uu);
+    V::store( v+i, vv);
+}
+
+template<class T>
+inline void packet_kernel( const RayBatch<T> &rays, const T *tri, T *t, T *u, T *v)
+{
+    typedef typename VecOf<T>::type V;
+    const int W = V::width;
+
+    const T *r[8];
+    streams(rays, r);
+
+    const size_t n = rays.size();
+    size_t i = 0;
+    for( ; i + W <= n; i += W)
+        packet_block<V>(r, tri, i, t, u, v);
+
+    if( i < n ) {
+        TailBlock<T,W,8> tail(r, i, n - i);
+        T tmp[3][W];
+        packet_block<V>(tail.ptr, tri, 0, tmp[0], tmp[1], tmp[2]);
+        std::copy( tmp[0], tmp[0] + (n - i), t + i);
+        std::copy( tmp[1], tmp[1] + (n - i), u + i);
+        std::copy( tmp[2], tmp[2] + (n - i), v + i);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Closest point over W lanes, in the operation order of
+// closest_point_weights() in triclosest.hpp. The region of each lane is
+// blended in from Ericson's last test to his first (BC, AC, C, AB, B, A), so
+// the earliest test wins as in the scalar lowest-set-bit rule; f holds the
+// TriangleFeature as a lane value.
+template<class V>
+inline void closest_lanes( typename V::reg ax, typename V::reg ay, typename V::reg az,
+                           typename V::reg bx, typename V::reg by, typename V::reg bz,
+                           typename V::reg cx, typename V::reg cy, typename V::reg cz,
+                           typename V::reg qx, typename V::reg qy, typename V::reg qz,
+                           typename V::reg &dist2, typename V::reg &kx, typename V::reg &ky,
+                           typename V::reg &kz, typename V::reg &f)
+{
+    typedef typename V::reg  reg;
+    typedef typename V::mask mask;
+
+    reg abx = V::sub(bx,ax), aby = V::sub(by,ay), abz = V::sub(bz,az);
+    reg acx = V::sub(cx,ax), acy = V::sub(cy,ay), acz = V::sub(cz,az);
+    reg apx = V::sub(qx,ax), apy = V::sub(qy,ay), apz = V::sub(qz,az);
+    reg bpx = V::sub(qx,bx), bpy = V::sub(qy,by), bpz = V::sub(qz,bz);
+    reg cpx = V::sub(qx,cx), cpy = V::sub(qy,cy), cpz = V::sub(qz,cz);
+
+    reg d1 = V::add( V::add( V::mul(abx,apx), V::mul(aby,apy)), V::mul(abz,apz));
+    reg d2 = V::add( V::add( V::mul(acx,apx), V::mul(acy,apy)), V::mul(acz,apz));
+    reg d3 = V::add( V::add( V::mul(abx,bpx), V::mul(aby,bpy)), V::mul(abz,bpz));
+    reg d4 = V::add( V::add( V::mul(acx,bpx), V::mul(acy,bpy)), V::mul(acz,bpz));
+    reg d5 = V::add( V::add( V::mul(abx,cpx), V::mul(aby,cpy)), V::mul(abz,cpz));
+    reg d6 = V::add( V::add( V::mul(acx,cpx), V::mul(acy,cpy)), V::mul(acz,cpz));
+
+    reg va = V::sub( V::mul(d3,d6), V::mul(d5,d4));
+    reg vb = V::sub( V::mul(d5,d2), V::mul(d1,d6));
+    reg vc = V::sub( V::mul(d1,d4), V::mul(d3,d2));
+
+    const reg zero = V::set1(0), one = V::set1(1);
+    reg d43 = V::sub(d4,d3), d56 = V::sub(d5,d6);
+
+    reg  nu  = vb, nv = vc, den = V::add( V::add(va,vb), vc);
+    reg  ff  = V::set1(FEATURE_FACE);
+    mask m;
+
+    m   = V::mask_and( V::cmple(va,zero), V::mask_and( V::cmpge(d43,zero), V::cmpge(d56,zero)));
+    nu  = V::select( m, d56, nu);
+    nv  = V::select( m, d43, nv);
+    den = V::select( m, V::add(d43,d56), den);
+    ff  = V::select( m, V::set1(FEATURE_EDGE_BC), ff);
+
+    m   = V::mask_and( V::cmple(vb,zero), V::mask_and( V::cmpge(d2,zero), V::cmple(d6,zero)));
+    nu  = V::select( m, zero, nu);
+    nv  = V::select( m, d2, nv);
+    den = V::select( m, V::sub(d2,d6), den);
+    ff  = V::select( m, V::set1(FEATURE_EDGE_AC), ff);
+
+    m   = V::mask_and( V::cmpge(d6,zero), V::cmple(d5,d6));
+    nu  = V::select( m, zero, nu);
+    nv  = V::select( m, one, nv);
+    den = V::select( m, one, den);
+    ff  = V::select( m, V::set1(FEATURE_VERTEX_C), ff);
+
+    m   = V::mask_and( V::cmple(vc,zero), V::mask_and( V::cmpge(d1,zero), V::cmple(d3,zero)));
+    nu  = V::select( m, d1, nu);
+    nv  = V::select( m, zero, nv);
+    den = V::select( m, V::sub(d1,d3), den);
+    ff  = V::select( m, V::set1(FEATURE_EDGE_AB), ff);
+
+    m   = V::mask_and( V::cmpge(d3,zero), V::cmple(d4,d3));
+    nu  = V::select( m, one, nu);
+    nv  = V::select( m, zero, nv);
+    den = V::select( m, one, den);
+    ff  = V::select( m, V::set1(FEATURE_VERTEX_B), ff);
+
+    m   = V::mask_and( V::cmple(d1,zero), V::cmple(d2,zero));
+    nu  = V::select( m, zero, nu);
+    nv  = V::select( m, zero, nv);
+    den = V::select( m, one, den);
+    ff  = V::select( m, V::set1(FEATURE_VERTEX_A), ff);
+
+    reg inv = V::div(one, den);
+    reg u   = V::mul(nu, inv), v = V::mul(nv, inv);
+
+    kx = V::add( V::add( ax, V::mul(u,abx)), V::mul(v,acx));
+    ky = V::add( V::add( ay, V::mul(u,aby)), V::mul(v,acy));
+    kz = V::add( V::add( az, V::mul(u,abz)), V::mul(v,acz));
+
+    reg dx = V::sub(kx,qx), dy = V::sub(ky,qy), dz = V::sub(kz,qz);
+    dist2 = V::add( V::add( V::mul(dx,dx), V::mul(dy,dy)), V::mul(dz,dz));
+    f     = ff;
+}
+
+// Writes the first m lanes of a closest-point result to index i
+template<class V, class T>
+inline void closest_store( typename V::reg d2, typename V::reg kx, typename V::reg ky,
+                           typename V::reg kz, typename V::reg f, size_t i, size_t m,
+                           T *dist2, T *px, T *py, T *pz, uint8_t *feature)
+{
+    const int W = V::width;
+    if( m == (size_t)W ) {
+        V::store( dist2+i, d2);
+        if( px ) V::store( px+i, kx);
+        if( py ) V::store( py+i, ky);
+        if( pz ) V::store( pz+i, kz);
+    } else {
+        T tmp[4][W];
+        V::store( tmp[0], d2);
+        V::store( tmp[1], kx);
+        V::store( tmp[2], ky);
+        V::store( tmp[3], kz);
+        std::copy( tmp[0], tmp[0] + m, dist2 + i);
+        if( px ) std::copy( tmp[1], tmp[1] + m, px + i);
+        if( py ) std::copy( tmp[2], tmp[2] + m, py + i);
+        if( pz ) std::copy( tmp[3], tmp[3] + m, pz + i);
+    }
+    if( feature ) {
+        T ff[W];
+        V::store( ff, f);
+        for( size_t j = 0; j < m; j++) feature[i+j] = (uint8_t)ff[j];
+    }
+}
+
+// W points against their own W triangles; p and q are read at j
+template<class V, class T>
+inline void closest_block( const T *const *p, const T *const *q, size_t j, size_t i, size_t m,
+                           T *dist2, T *px, T *py, T *pz, uint8_t *feature)
+{
+    typedef typename V::reg reg;
+    reg d2, kx, ky, kz, f;
+    closest_lanes<V>( V::load(p[0]+j), V::load(p[1]+j), V::load(p[2]+j),
+                      V::load(p[3]+j), V::load(p[4]+j), V::load(p[5]+j),
+                      V::load(p[6]+j), V::load(p[7]+j), V::load(p[8]+j),
+                      V::load(q[0]+j), V::load(q[1]+j), V::load(q[2]+j),
+                      d2, kx, ky, kz, f );
+    closest_store<V>( d2, kx, ky, kz, f, i, m, dist2, px, py, pz, feature);
+}
+
+template<class T>
+inline void closest_kernel( const TriangleBatch<T> &batch, const T *qx, const T *qy, const T *qz,
+                            T *dist2, T *px, T *py, T *pz, uint8_t *feature)
+{
+    typedef typename VecOf<T>::type V;
+    const int W = V::width;
+
+    const T *p[9];
+    streams(batch, p);
+    const T *q[3] = { qx, qy, qz };
+
+    const size_t n = batch.size();
+    size_t i = 0;
+    for( ; i + W <= n; i += W)
+        closest_block<V>(p, q, i, i, W, dist2, px, py, pz, feature);
+
+    if( i < n ) {
+        TailBlock<T,W>   tail(p, i, n - i);
+        TailBlock<T,W,3> qtail(q, i, n - i);
+        closest_block<V>(tail.ptr, qtail.ptr, 0, i, n - i, dist2, px, py, pz, feature);
+    }
+}
+
+// W points against one triangle (tri holds its nine coordinates)
+template<class V, class T>
+inline void closest_packet_block( const T *tri, const T *const *q, size_t j, size_t i, size_t m,
+                                  T *dist2, T *px, T *py, T *pz, uint8_t *feature)
+{
+    typedef typename V::reg reg;
+    reg d2, kx, ky, kz, f;
+    closest_lanes<V>( V::set1(tri[0]), V::set1(tri[1]), V::set1(tri[2]),
+                      V::set1(tri[3]), V::set1(tri[4]), V::set1(tri[5]),
+                      V::set1(tri[6]), V::set1(tri[7]), V::set1(tri[8]),
+                      V::load(q[0]+j), V::load(q[1]+j), V::load(q[2]+j),
+                      d2, kx, ky, kz, f );
+    closest_store<V>( d2, kx, ky, kz, f, i, m, dist2, px, py, pz, feature);
+}
+
+template<class T>
+inline void closest_packet_kernel( const T *tri, size_t n, const T *qx, const T *qy, const T *qz,
+                                   T *dist2, T *px, T *py, T *pz, uint8_t *feature)
+{
+    typedef typename VecOf<T>::type V;
+    const int W = V::width;
+
+    const T *q[3] = { qx, qy, qz };
+
+    size_t i = 0;
+    for( ; i + W <= n; i += W)
+        closest_packet_block<V>(tri, q, i, i, W, dist2, px, py, pz, feature);
+
+    if( i < n ) {
+        TailBlock<T,W,3> qtail(q, i, n - i);
+        closest_packet_block<V>(tri, qtail.ptr, 0, i, n - i, dist2, px, py, pz, feature);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Philox4x32-10 (random.hpp) on W counters per register: the blocks
+// [block, block + m) of a stream, m the largest multiple of W not above
+// nblocks. sink(k, r) receives the words [k, k + W) of their output in
+// sequence order; returns m.
+template<class U, class Sink>
+inline size_t philox_blocks( uint64_t block, uint64_t stream, uint64_t key, size_t nblocks, Sink sink)
+{
+    typedef typename U::reg reg;
+    const int W = U::width;
+    const reg m0 = U::set1(0xD2511F53u), m1 = U::set1(0xCD9E8D57u);
+    const reg s0 = U::set1((uint32_t)stream), s1 = U::set1((uint32_t)(stream >> 32));
+
+    size_t b = 0;
+    for( ; b + W <= nblocks; b += W) {
+        // Counters block + b + j; the low words only carry into the high
+        // ones once every 2^32 blocks, which takes the lane-by-lane route
+        const uint64_t first = block + b;
+        reg c0, c1;
+        if( (uint32_t)first <= 0xFFFFFFFFu - (W - 1) ) {
+            c0 = U::iota( (uint32_t)first );
+            c1 = U::set1( (uint32_t)(first >> 32) );
+        } else {
+            uint32_t lo[W], hi[W];
+            for( int j = 0; j < W; j++) {
+                lo[j] = (uint32_t)(first + j);
+                hi[j] = (uint32_t)((first + j) >> 32);
+            }
+            c0 = U::load(lo);
+            c1 = U::load(hi);
+        }
+        reg c2 = s0, c3 = s1;
+        uint32_t k0 = (uint32_t)key, k1 = (uint32_t)(key >> 32);
+        for( int r = 0; r < 10; r++) {
+            reg h0, l0, h1, l1;
+            U::mulhilo( c0, m0, h0, l0 );
+            U::mulhilo( c2, m1, h1, l1 );
+            c0 = U::bxor( U::bxor(h1, c1), U::set1(k0) );
+            c2 = U::bxor( U::bxor(h0, c3), U::set1(k1) );
+            c1 = l1;
+            c3 = l0;
+            k0 += 0x9E3779B9u;
+            k1 += 0xBB67AE85u;
+        }
+        reg w[4];
+        U::interleave4( c0, c1, c2, c3, w );
+        for( int k = 0; k < 4; k++) sink( 4*b + W*k, w[k] );
+    }
+    return b;
+}
+
+inline size_t philox_kernel( uint64_t block, uint64_t stream, uint64_t key, size_t nblocks, uint32_t *out)
+{
+    return philox_blocks<VecU>( block, stream, key, nblocks, [&]( size_t k, VecU::reg w ) {
+        VecU::store( out + k, w );
+    });
+}
+
+// Floats uniform in [lo, hi), as JMath::uniform_fill computes them
+inline size_t philox_kernel( uint64_t block, uint64_t stream, uint64_t key, size_t nblocks,
+                             float *out, float lo, float hi)
+{
+    const VecF::reg vlo = VecF::set1(lo), range = VecF::set1(hi - lo);
+    return philox_blocks<VecU>( block, stream, key, nblocks, [&]( size_t k, VecU::reg w ) {
+        VecF::store( out + k, VecF::add( vlo, VecF::mul( VecU::unit_float(w), range )));
+    });
+}
+}
+}
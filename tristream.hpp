@@ -0,0 +1,168 @@
+#pragma once
+
+#include "trimeshio.hpp"
+#include "triquality.hpp"
+
+///////////////////////////////////////////////////////////////////////////////
+// Out-of-core mesh analysis.
+//
+// The chunk readers below pull chunk_faces face records at a time from a mesh
+// file into one reusable buffer with pread, and expose the current chunk as
+// a mesh view. analyze_stream() folds each chunk into a running
+// MeshQualityReport, so memory use is set by the chunk size rather than by
+// the mesh. With chunk_faces a multiple of the analyzer's block_size() the
+// final report is identical to analyze() on the whole mesh.
+//
+// STL faces carry their own corners and are fully streamed. PLY faces index
+// into a shared vertex block, which is left memory-mapped (pages are loaded
+// and evicted by the kernel); only the face records are streamed.
+///////////////////////////////////////////////////////////////////////////////
+
+// Read-only file accessed by offset
+class PositionalFile
+{
+public:
+    explicit PositionalFile( const std::string &path ) : name(path)
+    {
+        fd = ::open( path.c_str(), O_RDONLY );
+        if( fd < 0 ) throw std::runtime_error( name + ": " + strerror(errno) );
+    }
+
+    ~PositionalFile() { ::close(fd); }
+
+    PositionalFile( const PositionalFile & ) = delete;
+    PositionalFile &operator=( const PositionalFile & ) = delete;
+
+    // Reads exactly n bytes at offset into buf
+    void read( size_t offset, void *buf, size_t n ) const
+    {
+        unsigned char *p = static_cast<unsigned char*>(buf);
+        while( n > 0 ) {
+            ssize_t got = pread( fd, p, n, offset );
+            if( got < 0 && errno == EINTR ) continue;
+            if( got <= 0 )
+                throw std::runtime_error( name + ": " + (got < 0 ? strerror(errno) : "unexpected end of file") );
+            p      += got;
+            offset += got;
+            n      -= got;
+        }
+    }
+
+private:
+    std::string name;
+    int         fd = -1;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+class StlChunkReader
+{
+public:
+    StlChunkReader( const std::string &path, size_t chunk_faces )
+        : file(path), chunk(chunk_faces ? chunk_faces : 1)
+    {
+        // StlFile validates the header and size; only the count is kept
+        count = StlFile(path).nfaces();
+        buffer.resize( std::min(chunk, count)*StlFile::RECORD_SIZE );
+    }
+
+    size_t nfaces()      const { return count; }
+    size_t chunk_faces() const { return chunk; }
+
+    // Loads the next chunk; returns false once every face has been read
+    bool next()
+    {
+        first += current;
+        if( first >= count ) {
+            current = 0;
+            return false;
+        }
+        current = std::min( chunk, count - first );
+        file.read( StlFile::HEADER_SIZE + first*StlFile::RECORD_SIZE,
+                   buffer.data(), current*StlFile::RECORD_SIZE );
+        return true;
+    }
+
+    size_t first_face() const { return first; }
+
+    TriangleSoupView<float> mesh() const
+    {
+        return TriangleSoupView<float>( buffer.data() + 3*sizeof(float), current,
+                                        StlFile::RECORD_SIZE, 3*sizeof(float) );
+    }
+
+private:
+    PositionalFile             file;
+    size_t                     chunk;
+    size_t                     count   = 0;
+    size_t                     first   = 0;
+    size_t                     current = 0;
+    std::vector<unsigned char> buffer;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+template<class T>
+class PlyChunkReader
+{
+public:
+    PlyChunkReader( const std::string &path, size_t chunk_faces )
+        : ply(path, false), file(path), chunk(chunk_faces ? chunk_faces : 1)
+    {
+        if( ply.coordinate_size() != sizeof(T) )
+            throw std::runtime_error( path + ": vertex coordinate size does not match the reader" );
+        buffer.resize( std::min(chunk, ply.nfaces())*ply.face_stride() );
+    }
+
+    size_t nfaces()      const { return ply.nfaces(); }
+    size_t chunk_faces() const { return chunk; }
+
+    bool next()
+    {
+        first += current;
+        if( first >= ply.nfaces() ) {
+            current = 0;
+            return false;
+        }
+        current = std::min( chunk, ply.nfaces() - first );
+        file.read( ply.face_offset() + first*ply.face_stride(), buffer.data(),
+                   current*ply.face_stride() );
+        ply.check_faces( buffer.data(), current, first );
+        return true;
+    }
+
+    size_t first_face() const { return first; }
+
+    IndexedMeshView<T> mesh() const
+    {
+        return ply.mesh<T>( buffer.data(), current );
+    }
+
+private:
+    PlyFile                    ply;
+    PositionalFile             file;
+    size_t                     chunk;
+    size_t                     first   = 0;
+    size_t                     current = 0;
+    std::vector<unsigned char> buffer;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Reader is StlChunkReader, PlyChunkReader<T>, or anything else with
+// nfaces(), chunk_faces(), next(), first_face() and mesh(). A chunk size that
+// is not a multiple of the analyzer's block_size() is rejected before any
+// chunk is read, unless the whole mesh fits in one chunk.
+template<class Reader>
+inline MeshQualityReport analyze_stream( MeshQualityAnalyzer &analyzer, Reader &reader )
+{
+    if( reader.chunk_faces() % analyzer.block_size() && reader.nfaces() > reader.chunk_faces() )
+        throw std::invalid_argument( "analyze_stream: chunk_faces is not a multiple of block_size()" );
+
+    MeshQualityReport report( analyzer.bins() );
+    while( reader.next() )
+        analyzer.fold( reader.mesh(), reader.first_face(), report );
+    return report;
+}
+
+///////////////////////////////////////////////////////////////////////////////
@@ -2,11 +2,18 @@
 
 #include <stdlib.h>
 #include <math.h>
+#include <cmath>
 #include <assert.h>
+#include <string.h>
 #include <vector>
 #include <algorithm>
 #include <array>
 #include <limits>
+#include <type_traits>
+
+#include "fastmath.hpp"
+#include "moments.hpp"
+#include "random.hpp"
 
 typedef std::array<int,2>    Point2I;
 typedef std::array<int,3>    Point3I;
@@ -38,6 +45,113 @@ typedef std::array<double,4> Vec4D;
 
 namespace JMath
 {
+///////////////////////////////////////////////////////////////////////////////
+// Point access.
+//
+// Every function taking points accepts any type P for which point_traits<P>
+// is defined and p[i] returns coordinate i: std::array<T,N>, raw T[N],
+// Eigen-style fixed-size vectors (anything with Scalar, RowsAtCompileTime and
+// ColsAtCompileTime) and StridedPoint views into external buffers. No
+// std::array temporaries are built to read the input.
+///////////////////////////////////////////////////////////////////////////////
+
+template<class...> struct make_void { typedef void type; };
+
+template<class P, class Enable = void>
+struct point_traits {};
+
+template<class T, size_t N>
+struct point_traits< std::array<T,N> >
+{
+    typedef T value_type;
+    static const int dim = N;
+};
+
+template<class T, size_t N>
+struct point_traits< T[N] >
+{
+    typedef typename std::remove_const<T>::type value_type;
+    static const int dim = N;
+};
+
+template<class P>
+struct point_traits< P, typename make_void< typename P::Scalar,
+                                            decltype(P::RowsAtCompileTime),
+                                            decltype(P::ColsAtCompileTime) >::type >
+{
+    typedef typename P::Scalar value_type;
+    static const int dim = P::RowsAtCompileTime*P::ColsAtCompileTime;
+};
+
+// Coordinate type of a 3D point type; substitution fails for anything else.
+template<class P>
+using point3_t = typename std::enable_if< point_traits<P>::dim == 3,
+                                          typename point_traits<P>::value_type >::type;
+
+///////////////////////////////////////////////////////////////////////////////
+// Point stored in an external buffer: three coordinates, cstride bytes
+// apart, at an arbitrary (possibly unaligned) address.
+template<class T>
+class StridedPoint
+{
+public:
+    explicit StridedPoint( const void *p, size_t cstride = sizeof(T))
+        : ptr(static_cast<const unsigned char*>(p)), cstride(cstride) {}
+
+    T operator[]( size_t i ) const
+    {
+        T v;
+        memcpy( &v, ptr + i*cstride, sizeof(T) );
+        return v;
+    }
+
+private:
+    const unsigned char *ptr;
+    size_t               cstride;
+};
+
+template<class T>
+struct point_traits< StridedPoint<T> >
+{
+    typedef T value_type;
+    static const int dim = 3;
+};
+
+// Sequence of count points starting at base, stride bytes apart, e.g. the
+// positions of an interleaved position/normal/uv vertex buffer or the rows
+// (or columns, via cstride) of a numpy array.
+template<class T>
+class StridedView
+{
+public:
+    StridedView() = default;
+    StridedView( const void *base, size_t count,
+                 size_t stride = 3*sizeof(T), size_t cstride = sizeof(T))
+        : base(static_cast<const unsigned char*>(base)), count(count),
+          stride(stride), cstride(cstride) {}
+
+    size_t size() const { return count; }
+
+    StridedPoint<T> operator[]( size_t i ) const
+    {
+        return StridedPoint<T>( base + i*stride, cstride );
+    }
+
+private:
+    const unsigned char *base    = nullptr;
+    size_t               count   = 0;
+    size_t               stride  = 3*sizeof(T);
+    size_t               cstride = sizeof(T);
+};
+
+template<class P, class T = point3_t<P>>
+inline std::array<T,3> to_array( const P &p )
+{
+    return { p[0], p[1], p[2] };
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 template<class T>
 inline T max_value( const T &a, const T &b, const T &c)
 {
@@ -56,8 +170,8 @@ inline T min_value( const T &a, const T &b, const T &c, const T &d)
     return std::min(d, std::min(a,std::min(b, c)));
 }
 
-template<class T>
-inline T length( const std::array<T,3> &A, const std::array<T,3> &B)
+template<class P, class T = point3_t<P>>
+inline T length( const P &A, const P &B)
 {
     double dx = A[0] - B[0];
     double dy = A[1] - B[1];
@@ -65,8 +179,8 @@ inline T length( const std::array<T,3> &A, const std::array<T,3> &B)
     return sqrt( dx*dx + dy*dy + dz*dz );
 }
 
-template<class T>
-inline T length2( const std::array<T,3> &A, const std::array<T,3> &B)
+template<class P, class T = point3_t<P>>
+inline T length2( const P &A, const P &B)
 {
     double dx = A[0] - B[0];
     double dy = A[1] - B[1];
@@ -74,14 +188,72 @@ inline T length2( const std::array<T,3> &A, const std::array<T,3> &B)
     return dx*dx + dy*dy + dz*dz;
 }
 
-template<class T>
-inline T magnitude( const std::array<T,3> &A )
+// Precision policies for the float paths. DoublePrecision (the default of
+// the overloads without a policy) evaluates in double whatever the point
+// type; NativePrecision evaluates in the point's own floating-point type;
+// MixedPrecision evaluates natively, checks a bound on the rounding error
+// and recomputes in double when the native result can't be trusted. All
+// three agree for double points.
+struct DoublePrecision
+{
+    template<class T> using type = double;
+};
+
+struct NativePrecision
+{
+    template<class T> using type = typename std::conditional< std::is_floating_point<T>::value,
+                                                              T, double>::type;
+};
+
+struct MixedPrecision
+{
+    template<class T> using type = NativePrecision::type<T>;
+};
+
+template<class Prec, class T>
+using precision_t = typename Prec::template type<T>;
+
+// The policy overloads subtract and return in the evaluation type
+// precision_t<Prec,T>, so that callers forming cosines from them (trilib.hpp)
+// keep its precision.
+// The squares of rounded differences keep their relative accuracy, so the
+// mixed check only has to catch squared lengths that over- or underflowed
+template<class P, class Prec, class T = point3_t<P>, class R = precision_t<Prec,T>>
+inline R length2( const P &A, const P &B, Prec )
+{
+    R dx = (R)A[0] - B[0];
+    R dy = (R)A[1] - B[1];
+    R dz = (R)A[2] - B[2];
+    R d2 = dx*dx + dy*dy + dz*dz;
+    if constexpr ( std::is_same<Prec,MixedPrecision>::value && !std::is_same<R,double>::value ) {
+        if( !(d2 >= std::numeric_limits<R>::min() && d2 <= std::numeric_limits<R>::max()) )
+            return length2( A, B, DoublePrecision() );
+    }
+    return d2;
+}
+
+template<class P, class Prec, class T = point3_t<P>, class R = precision_t<Prec,T>>
+inline R length( const P &A, const P &B, Prec )
+{
+    R dx = (R)A[0] - B[0];
+    R dy = (R)A[1] - B[1];
+    R dz = (R)A[2] - B[2];
+    R d2 = dx*dx + dy*dy + dz*dz;
+    if constexpr ( std::is_same<Prec,MixedPrecision>::value && !std::is_same<R,double>::value ) {
+        if( !(d2 >= std::numeric_limits<R>::min() && d2 <= std::numeric_limits<R>::max()) )
+            return length( A, B, DoublePrecision() );
+    }
+    return std::sqrt( d2 );
+}
+
+template<class P, class T = point3_t<P>>
+inline T magnitude( const P &A )
 {
     return sqrt( A[0]*A[0] + A[1]*A[1] + A[2]*A[2] );
 }
 
-template<class T>
-inline T dot_product( const std::array<T,3> &A, const std::array<T,3> &B)
+template<class P, class T = point3_t<P>>
+inline T dot_product( const P &A, const P &B)
 {
     return A[0]*B[0] + A[1]*B[1] + A[2]*B[2];
 }
@@ -92,8 +264,8 @@ inline T dot_product( const std::array<T,2> &A, const std::array<T,2> &B)
     return A[0]*B[0] + A[1]*B[1];
 }
 
-template<class T>
-inline std::array<T,3> cross_product( const std::array<T,3> &A, const std::array<T,3> &B)
+template<class P, class T = point3_t<P>>
+inline std::array<T,3> cross_product( const P &A, const P &B)
 {
     std::array<T,3> C;
     C[0] = A[1]*B[2] - A[2]*B[1];
@@ -102,15 +274,17 @@ inline std::array<T,3> cross_product( const std::array<T,3> &A, const std::array
     return C;
 }
 
+// Uniform in [minVal, maxVal) from the calling thread's stream (random.hpp);
+// seed_random() makes the sequence reproducible
 template<class T>
 T random_value(T minVal, T maxVal)
 {
-    return minVal + drand48()*(maxVal - minVal);
+    return minVal + thread_random().uniform()*(maxVal - minVal);
 }
 
 
-template<class T>
-inline std::array<T,3> make_vector( const std::array<T,3> &head, const std::array<T,3> &tail)
+template<class P, class T = point3_t<P>>
+inline std::array<T,3> make_vector( const P &head, const P &tail)
 {
     std::array<T,3> xyz;
     xyz[0] = head[0] - tail[0];
@@ -120,8 +294,8 @@ inline std::array<T,3> make_vector( const std::array<T,3> &head, const std::arra
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-template<class T>
-inline std::array<T,3> unit_vector( const std::array<T,3> &vec)
+template<class P, class T = point3_t<P>>
+inline std::array<T,3> unit_vector( const P &vec)
 {
     double dl  = magnitude(vec);
     std::array<T,3>  uvec;
@@ -145,50 +319,80 @@ inline int unit_vector( const Point3D &head, const Point3D &tail)
     return uvec;
 }
 
+// q-quantile of v by selection, the element that would sit at index
+// min(q*n, n-1) after sorting. select_value() reorders v in place and
+// needs no memory; quantile_value() works on a copy. For streams or data
+// too large to copy, see QuantileSketch (quantile.hpp).
 template<class T>
-inline T mean_value( const std::vector<T> &v)
+inline T select_value( std::vector<T> &v, double q)
 {
     assert( !v.empty() );
+    size_t r = std::min( (size_t)(std::max(q, 0.0)*v.size()), v.size() - 1 );
+    std::nth_element( v.begin(), v.begin() + r, v.end() );
+    return v[r];
+}
+
+template<class T>
+inline T quantile_value( const std::vector<T> &v, double q)
+{
     std::vector<T> tmp(v);
-    std::sort( tmp.begin(), tmp.end() );
-    return tmp[v.size()/2];
+    return select_value( tmp, q );
 }
 
+// Median (the upper one for even sizes)
+template<class T>
+inline T mean_value( const std::vector<T> &v)
+{
+    return quantile_value( v, 0.5 );
+}
+
+// Average and sample standard deviation through moments() (moments.hpp):
+// one compensated pass, also over iterator ranges and StridedValues. For
+// both at once, or a parallel pass, call moments() directly.
 template<class T>
 inline T average_value( const std::vector<T> &v)
 {
-    size_t nsize = v.size();
+    return (T)moments( v ).mean;
+}
+
+template<class T>
+inline T average_value( const StridedValues<T> &v)
+{
+    return (T)moments( v ).mean;
+}
 
-    T sum = 0.0;
-    for( size_t i = 0; i < nsize; i++)
-        sum += v[i];
-    T avg = sum/(double)nsize;
-    return avg;
+template<class Iter>
+inline double average_value( Iter first, Iter last)
+{
+    return moments( first, last ).mean;
 }
 
 template<class T>
 inline T standard_deviation( const std::vector<T> &v)
 {
     assert( !v.empty() );
+    return (T)moments( v ).stddev();
+}
 
-    size_t nsize = v.size();
-
-    T avg = average_value( v );
+template<class T>
+inline T standard_deviation( const StridedValues<T> &v)
+{
+    assert( v.size() );
+    return (T)moments( v ).stddev();
+}
 
-    T sum = 0.0;
-    for( size_t i = 0; i < nsize; i++) {
-        double vm = v[i] - avg;
-        sum += vm*vm;
-    }
-    return sqrt(1.0/(double)(nsize-1)*sum );
+template<class Iter>
+inline double standard_deviation( Iter first, Iter last)
+{
+    return moments( first, last ).stddev();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-template<class T>
-inline T angle( T x1, T y1, T x2, T y2)
+template<class T, class Trig = TrigExact>
+inline T angle( T x1, T y1, T x2, T y2, Trig = Trig())
 {
-    double theta1 = atan2( (double)y1, (double)x1);
-    double theta2 = atan2( (double)y2, (double)x2);
+    double theta1 = Trig::atan2( (double)y1, (double)x1);
+    double theta2 = Trig::atan2( (double)y2, (double)x2);
 
     double dtheta = theta2-theta1;
 
@@ -199,8 +403,8 @@ inline T angle( T x1, T y1, T x2, T y2)
 }
 ///////////////////////////////////////////////////////////////////////////////
 
-template<class T>
-inline T angle( const std::array<T,3> &A, const std::array<T,3> &B)
+template<class P, class Trig = TrigExact, class T = point3_t<P>>
+inline T angle( const P &A, const P &B, Trig = Trig())
 {
     double AB = dot_product(A,B);
     double Am = magnitude(A);
@@ -213,7 +417,60 @@ inline T angle( const std::array<T,3> &A, const std::array<T,3> &B)
     if( x > 1.0)  x = 1.0;
     if( x < -1.0) x = -1.0;
 
-    return acos(x);
+    return Trig::acos(x);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// std::array overloads of the original API. The generic functions above
+// take the point type as their first template argument, so calls that name
+// the coordinate type, e.g. length<double>(a, b), land here and forward.
+
+template<class T>
+inline T length( const std::array<T,3> &A, const std::array<T,3> &B)
+{
+    return length< std::array<T,3> >( A, B );
+}
+
+template<class T>
+inline T length2( const std::array<T,3> &A, const std::array<T,3> &B)
+{
+    return length2< std::array<T,3> >( A, B );
+}
+
+template<class T>
+inline T magnitude( const std::array<T,3> &A )
+{
+    return magnitude< std::array<T,3> >( A );
+}
+
+template<class T>
+inline T dot_product( const std::array<T,3> &A, const std::array<T,3> &B)
+{
+    return dot_product< std::array<T,3> >( A, B );
+}
+
+template<class T>
+inline std::array<T,3> cross_product( const std::array<T,3> &A, const std::array<T,3> &B)
+{
+    return cross_product< std::array<T,3> >( A, B );
+}
+
+template<class T>
+inline std::array<T,3> make_vector( const std::array<T,3> &head, const std::array<T,3> &tail)
+{
+    return make_vector< std::array<T,3> >( head, tail );
+}
+
+template<class T>
+inline std::array<T,3> unit_vector( const std::array<T,3> &vec)
+{
+    return unit_vector< std::array<T,3> >( vec );
+}
+
+template<class T>
+inline T angle( const std::array<T,3> &A, const std::array<T,3> &B)
+{
+    return angle< std::array<T,3> >( A, B );
 }
 
 }